@@ -1,17 +1,24 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright Contributors to the OpenTimelineIO project
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 
+#include "opentime/timeArrays.h"
+#include "opentimelineio/algo/renderList.h"
 #include "opentimelineio/clip.h"
+#include "opentimelineio/marker.h"
 #include "opentimelineio/typeRegistry.h"
 #include "opentimelineio/serialization.h"
 #include "opentimelineio/deserialization.h"
 #include "opentimelineio/timeline.h"
+#include "opentimelineio/transition.h"
 
 #include "util.h"
 
 namespace otio = opentimelineio::OPENTIMELINEIO_VERSION;
+namespace otime = opentime::OPENTIME_VERSION;
 
 using chrono_time_point = std::chrono::steady_clock::time_point;
 
@@ -22,7 +29,18 @@ const struct {
     bool TO_JSON_STRING_NO_DOWNGRADE = true;
     bool TO_JSON_FILE                = true;
     bool TO_JSON_FILE_NO_DOWNGRADE   = true;
+    bool TO_JSON_FILE_MODES          = true;
+    bool BINARY_FILE                 = true;
     bool CLONE_TEST                  = true;
+    bool CLONE_TIMELINE              = true;
+    bool CONTENT_HASH                = true;
+    bool JSON_DOUBLES                = true;
+    bool TIME_ARRAYS                 = true;
+    bool MARKER_INDEX                = true;
+    bool ITEM_INDEX                  = true;
+    bool MEDIA_TIME_TRANSFORM        = true;
+    bool RENDER_LIST                 = true;
+    bool CUT_LIST                    = true;
     bool SINGLE_CLIP_DOWNGRADE_TEST  = true;
 } RUN_STRUCT ;
 
@@ -46,6 +64,53 @@ print_elapsed_time(
     return dur.count();
 }
 
+/// utility function for printing the throughput of writing a file
+void
+print_file_throughput(const std::string& file_path, const double seconds)
+{
+    std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+    const double  megabytes = double(file.tellg()) / (1024.0 * 1024.0);
+
+    std::cout << "  " << megabytes << " MB, " << megabytes / seconds;
+    std::cout << " [MB/s]" << std::endl;
+}
+
+/// utility function for comparing a loop over time objects with the same
+/// operation on a time array
+template <typename ObjectsFunction, typename ArrayFunction>
+void
+print_array_speedup(
+        const std::string& name,
+        ObjectsFunction&& objects,
+        ArrayFunction&& array
+)
+{
+    chrono_time_point begin = std::chrono::steady_clock::now();
+    const size_t objects_count = objects();
+    chrono_time_point end = std::chrono::steady_clock::now();
+    const double objects_time = print_elapsed_time(
+            name + " [objects]",
+            begin,
+            end
+    );
+
+    begin = std::chrono::steady_clock::now();
+    const size_t array_count = array();
+    end = std::chrono::steady_clock::now();
+    const double array_time = print_elapsed_time(
+            name + " [array]",
+            begin,
+            end
+    );
+    if (objects_count != array_count)
+    {
+        std::cerr << name << ": objects and array results differ";
+        std::cerr << std::endl;
+    }
+    std::cout << "  objects/array: " << objects_time / array_time;
+    std::cout << std::endl;
+}
+
 void
 print_version_map()
 {
@@ -153,7 +218,11 @@ main(
         return 1;
     }
 
-    print_elapsed_time("deserialize_json_from_file", begin, end);
+    const double read_json = print_elapsed_time(
+            "deserialize_json_from_file",
+            begin,
+            end
+    );
 
 
     double str_dg, str_nodg;
@@ -240,6 +309,623 @@ main(
         std::cout << std::endl;
     }
 
+    if (RUN_STRUCT.TO_JSON_FILE_MODES)
+    {
+        const struct
+        {
+            const char* label;
+            int         indent;
+            bool        sync;
+        } modes[] = {
+            { "pretty", 4, false },
+            { "compact", -1, false },
+            { "compact, fsync", -1, true },
+        };
+        for (const auto& mode : modes)
+        {
+            const std::string path = examples::normalize_path(
+                    tmp_dir_path + "/io_perf_test.modes.otio"
+            );
+
+            begin = std::chrono::steady_clock::now();
+            otio::serialize_json_to_file(
+                    otio::SerializableObject::Retainer<>(timeline),
+                    path,
+                    {},
+                    &err,
+                    mode.indent,
+                    1,
+                    mode.sync
+            );
+            end = std::chrono::steady_clock::now();
+            assert(!otio::is_error(err));
+            const double seconds = print_elapsed_time(
+                    std::string("serialize_json_to_file [") + mode.label + "]",
+                    begin,
+                    end
+            );
+            print_file_throughput(path, seconds);
+        }
+    }
+
+    if (RUN_STRUCT.CLONE_TIMELINE)
+    {
+        begin = std::chrono::steady_clock::now();
+        otio::SerializableObject::Retainer<> native_clone(
+                timeline.value->clone(&err)
+        );
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double clone_native = print_elapsed_time(
+                "clone",
+                begin,
+                end
+        );
+
+        begin = std::chrono::steady_clock::now();
+        otio::SerializableObject::Retainer<> serialized_clone(
+                timeline.value->clone_via_serialization(&err)
+        );
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double clone_serialized = print_elapsed_time(
+                "clone_via_serialization",
+                begin,
+                end
+        );
+        std::cout << "  clone serialized/native: ";
+        std::cout << clone_serialized / clone_native << std::endl;
+    }
+
+    if (RUN_STRUCT.CONTENT_HASH)
+    {
+        begin = std::chrono::steady_clock::now();
+        const auto hash = timeline.value->content_hash(&err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double hash_first = print_elapsed_time(
+                "content_hash",
+                begin,
+                end
+        );
+
+        begin = std::chrono::steady_clock::now();
+        const auto cached_hash = timeline.value->content_hash(&err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err) && cached_hash == hash);
+        print_elapsed_time("content_hash (cached)", begin, end);
+
+        begin = std::chrono::steady_clock::now();
+        const auto json_string = timeline.value->to_json_string(&err, {}, 0);
+        const auto json_hash   = std::hash<std::string>()(json_string);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double hash_json = print_elapsed_time(
+                "to_json_string + std::hash",
+                begin,
+                end
+        );
+        (void) json_hash;
+        std::cout << "  json hash/content_hash: ";
+        std::cout << hash_json / hash_first << std::endl;
+    }
+
+    if (RUN_STRUCT.JSON_DOUBLES)
+    {
+        // frame numbers and rates are mostly integral, times in seconds
+        // are not
+        const int         count = 1000000;
+        otio::AnyVector   values;
+        values.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            values.push_back(
+                    i % 2 ? double(i) : double(i) * 1001.0 / 24000.0
+            );
+        }
+
+        begin = std::chrono::steady_clock::now();
+        const std::string json = otio::serialize_json_to_string(
+                values,
+                {},
+                &err,
+                -1
+        );
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double write_doubles = print_elapsed_time(
+                "serialize_json_to_string [1M doubles]",
+                begin,
+                end
+        );
+        std::cout << "  " << write_doubles * 1e9 / count << " [ns/value]";
+        std::cout << std::endl;
+
+        std::any read_values;
+        begin = std::chrono::steady_clock::now();
+        otio::deserialize_json_from_string(json, &read_values, &err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double read_doubles = print_elapsed_time(
+                "deserialize_json_from_string [1M doubles]",
+                begin,
+                end
+        );
+        std::cout << "  " << read_doubles * 1e9 / count << " [ns/value]";
+        std::cout << std::endl;
+    }
+
+    if (RUN_STRUCT.TIME_ARRAYS)
+    {
+        // ranges at mixed rates, in the shape of the clips of a conformed
+        // timeline
+        const size_t count   = 1000000;
+        const double rates[] = { 24, 25, 30000.0 / 1001.0, 48000 };
+        std::vector<otime::RationalTime> times;
+        std::vector<otime::TimeRange>    ranges;
+        times.reserve(count);
+        ranges.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            times.emplace_back(i * 12.0, rates[i % 4]);
+            ranges.emplace_back(
+                    times.back(),
+                    otime::RationalTime(i % 100 + 1.0, rates[i / 4 % 4])
+            );
+        }
+        const otime::RationalTimeArray time_array(times);
+        const otime::TimeRangeArray    range_array(ranges);
+        const otime::TimeTransform     transform(
+                otime::RationalTime(86400, 24),
+                1,
+                30000.0 / 1001.0
+        );
+        const otime::TimeRange other(
+                otime::RationalTime(count * 3.0, 24),
+                otime::RationalTime(count * 6.0, 24)
+        );
+
+        // each function returns the number of results, so that the work
+        // is not optimized away
+        print_array_speedup(
+                "rescaled_to [1M times]",
+                [&] {
+                    std::vector<otime::RationalTime> result;
+                    result.reserve(count);
+                    for (const auto& time: times)
+                    {
+                        result.push_back(time.rescaled_to(24));
+                    }
+                    return result.size();
+                },
+                [&] { return time_array.rescaled_to(24).size(); }
+        );
+        print_array_speedup(
+                "TimeTransform::applied_to [1M ranges]",
+                [&] {
+                    std::vector<otime::TimeRange> result;
+                    result.reserve(count);
+                    for (const auto& range: ranges)
+                    {
+                        result.push_back(transform.applied_to(range));
+                    }
+                    return result.size();
+                },
+                [&] { return range_array.transformed_by(transform).size(); }
+        );
+        print_array_speedup(
+                "contains [1M ranges]",
+                [&] {
+                    size_t result = 0;
+                    for (const auto& range: ranges)
+                    {
+                        result += range.contains(other.start_time());
+                    }
+                    return result;
+                },
+                [&] {
+                    size_t result = 0;
+                    for (const auto contained:
+                         range_array.contains(other.start_time()))
+                    {
+                        result += contained;
+                    }
+                    return result;
+                }
+        );
+        print_array_speedup(
+                "intersects [1M ranges]",
+                [&] {
+                    size_t result = 0;
+                    for (const auto& range: ranges)
+                    {
+                        result += range.intersects(other);
+                    }
+                    return result;
+                },
+                [&] {
+                    size_t result = 0;
+                    for (const auto intersected: range_array.intersects(other))
+                    {
+                        result += intersected;
+                    }
+                    return result;
+                }
+        );
+        print_array_speedup(
+                "clamped [1M ranges]",
+                [&] {
+                    std::vector<otime::TimeRange> result;
+                    result.reserve(count);
+                    for (const auto& range: ranges)
+                    {
+                        result.push_back(other.clamped(range));
+                    }
+                    return result.size();
+                },
+                [&] { return range_array.clamped_to(other).size(); }
+        );
+        print_array_speedup(
+                "extended_by [1M ranges]",
+                [&] {
+                    std::vector<otime::TimeRange> result;
+                    result.reserve(count);
+                    for (const auto& range: ranges)
+                    {
+                        result.push_back(range.extended_by(other));
+                    }
+                    return result.size();
+                },
+                [&] { return range_array.extended_by(other).size(); }
+        );
+    }
+
+    if (RUN_STRUCT.MARKER_INDEX)
+    {
+        // a marker on every clip, on a clone so the other tests still see
+        // the timeline as it was read
+        otio::SerializableObject::Retainer<otio::Timeline> marked(
+                dynamic_cast<otio::Timeline*>(timeline.value->clone(&err))
+        );
+        assert(marked && !otio::is_error(err));
+        const auto clips = marked.value->find_clips(&err);
+        assert(!otio::is_error(err));
+        for (const auto& clip: clips)
+        {
+            const auto range = clip.value->trimmed_range(&err);
+            const otio::RationalTime half(
+                    range.duration().value() / 2,
+                    range.duration().rate()
+            );
+            clip.value->markers().push_back(new otio::Marker(
+                    "marker",
+                    otio::TimeRange(range.start_time(), half)
+            ));
+        }
+        const auto duration = marked.value->duration(&err);
+        assert(!otio::is_error(err));
+
+        // a search window the size of one second, at each of 1000 times
+        const int searches = 1000;
+        auto search_range = [&](int i) {
+            return otio::TimeRange(
+                    otio::RationalTime(
+                            duration.value() * i / searches,
+                            duration.rate()
+                    ),
+                    otio::RationalTime(1, 1).rescaled_to(duration.rate())
+            );
+        };
+
+        // transformed_time_range() finds each clip's place in its track
+        // from the start, so only the first clips are scanned
+        const size_t scan_count = std::min(clips.size(), size_t(100));
+        size_t       scanned    = 0;
+        begin = std::chrono::steady_clock::now();
+        const auto search = search_range(0);
+        for (size_t i = 0; i < scan_count; ++i)
+        {
+            const auto& clip = clips[i];
+            for (const auto& marker: clip.value->markers())
+            {
+                const auto range = clip.value->transformed_time_range(
+                        marker.value->marked_range(),
+                        marked.value->tracks(),
+                        &err
+                );
+                scanned += range.intersects(search);
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        std::cout << "scan markers with transformed_time_range [";
+        std::cout << scan_count << " clips]: ";
+        std::cout << std::chrono::duration<float>(end - begin).count();
+        std::cout << " [s]" << std::endl;
+
+        begin = std::chrono::steady_clock::now();
+        const size_t found =
+                marked.value->find_markers(&err, search).size();
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        print_elapsed_time("find_markers (build index) [1 search]", begin, end);
+        if (scan_count == clips.size() && found != scanned)
+        {
+            std::cerr << "find_markers found " << found << " markers, ";
+            std::cerr << "the scan found " << scanned << std::endl;
+        }
+
+        size_t total = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < searches; ++i)
+        {
+            total += marked.value->find_markers(&err, search_range(i)).size();
+        }
+        end = std::chrono::steady_clock::now();
+        const double search_seconds = print_elapsed_time(
+                "find_markers [1000 searches]",
+                begin,
+                end
+        );
+        std::cout << "  " << search_seconds * 1e6 / searches;
+        std::cout << " [us/search], " << total << " markers" << std::endl;
+    }
+
+    if (RUN_STRUCT.ITEM_INDEX)
+    {
+        // what is under the playhead, for one second of playback at 60Hz
+        const auto duration = timeline.value->duration(&err);
+        assert(!otio::is_error(err));
+        const int frames = 60;
+        auto playhead = [&](int i) {
+            return otio::RationalTime(
+                    duration.value() * (i + 0.5) / frames,
+                    duration.rate()
+            );
+        };
+        const otio::RationalTime one_frame =
+                otio::RationalTime(1, 60).rescaled_to(duration.rate());
+
+        size_t clips = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+        {
+            clips += timeline.value->find_clips(
+                    &err,
+                    otio::TimeRange(playhead(i), one_frame)
+            ).size();
+        }
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double find_clips_seconds = print_elapsed_time(
+                "find_clips [60 playhead times]",
+                begin,
+                end
+        );
+
+        begin = std::chrono::steady_clock::now();
+        timeline.value->items_at_time(playhead(0), &err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        print_elapsed_time("items_at_time (build index)", begin, end);
+
+        size_t items = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+        {
+            items += timeline.value->items_at_time(playhead(i), &err).size();
+        }
+        end = std::chrono::steady_clock::now();
+        const double items_seconds = print_elapsed_time(
+                "items_at_time [60 playhead times]",
+                begin,
+                end
+        );
+        std::cout << "  " << clips << " clips, " << items << " items, ";
+        std::cout << "find_clips/items_at_time: ";
+        std::cout << find_clips_seconds / items_seconds << std::endl;
+    }
+
+    if (RUN_STRUCT.MEDIA_TIME_TRANSFORM)
+    {
+        // the media time of 100 clips at every frame of one second
+        auto clips = timeline.value->find_clips(&err);
+        assert(!otio::is_error(err));
+        clips.resize(std::min(clips.size(), size_t(100)));
+        const otio::Stack* tracks = timeline.value->tracks();
+        const int          frames = 24;
+
+        double sum = 0;
+        begin = std::chrono::steady_clock::now();
+        for (const auto& clip: clips)
+        {
+            for (int i = 0; i < frames; ++i)
+            {
+                sum += tracks->transformed_time(
+                        otio::RationalTime(i, 24),
+                        clip,
+                        &err
+                ).value();
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double transformed_seconds = print_elapsed_time(
+                "transformed_time [100 clips x 24 frames]",
+                begin,
+                end
+        );
+
+        double transform_sum = 0;
+        begin = std::chrono::steady_clock::now();
+        for (const auto& clip: clips)
+        {
+            const auto transform =
+                    timeline.value->media_time_transform(clip, &err);
+            for (int i = 0; i < frames; ++i)
+            {
+                transform_sum +=
+                        transform.applied_to(otio::RationalTime(i, 24)).value();
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double transform_seconds = print_elapsed_time(
+                "media_time_transform [100 clips x 24 frames]",
+                begin,
+                end
+        );
+        std::cout << "  sums " << sum << " and " << transform_sum << ", ";
+        std::cout << "transformed_time/media_time_transform: ";
+        std::cout << transformed_seconds / transform_seconds << std::endl;
+    }
+
+    if (RUN_STRUCT.RENDER_LIST)
+    {
+        // once to index the timeline, then again to time the sweep
+        otio::algo::render_list(timeline.value, 24, std::nullopt, &err);
+        assert(!otio::is_error(err));
+
+        begin = std::chrono::steady_clock::now();
+        const auto segments =
+                otio::algo::render_list(timeline.value, 24, std::nullopt, &err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double seconds =
+                print_elapsed_time("render_list [24 fps]", begin, end);
+        const int64_t frames =
+                segments.empty() ? 0 : segments.back().end_frame;
+        std::cout << "  " << frames << " frames, " << segments.size();
+        std::cout << " segments, " << frames / (seconds * 1e6);
+        std::cout << " frames/us" << std::endl;
+    }
+
+    if (RUN_STRUCT.CUT_LIST)
+    {
+        // a track of 100k clips, with a dissolve after every tenth
+        otio::SerializableObject::Retainer<otio::Track> track =
+                new otio::Track();
+        const int events = 100000;
+        for (int i = 0; i < events; ++i)
+        {
+            track->append_child(new otio::Clip(
+                    "clip",
+                    nullptr,
+                    otio::TimeRange(
+                            otio::RationalTime(i % 100, 24),
+                            otio::RationalTime(24 + i % 7, 24)
+                    )
+            ));
+            if (i % 10 == 9)
+            {
+                track->append_child(new otio::Transition(
+                        "dissolve",
+                        otio::Transition::Type::SMPTE_Dissolve,
+                        otio::RationalTime(3, 24),
+                        otio::RationalTime(3, 24)
+                ));
+            }
+        }
+
+        // 1000 clips across the track only, as each call walks the track
+        // up to the clip again
+        const int sampled = 1000;
+        double    sum     = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < sampled; ++i)
+        {
+            const int clip = i * (events / sampled);
+            auto      item = dynamic_cast<otio::Item*>(
+                    track->children()[clip + clip / 10].value);
+            sum += item->trimmed_range_in_parent(&err)->start_time().value();
+            sum += item->visible_range(&err).start_time().value();
+        }
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double per_item_seconds = print_elapsed_time(
+                "trimmed_range_in_parent [1000 of 100k clips]",
+                begin,
+                end
+        );
+
+        begin = std::chrono::steady_clock::now();
+        const auto cuts = track->cut_list(&err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double cut_list_seconds = print_elapsed_time(
+                "cut_list [100k clips]",
+                begin,
+                end
+        );
+        std::cout << "  " << cuts.size() << " events, " << sum << ", ";
+        std::cout << "per item (all, estimated)/cut_list: ";
+        std::cout << per_item_seconds * (events / sampled) / cut_list_seconds;
+        std::cout << std::endl;
+    }
+
+    if (RUN_STRUCT.BINARY_FILE)
+    {
+        const std::string binary_path = examples::normalize_path(
+                tmp_dir_path + "/io_perf_test.otiob"
+        );
+
+        begin = std::chrono::steady_clock::now();
+        otio::serialize_binary_to_file(
+                otio::SerializableObject::Retainer<>(timeline),
+                binary_path,
+                {},
+                &err
+        );
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double write_binary = print_elapsed_time(
+                "serialize_binary_to_file [no downgrade]",
+                begin,
+                end
+        );
+        if (RUN_STRUCT.TO_JSON_FILE_NO_DOWNGRADE)
+        {
+            std::cout << "  file no_dg json/binary: ";
+            std::cout << file_nodg / write_binary << std::endl;
+        }
+
+        std::any binary_result;
+        begin = std::chrono::steady_clock::now();
+        otio::deserialize_binary_from_file(binary_path, &binary_result, &err);
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        const double read_binary = print_elapsed_time(
+                "deserialize_binary_from_file",
+                begin,
+                end
+        );
+        std::cout << "  read json/binary: " << read_json / read_binary;
+        std::cout << std::endl;
+
+        std::any track;
+        begin = std::chrono::steady_clock::now();
+        otio::deserialize_binary_subtree_from_file(
+                binary_path,
+                "tracks/0",
+                &track,
+                &err
+        );
+        end = std::chrono::steady_clock::now();
+        assert(!otio::is_error(err));
+        print_elapsed_time(
+                "deserialize_binary_subtree_from_file [tracks/0]",
+                begin,
+                end
+        );
+
+        std::ifstream json_file(
+                examples::normalize_path(argv[1]),
+                std::ios::binary | std::ios::ate
+        );
+        std::ifstream binary_file(binary_path, std::ios::binary | std::ios::ate);
+        std::cout << "  size json/binary: " << json_file.tellg();
+        std::cout << " / " << binary_file.tellg() << " bytes" << std::endl;
+    }
+
     if (keep_tmp || RUN_STRUCT.FIXED_TMP)
     {
         std::cout << "Temp directory preserved.  All files written to: ";
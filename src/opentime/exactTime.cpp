@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "opentime/exactTime.h"
+#include <cmath>
+
+namespace opentime { namespace OPENTIME_VERSION {
+
+int64_t
+ExactTime::ticks_per_sample(double rate) noexcept
+{
+    if (!(rate > 0) || rate > double(ticks_per_second))
+    {
+        return 0;
+    }
+
+    // integer rates, and the NTSC rates (e.g. 30000/1001)
+    for (const int64_t denominator: { 1, 1001 })
+    {
+        const double numerator = std::round(rate * double(denominator));
+        if (numerator / double(denominator) != rate)
+        {
+            continue;
+        }
+
+        const int64_t ticks   = ticks_per_second * denominator;
+        const int64_t samples = static_cast<int64_t>(numerator);
+        return ticks % samples == 0 ? ticks / samples : 0;
+    }
+    return 0;
+}
+
+std::optional<ExactTime>
+ExactTime::from_samples(double samples, int64_t ticks_per_sample) noexcept
+{
+    if (ticks_per_sample == 0)
+    {
+        return std::nullopt;
+    }
+
+    // The ticks must be an integer that a double holds exactly, and must
+    // convert back to the same number of samples (which a whole number of
+    // samples always does).
+    const double ticks = samples * double(ticks_per_sample);
+    if (!(std::abs(ticks) <= 9007199254740992.0) || std::floor(ticks) != ticks)
+    {
+        return std::nullopt;
+    }
+
+    const ExactTime time(static_cast<int64_t>(ticks));
+    if (std::floor(samples) != samples
+        && time.samples(ticks_per_sample) != samples)
+    {
+        return std::nullopt;
+    }
+    return time;
+}
+
+RationalTime
+ExactTime::to_rational_time(double rate) const noexcept
+{
+    if (const int64_t ticks = ticks_per_sample(rate))
+    {
+        return RationalTime{ samples(ticks), rate };
+    }
+    return RationalTime{ double(_ticks) * rate / double(ticks_per_second),
+                         rate };
+}
+
+}} // namespace opentime::OPENTIME_VERSION
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentime/rationalTime.h"
+#include "opentime/version.h"
+#include <cstdint>
+#include <optional>
+
+namespace opentime { namespace OPENTIME_VERSION {
+
+/// @brief This class represents a time exactly, as an integer number of
+/// ticks of 1/705600000 of a second.
+///
+/// A sample at any of the common video frame rates (including the NTSC
+/// rates such as 30000/1001) and audio sample rates is a whole number of
+/// ticks, so times at those rates can be added, subtracted and compared
+/// with integer arithmetic, without any rounding, whatever their rates.
+///
+/// Times are converted from and to RationalTime losslessly: converting a
+/// time to an ExactTime and back to its rate gives the same value.
+class ExactTime
+{
+public:
+    /// @brief The number of ticks in a second.
+    static constexpr int64_t ticks_per_second = 705600000;
+
+    /// @brief Construct a new time with the given number of ticks.
+    explicit constexpr ExactTime(int64_t ticks = 0) noexcept
+        : _ticks{ ticks }
+    {}
+
+    /// @brief Returns the number of ticks.
+    constexpr int64_t ticks() const noexcept { return _ticks; }
+
+    /// @brief Returns the time in seconds.
+    constexpr double to_seconds() const noexcept
+    {
+        return double(_ticks) / double(ticks_per_second);
+    }
+
+    /// @brief Returns the number of ticks in a sample at the given rate, or
+    /// zero if it is not a whole number.
+    ///
+    /// The rate must be an integer, or an integer * 1000/1001.
+    static int64_t ticks_per_sample(double rate) noexcept;
+
+    /// @brief Returns the time of the given number of samples, or nothing
+    /// if it cannot be represented exactly.
+    ///
+    /// @param samples The number of samples.
+    /// @param ticks_per_sample The ticks in a sample, see ticks_per_sample().
+    static std::optional<ExactTime>
+    from_samples(double samples, int64_t ticks_per_sample) noexcept;
+
+    /// @brief Returns the given time, or nothing if it cannot be
+    /// represented exactly.
+    static std::optional<ExactTime>
+    from_rational_time(RationalTime time) noexcept
+    {
+        return from_samples(time.value(), ticks_per_sample(time.rate()));
+    }
+
+    /// @brief Returns the number of samples in this time.
+    ///
+    /// @param ticks_per_sample The ticks in a sample, see ticks_per_sample().
+    constexpr double samples(int64_t ticks_per_sample) const noexcept
+    {
+        return _ticks % ticks_per_sample == 0
+                   ? double(_ticks / ticks_per_sample)
+                   : double(_ticks) / double(ticks_per_sample);
+    }
+
+    /// @brief Returns this time at the given rate.
+    ///
+    /// The value is only rounded if a sample at the given rate is not a
+    /// whole number of ticks.
+    RationalTime to_rational_time(double rate) const noexcept;
+
+    /// @brief Add a time to this time.
+    constexpr ExactTime& operator+=(ExactTime other) noexcept
+    {
+        _ticks += other._ticks;
+        return *this;
+    }
+
+    /// @brief Subtract a time from this time.
+    constexpr ExactTime& operator-=(ExactTime other) noexcept
+    {
+        _ticks -= other._ticks;
+        return *this;
+    }
+
+    /// @brief Return the addition of two times.
+    friend constexpr ExactTime operator+(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return ExactTime{ lhs._ticks + rhs._ticks };
+    }
+
+    /// @brief Return the subtraction of two times.
+    friend constexpr ExactTime operator-(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return ExactTime{ lhs._ticks - rhs._ticks };
+    }
+
+    /// @brief Return the negative of this time.
+    friend constexpr ExactTime operator-(ExactTime lhs) noexcept
+    {
+        return ExactTime{ -lhs._ticks };
+    }
+
+    /// @brief Return whether two times are equal.
+    friend constexpr bool operator==(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks == rhs._ticks;
+    }
+
+    /// @brief Return whether two times are not equal.
+    friend constexpr bool operator!=(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks != rhs._ticks;
+    }
+
+    /// @brief Return whether a time is less than another time.
+    friend constexpr bool operator<(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks < rhs._ticks;
+    }
+
+    /// @brief Return whether a time is less than or equal to another time.
+    friend constexpr bool operator<=(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks <= rhs._ticks;
+    }
+
+    /// @brief Return whether a time is greater than another time.
+    friend constexpr bool operator>(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks > rhs._ticks;
+    }
+
+    /// @brief Return whether a time is greater or equal to another time.
+    friend constexpr bool operator>=(ExactTime lhs, ExactTime rhs) noexcept
+    {
+        return lhs._ticks >= rhs._ticks;
+    }
+
+private:
+    int64_t _ticks;
+};
+
+}} // namespace opentime::OPENTIME_VERSION
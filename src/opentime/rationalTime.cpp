@@ -5,36 +5,146 @@
 #include "opentime/stringPrintf.h"
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <ciso646>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 
 namespace opentime { namespace OPENTIME_VERSION {
 
 RationalTime RationalTime::_invalid_time{ 0, RationalTime::_invalid_rate };
 
-static constexpr std::array<double, 2> dropframe_timecode_rates{ {
-    30000.0 / 1001.0,
-    60000.0 / 1001.0,
-} };
+// The constants of timecode conversions at a given rate.
+struct TimecodeConstants
+{
+    int nominal_fps;
+    int dropframes;
+    int frames_per_minute;
+    int frames_per_10_minutes;
+    int frames_per_24_hours;
+};
+
+// std::round() and std::ceil() are not constexpr; these are only used for
+// positive values.
+static constexpr int
+round_positive(double value)
+{
+    return static_cast<int>(value + 0.5);
+}
+
+static constexpr int
+ceil_positive(double value)
+{
+    const int truncated = static_cast<int>(value);
+    return truncated < value ? truncated + 1 : truncated;
+}
+
+static constexpr TimecodeConstants
+timecode_constants(double rate, int dropframes)
+{
+    return TimecodeConstants{
+        ceil_positive(rate),
+        dropframes,
+        // the round of the framerate * 60 minus the number of dropped
+        // frames
+        round_positive(rate) * 60 - dropframes,
+        round_positive(rate * 60 * 10),
+        // timecode rolls over after 24 hours
+        round_positive(rate * 60 * 60) * 24
+    };
+}
+
+// A SMPTE timecode rate, with the constants of non drop frame timecode at
+// the rate, and of drop frame timecode if the rate supports it.
+struct SmpteRate
+{
+    double            rate;
+    bool              is_dropframe_rate;
+    TimecodeConstants non_drop_frame;
+    TimecodeConstants drop_frame;
+};
+
+static constexpr SmpteRate
+smpte_rate(double rate, int dropframes)
+{
+    // non drop frame timecode at 23.976 counts the frames as 24
+    return SmpteRate{
+        rate,
+        dropframes > 0,
+        timecode_constants(round_positive(rate) == 24 ? 24.0 : rate, 0),
+        timecode_constants(rate, dropframes)
+    };
+}
 
 // See the official source of these numbers here:
 // ST 12-1:2014 - SMPTE Standard - Time and Control Code
 // https://ieeexplore.ieee.org/document/7291029
 //
-static constexpr std::array<double, 11> smpte_timecode_rates{
-    { 24000.0 / 1001.0,
-      24.0,
-      25.0,
-      30000.0 / 1001.0,
-      30.0,
-      48000.0 / 1001.0,
-      48.0,
-      50.0,
-      60000.0 / 1001.0,
-      60.0
+// The rates are in increasing order.
+static constexpr std::array<SmpteRate, 10> smpte_timecode_rates{ {
+    smpte_rate(24000.0 / 1001.0, 0),
+    smpte_rate(24.0, 0),
+    smpte_rate(25.0, 0),
+    smpte_rate(30000.0 / 1001.0, 2),
+    smpte_rate(30.0, 0),
+    smpte_rate(48000.0 / 1001.0, 0),
+    smpte_rate(48.0, 0),
+    smpte_rate(50.0, 0),
+    smpte_rate(60000.0 / 1001.0, 4),
+    smpte_rate(60.0, 0),
+} };
+
+// For each whole number of frames per second below the highest rate, the
+// index of the first rate above it.  There is at most one rate between two
+// whole numbers, so the rates either side of any rate are found without a
+// search.
+static constexpr std::array<size_t, 60> smpte_timecode_rates_above = [] {
+    std::array<size_t, 60> result{};
+    for (size_t fps = 0; fps < result.size(); ++fps)
+    {
+        size_t index = 0;
+        while (smpte_timecode_rates[index].rate <= fps)
+        {
+            ++index;
+        }
+        result[fps] = index;
     }
-};
+    return result;
+}();
+
+// Returns the SMPTE timecode rate nearest to the given rate, or the lower
+// of two rates that are equally near.
+static SmpteRate const&
+nearest_smpte_rate(double rate) noexcept
+{
+    if (!(rate > smpte_timecode_rates.front().rate))
+    {
+        return smpte_timecode_rates.front();
+    }
+    if (!(rate < smpte_timecode_rates.back().rate))
+    {
+        return smpte_timecode_rates.back();
+    }
+
+    size_t above = smpte_timecode_rates_above[static_cast<size_t>(rate)];
+    if (smpte_timecode_rates[above].rate <= rate)
+    {
+        ++above;
+    }
+    SmpteRate const& lower  = smpte_timecode_rates[above - 1];
+    SmpteRate const& higher = smpte_timecode_rates[above];
+    return rate - lower.rate <= higher.rate - rate ? lower : higher;
+}
+
+// Returns the given SMPTE timecode rate, or null if the rate is not one.
+static SmpteRate const*
+find_smpte_rate(double rate) noexcept
+{
+    SmpteRate const& nearest = nearest_smpte_rate(rate);
+    return nearest.rate == rate ? &nearest : nullptr;
+}
 
 // deprecated in favor of `is_smpte_timecode_rate`
 bool
@@ -46,8 +156,7 @@ RationalTime::is_valid_timecode_rate(double fps)
 bool
 RationalTime::is_smpte_timecode_rate(double fps)
 {
-    auto b = smpte_timecode_rates.begin(), e = smpte_timecode_rates.end();
-    return std::find(b, e, fps) != e;
+    return find_smpte_rate(fps) != nullptr;
 }
 
 // deprecated in favor of `is_smpte_timecode_rate`
@@ -60,31 +169,143 @@ RationalTime::nearest_valid_timecode_rate(double rate)
 double
 RationalTime::nearest_smpte_timecode_rate(double rate)
 {
-    double nearest_rate = 0;
-    double min_diff     = std::numeric_limits<double>::max();
-    for (auto smpte_rate: smpte_timecode_rates)
+    return nearest_smpte_rate(rate).rate;
+}
+
+TimecodeFormatter::TimecodeFormatter(
+    double          rate,
+    IsDropFrameRate drop_frame,
+    ErrorStatus*    error_status)
+    : _rate{ rate }
+{
+    // It is common practice to use truncated or rounded values
+    // like 29.97 instead of exact SMPTE rates like 30000/1001
+    // so as a convenience we will snap the rate to the nearest
+    // SMPTE rate if it is close enough (less than one frame per
+    // second away).
+    SmpteRate const& smpte_rate = nearest_smpte_rate(rate);
+    if (!(std::abs(smpte_rate.rate - rate) < 1))
     {
-        if (smpte_rate == rate)
+        if (error_status)
         {
-            return rate;
+            *error_status = ErrorStatus(ErrorStatus::INVALID_TIMECODE_RATE);
         }
-        auto diff = std::abs(rate - smpte_rate);
-        if (diff >= min_diff)
+        return;
+    }
+
+    if (drop_frame == IsDropFrameRate::ForceYes
+        && !smpte_rate.is_dropframe_rate)
+    {
+        if (error_status)
         {
-            continue;
+            *error_status =
+                ErrorStatus(ErrorStatus::INVALID_RATE_FOR_DROP_FRAME_TIMECODE);
         }
-        min_diff     = diff;
-        nearest_rate = smpte_rate;
+        return;
     }
-    return nearest_rate;
+
+    const bool is_drop_frame = drop_frame == IsDropFrameRate::InferFromRate
+                                   ? smpte_rate.is_dropframe_rate
+                                   : drop_frame == IsDropFrameRate::ForceYes;
+    TimecodeConstants const& constants =
+        is_drop_frame ? smpte_rate.drop_frame : smpte_rate.non_drop_frame;
+    _nominal_fps           = constants.nominal_fps;
+    _dropframes            = constants.dropframes;
+    _frames_per_minute     = constants.frames_per_minute;
+    _frames_per_10_minutes = constants.frames_per_10_minutes;
+    _frames_per_24_hours   = constants.frames_per_24_hours;
 }
 
-static bool
-is_dropframe_rate(double rate)
+static constexpr char two_digits[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+bool
+TimecodeFormatter::to_timecode(
+    double       frame,
+    char*        timecode,
+    ErrorStatus* error_status) const
+{
+    if (!is_valid())
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(ErrorStatus::INVALID_TIMECODE_RATE);
+        }
+        return false;
+    }
+
+    // an infinite frame, e.g. of a time with a rate of zero, has no hours
+    // to format
+    if (!std::isfinite(frame))
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::INVALID_TIMECODE_RATE,
+                string_printf("frame %g is not finite", frame));
+        }
+        return false;
+    }
+    if (frame < 0)
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(ErrorStatus::NEGATIVE_VALUE);
+        }
+        return false;
+    }
+
+    // If the number of frames is more than 24 hours, roll over clock.
+    // Everything else is integer arithmetic, and the digits are copied in
+    // pairs from a table.
+    int64_t value =
+        static_cast<int64_t>(std::fmod(frame, _frames_per_24_hours));
+
+    if (_dropframes)
+    {
+        const int64_t dropframes              = _dropframes;
+        const int64_t ten_minute_chunks       = value / _frames_per_10_minutes;
+        const int64_t frames_over_ten_minutes = value % _frames_per_10_minutes;
+
+        value += dropframes * 9 * ten_minute_chunks;
+        if (frames_over_ten_minutes > dropframes)
+        {
+            value += dropframes
+                     * ((frames_over_ten_minutes - dropframes)
+                        / _frames_per_minute);
+        }
+    }
+
+    const int64_t frames        = value % _nominal_fps;
+    const int64_t seconds_total = value / _nominal_fps;
+    const int64_t seconds       = seconds_total % 60;
+    const int64_t minutes       = (seconds_total / 60) % 60;
+    const int64_t hours         = seconds_total / 3600;
+
+    std::memcpy(timecode, two_digits + 2 * hours, 2);
+    timecode[2] = ':';
+    std::memcpy(timecode + 3, two_digits + 2 * minutes, 2);
+    timecode[5] = ':';
+    std::memcpy(timecode + 6, two_digits + 2 * seconds, 2);
+    timecode[8] = is_drop_frame() ? ';' : ':';
+    std::memcpy(timecode + 9, two_digits + 2 * frames, 2);
+    return true;
+}
+
+std::string
+TimecodeFormatter::to_timecode(RationalTime time, ErrorStatus* error_status)
+    const
 {
-    auto b = dropframe_timecode_rates.begin(),
-         e = dropframe_timecode_rates.end();
-    return std::find(b, e, rate) != e;
+    std::string timecode(RationalTime::timecode_length, ':');
+    if (!to_timecode(time.value_rescaled_to(_rate), &timecode[0], error_status))
+    {
+        return std::string();
+    }
+    return timecode;
 }
 
 static bool
@@ -193,7 +414,8 @@ RationalTime::from_timecode(
     double             rate,
     ErrorStatus*       error_status)
 {
-    if (!RationalTime::is_smpte_timecode_rate(rate))
+    SmpteRate const* smpte_rate = find_smpte_rate(rate);
+    if (!smpte_rate)
     {
         if (error_status)
         {
@@ -202,7 +424,7 @@ RationalTime::from_timecode(
         return RationalTime::_invalid_time;
     }
 
-    bool rate_is_dropframe = is_dropframe_rate(rate);
+    bool rate_is_dropframe = smpte_rate->is_dropframe_rate;
 
     if (timecode.find(';') != std::string::npos)
     {
@@ -258,7 +480,7 @@ RationalTime::from_timecode(
         return RationalTime::_invalid_time;
     }
 
-    const int nominal_fps = static_cast<int>(std::ceil(rate));
+    const int nominal_fps = smpte_rate->non_drop_frame.nominal_fps;
 
     if (frames >= nominal_fps)
     {
@@ -275,18 +497,8 @@ RationalTime::from_timecode(
         return RationalTime::_invalid_time;
     }
 
-    int dropframes = 0;
-    if (rate_is_dropframe)
-    {
-        if ((rate == 29.97) or (rate == 30000 / 1001.0))
-        {
-            dropframes = 2;
-        }
-        else if ((rate == 59.94) or (rate == 60000 / 1001.0))
-        {
-            dropframes = 4;
-        }
-    }
+    const int dropframes =
+        rate_is_dropframe ? smpte_rate->drop_frame.dropframes : 0;
 
     // to use for drop frame compensation
     int total_minutes = hours * 60 + minutes;
@@ -301,6 +513,102 @@ RationalTime::from_timecode(
     return RationalTime{ double(value), rate };
 }
 
+bool
+RationalTime::from_timecodes(
+    char const*  timecodes,
+    size_t       count,
+    double       rate,
+    double*      frames,
+    ErrorStatus* error_status)
+{
+    SmpteRate const* smpte_rate = find_smpte_rate(rate);
+    if (!smpte_rate)
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus{ ErrorStatus::INVALID_TIMECODE_RATE };
+        }
+        return false;
+    }
+
+    const bool rate_is_dropframe = smpte_rate->is_dropframe_rate;
+    const int  nominal_fps       = smpte_rate->non_drop_frame.nominal_fps;
+    const int  dropframes        = smpte_rate->drop_frame.dropframes;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        char const* timecode = timecodes + i * timecode_length;
+
+        int  fields[4];
+        bool valid      = true;
+        bool is_dropped = false;
+        for (int f = 0; f < 4; ++f)
+        {
+            char const* field = timecode + 3 * f;
+            valid = valid && field[0] >= '0' && field[0] <= '9'
+                    && field[1] >= '0' && field[1] <= '9';
+            fields[f] = (field[0] - '0') * 10 + (field[1] - '0');
+            if (f > 0)
+            {
+                is_dropped = is_dropped || field[-1] == ';';
+            }
+        }
+
+        if (!valid)
+        {
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::INVALID_TIMECODE_STRING,
+                    string_printf(
+                        "Input timecode '%s' is an invalid timecode",
+                        std::string(timecode, timecode_length).c_str()));
+            }
+            return false;
+        }
+        if (is_dropped && !rate_is_dropframe)
+        {
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::INVALID_RATE_FOR_DROP_FRAME_TIMECODE,
+                    string_printf(
+                        "Timecode '%s' indicates drop frame rate due "
+                        "to the ';' frame divider. "
+                        "Passed in rate %g is not a valid drop frame rate.",
+                        std::string(timecode, timecode_length).c_str(),
+                        rate));
+            }
+            return false;
+        }
+        if (fields[3] >= nominal_fps)
+        {
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::TIMECODE_RATE_MISMATCH,
+                    string_printf(
+                        "Frame rate mismatch.  Timecode '%s' has "
+                        "frames beyond %d",
+                        std::string(timecode, timecode_length).c_str(),
+                        nominal_fps - 1));
+            }
+            return false;
+        }
+
+        // to use for drop frame compensation
+        const int total_minutes = fields[0] * 60 + fields[1];
+        const int dropped =
+            is_dropped ? dropframes * (total_minutes - total_minutes / 10)
+                       : 0;
+
+        frames[i] = double(
+            ((total_minutes * 60) + fields[2]) * nominal_fps + fields[3]
+            - dropped);
+    }
+    return true;
+}
+
 static void
 set_error(
     std::string const&   time_string,
@@ -431,10 +739,12 @@ RationalTime::from_time_string(
     return from_seconds(accumulator).rescaled_to(rate);
 }
 
-std::string
+size_t
 RationalTime::to_timecode(
     double          rate,
     IsDropFrameRate drop_frame,
+    char*           buffer,
+    size_t          size,
     ErrorStatus*    error_status) const
 {
     if (error_status)
@@ -444,177 +754,209 @@ RationalTime::to_timecode(
 
     double frames_in_target_rate = this->value_rescaled_to(rate);
 
-    if (frames_in_target_rate < 0)
-    {
-        if (error_status)
-        {
-            *error_status = ErrorStatus(ErrorStatus::NEGATIVE_VALUE);
-        }
-        return std::string();
-    }
-
-    // It is common practice to use truncated or rounded values
-    // like 29.97 instead of exact SMPTE rates like 30000/1001
-    // so as a convenience we will snap the rate to the nearest
-    // SMPTE rate if it is close enough.
-    double nearest_smpte_rate = nearest_smpte_timecode_rate(rate);
-    if (abs(nearest_smpte_rate - rate) > 0.1)
+    if (!std::isfinite(frames_in_target_rate))
     {
         if (error_status)
         {
-            *error_status = ErrorStatus(ErrorStatus::INVALID_TIMECODE_RATE);
+            *error_status = ErrorStatus(
+                ErrorStatus::INVALID_TIMECODE_RATE,
+                string_printf(
+                    "time %g at rate %g is not a finite number of frames",
+                    _value,
+                    _rate));
         }
-        return std::string();
+        return 0;
     }
-
-    // Let's assume this is the rate instead of the given rate.
-    rate = nearest_smpte_rate;
-
-    bool rate_is_dropframe = is_dropframe_rate(rate);
-    if (drop_frame == IsDropFrameRate::ForceYes and not rate_is_dropframe)
+    if (frames_in_target_rate < 0)
     {
         if (error_status)
         {
-            *error_status =
-                ErrorStatus(ErrorStatus::INVALID_RATE_FOR_DROP_FRAME_TIMECODE);
+            *error_status = ErrorStatus(ErrorStatus::NEGATIVE_VALUE);
         }
-        return std::string();
+        return 0;
     }
 
-    if (drop_frame != IsDropFrameRate::InferFromRate)
+    const TimecodeFormatter formatter(rate, drop_frame, error_status);
+    if (!formatter.is_valid())
     {
-        if (drop_frame == IsDropFrameRate::ForceYes)
-        {
-            rate_is_dropframe = true;
-        }
-        else
-        {
-            rate_is_dropframe = false;
-        }
+        return 0;
     }
 
-    // extra math for dropframes stuff
-    int  dropframes = 0;
-    char div        = ':';
-    if (!rate_is_dropframe)
+    // Format on the stack, so that a buffer which is too small is left as
+    // it is.
+    char timecode[timecode_length];
+    if (!formatter.to_timecode(frames_in_target_rate, timecode, error_status))
     {
-        if (std::round(rate) == 24)
-        {
-            rate = 24.0;
-        }
+        return 0;
     }
-    else
+    if (size >= timecode_length)
     {
-        if (rate == 30000 / 1001.0)
-        {
-            dropframes = 2;
-        }
-        else if (rate == 60000 / 1001.0)
-        {
-            dropframes = 4;
-        }
-        div = ';';
+        std::memcpy(buffer, timecode, timecode_length);
     }
+    return timecode_length;
+}
 
-    // Number of frames in an hour
-    int frames_per_hour = static_cast<int>(std::round(rate * 60 * 60));
-    // Number of frames in a day - timecode rolls over after 24 hours
-    int frames_per_24_hours = frames_per_hour * 24;
-    // Number of frames per ten minutes
-    int frames_per_10_minutes = static_cast<int>(std::round(rate * 60 * 10));
-    // Number of frames per minute is the round of the framerate * 60 minus
-    // the number of dropped frames
-    int frames_per_minute =
-        static_cast<int>((std::round(rate) * 60) - dropframes);
+size_t
+RationalTime::to_timecode(
+    double          rate,
+    IsDropFrameRate drop_frame,
+    std::string&    timecode,
+    ErrorStatus*    error_status) const
+{
+    char         buffer[timecode_length];
+    const size_t length =
+        to_timecode(rate, drop_frame, buffer, timecode_length, error_status);
+    timecode.assign(buffer, length);
+    return length;
+}
+
+std::string
+RationalTime::to_timecode(
+    double          rate,
+    IsDropFrameRate drop_frame,
+    ErrorStatus*    error_status) const
+{
+    char         buffer[timecode_length];
+    const size_t length =
+        to_timecode(rate, drop_frame, buffer, timecode_length, error_status);
+    return std::string(buffer, length);
+}
 
-    // If the number of frames is more than 24 hours, roll over clock
-    double value = std::fmod(frames_in_target_rate, frames_per_24_hours);
+bool
+RationalTime::to_timecodes(
+    double const*   frames,
+    size_t          count,
+    double          rate,
+    IsDropFrameRate drop_frame,
+    char*           timecodes,
+    ErrorStatus*    error_status)
+{
+    if (error_status)
+    {
+        *error_status = ErrorStatus();
+    }
 
-    if (rate_is_dropframe)
+    const TimecodeFormatter formatter(rate, drop_frame, error_status);
+    if (!formatter.is_valid())
     {
-        int ten_minute_chunks =
-            static_cast<int>(std::floor(value / frames_per_10_minutes));
-        int frames_over_ten_minutes =
-            static_cast<int>(std::fmod(value, frames_per_10_minutes));
+        return false;
+    }
 
-        if (frames_over_ten_minutes > dropframes)
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!std::isfinite(frames[i]))
         {
-            value += (dropframes * 9 * ten_minute_chunks)
-                     + dropframes
-                           * std::floor(
-                               (frames_over_ten_minutes - dropframes)
-                               / frames_per_minute);
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::INVALID_TIMECODE_RATE,
+                    string_printf(
+                        "frame %g at index %zu is not finite",
+                        frames[i],
+                        i));
+            }
+            return false;
         }
-        else
+        if (frames[i] < 0)
         {
-            value += dropframes * 9 * ten_minute_chunks;
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::NEGATIVE_VALUE,
+                    string_printf(
+                        "frame %g at index %zu cannot be negative",
+                        frames[i],
+                        i));
+            }
+            return false;
         }
+        formatter.to_timecode(frames[i], timecodes + i * timecode_length);
     }
-
-    int nominal_fps = static_cast<int>(std::ceil(rate));
-
-    // compute the fields
-    int frames        = static_cast<int>(std::fmod(value, nominal_fps));
-    int seconds_total = static_cast<int>(std::floor(value / nominal_fps));
-    int seconds       = static_cast<int>(std::fmod(seconds_total, 60));
-    int minutes =
-        static_cast<int>(std::fmod(std::floor(seconds_total / 60), 60));
-    int hours =
-        static_cast<int>(std::floor(std::floor(seconds_total / 60) / 60));
-
-    return string_printf(
-        "%02d:%02d:%02d%c%02d",
-        hours,
-        minutes,
-        seconds,
-        div,
-        frames);
+    return true;
 }
 
-std::string
+size_t
 RationalTime::to_nearest_timecode(
     double          rate,
     IsDropFrameRate drop_frame,
+    char*           buffer,
+    size_t          size,
     ErrorStatus*    error_status) const
 {
-    std::string result = to_timecode(rate, drop_frame, error_status);
-
     if (error_status)
     {
         *error_status = ErrorStatus();
 
         double nearest_rate = nearest_smpte_timecode_rate(rate);
 
-        return to_timecode(nearest_rate, drop_frame, error_status);
+        return to_timecode(nearest_rate, drop_frame, buffer, size, error_status);
     }
 
-    return result;
+    return to_timecode(rate, drop_frame, buffer, size);
+}
+
+size_t
+RationalTime::to_nearest_timecode(
+    double          rate,
+    IsDropFrameRate drop_frame,
+    std::string&    timecode,
+    ErrorStatus*    error_status) const
+{
+    char         buffer[timecode_length];
+    const size_t length = to_nearest_timecode(
+        rate,
+        drop_frame,
+        buffer,
+        timecode_length,
+        error_status);
+    timecode.assign(buffer, length);
+    return length;
 }
 
 std::string
-RationalTime::to_time_string() const
+RationalTime::to_nearest_timecode(
+    double          rate,
+    IsDropFrameRate drop_frame,
+    ErrorStatus*    error_status) const
+{
+    char         buffer[timecode_length];
+    const size_t length = to_nearest_timecode(
+        rate,
+        drop_frame,
+        buffer,
+        timecode_length,
+        error_status);
+    return std::string(buffer, length);
+}
+
+// Write the time string for the given number of seconds, which is at most
+// max_time_string_length characters.
+static size_t
+format_time_string(double total_seconds, char* time_string)
 {
-    double total_seconds = to_seconds();
-    bool   is_negative   = false;
+    char* out = time_string;
 
     // We always want to compute with positive numbers to get the right string
     // result and return the string at the end with a '-'. This provides
     // compatibility with ffmpeg, which allows negative time strings.
     if (std::signbit(total_seconds))
     {
-        total_seconds = fabs(total_seconds);
-        is_negative   = true;
+        total_seconds = std::fabs(total_seconds);
+        *out++        = '-';
     }
 
-    // @TODO: fun fact, this will print the wrong values for numbers at a
-    // certain number of decimal places, if you just std::cerr << total_seconds
+    if (!std::isfinite(total_seconds))
+    {
+        std::memcpy(out, std::isnan(total_seconds) ? "nan" : "inf", 3);
+        return size_t(out + 3 - time_string);
+    }
 
     // reformat in time string
     constexpr double time_units_per_minute = 60.0;
     constexpr double time_units_per_hour   = time_units_per_minute * 60.0;
     constexpr double time_units_per_day    = time_units_per_hour * 24.0;
 
-    double hour_units = std::fmod((double) total_seconds, time_units_per_day);
+    double hour_units = std::fmod(total_seconds, time_units_per_day);
 
     int hours = static_cast<int>(std::floor(hour_units / time_units_per_hour));
     double minute_units = std::fmod(hour_units, time_units_per_hour);
@@ -626,40 +968,76 @@ RationalTime::to_time_string() const
     // split the seconds string apart
     double fractpart, intpart;
 
-    fractpart = modf(seconds, &intpart);
-
-    // clamp to 2 digits and zero-pad
-    std::string seconds_str = string_printf("%02d", (int) intpart);
-
-    // get the fractional component (with enough digits of resolution)
-    std::string microseconds_str = string_printf("%.7g", fractpart);
-
-    // trim leading 0
-    microseconds_str = microseconds_str.substr(1);
-
-    // enforce the minimum string of '.0'
-    if (microseconds_str.length() == 0)
+    fractpart = std::modf(seconds, &intpart);
+
+    std::memcpy(out, two_digits + 2 * hours, 2);
+    out[2] = ':';
+    std::memcpy(out + 3, two_digits + 2 * minutes, 2);
+    out[5] = ':';
+    std::memcpy(out + 6, two_digits + 2 * static_cast<int>(intpart), 2);
+    out += 8;
+
+    // get the fractional component (with enough digits of resolution), the
+    // same as "%.7g"
+    char fraction[32];
+#if defined(__cpp_lib_to_chars)
+    const size_t fraction_length = size_t(
+        std::to_chars(
+            fraction,
+            fraction + sizeof(fraction),
+            fractpart,
+            std::chars_format::general,
+            7)
+            .ptr
+        - fraction);
+#else  // __cpp_lib_to_chars
+    const size_t fraction_length = size_t(
+        std::snprintf(fraction, sizeof(fraction), "%.7g", fractpart));
+#endif // __cpp_lib_to_chars
+
+    // trim leading 0, and enforce the minimum string of '.0' and the
+    // maximum string size
+    if (fraction_length <= 1)
     {
-        microseconds_str = std::string(".0");
+        *out++ = '.';
+        *out++ = '0';
     }
     else
     {
-        // ...and the string size
-        microseconds_str.resize(7, '\0');
+        const size_t length = std::min(fraction_length - 1, size_t(7));
+        std::memcpy(out, fraction + 1, length);
+        out += length;
     }
+    return size_t(out - time_string);
+}
 
-    // if the initial time value was negative, return the string with a '-'
-    // sign
-    std::string sign = is_negative ? "-" : "";
+size_t
+RationalTime::to_time_string(char* buffer, size_t size) const
+{
+    char         time_string[max_time_string_length];
+    const size_t length = format_time_string(to_seconds(), time_string);
+    if (size >= length)
+    {
+        std::memcpy(buffer, time_string, length);
+    }
+    return length;
+}
+
+size_t
+RationalTime::to_time_string(std::string& time_string) const
+{
+    char         buffer[max_time_string_length];
+    const size_t length = format_time_string(to_seconds(), buffer);
+    time_string.assign(buffer, length);
+    return length;
+}
 
-    return string_printf(
-        // decimal should already be in the microseconds_str
-        "%s%02d:%02d:%s%s",
-        sign.c_str(),
-        hours,
-        minutes,
-        seconds_str.c_str(),
-        microseconds_str.c_str());
+std::string
+RationalTime::to_time_string() const
+{
+    char         buffer[max_time_string_length];
+    const size_t length = format_time_string(to_seconds(), buffer);
+    return std::string(buffer, length);
 }
 
 }} // namespace opentime::OPENTIME_VERSION
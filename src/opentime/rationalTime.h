@@ -6,6 +6,7 @@
 #include "opentime/errorStatus.h"
 #include "opentime/version.h"
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <string>
@@ -209,6 +210,31 @@ public:
         double             rate,
         ErrorStatus*       error_status = nullptr);
 
+    /// @brief The length of the timecodes read by from_timecodes() and
+    /// written by to_timecodes() ("HH:MM:SS:FF" or "HH:MM:SS;FF").
+    static constexpr size_t timecode_length = 11;
+
+    /// @brief Convert timecodes into frame numbers.
+    ///
+    /// This is the same as calling from_timecode() on each timecode, except
+    /// that the rate is checked once.  The timecodes are read one after
+    /// another from timecodes, without separators or null terminators, and
+    /// the frame numbers are written to frames.
+    ///
+    /// Conversion stops at the first invalid timecode.
+    ///
+    /// @param timecodes The timecodes, count * timecode_length characters.
+    /// @param count The number of timecodes.
+    /// @param rate The timecode rate.
+    /// @param frames The frame numbers, count values.
+    /// @param error_status Optional error status.
+    static bool from_timecodes(
+        char const*  timecodes,
+        size_t       count,
+        double       rate,
+        double*      frames,
+        ErrorStatus* error_status = nullptr);
+
     /// @brief Parse a string in the form "hours:minutes:seconds".
     ///
     /// The string may have a leading negative sign.
@@ -254,6 +280,66 @@ public:
         return to_timecode(_rate, IsDropFrameRate::InferFromRate, error_status);
     }
 
+    /// @brief Convert to timecode (e.g., "HH:MM:SS;FRAME") in a buffer.
+    ///
+    /// The timecode is written without a null terminator, and only if it
+    /// fits in the buffer.
+    ///
+    /// @param rate The timecode rate.
+    /// @param drop_frame Whether to use drop frame timecode.
+    /// @param buffer The buffer.
+    /// @param size The size of the buffer.
+    /// @param error_status Optional error status.
+    /// @return The length of the timecode (timecode_length), or zero if
+    /// there is an error.
+    size_t to_timecode(
+        double          rate,
+        IsDropFrameRate drop_frame,
+        char*           buffer,
+        size_t          size,
+        ErrorStatus*    error_status = nullptr) const;
+
+    /// @brief Convert to timecode (e.g., "HH:MM:SS;FRAME") in a string.
+    ///
+    /// The string is reused, so converting many times into the same string
+    /// does not allocate.
+    ///
+    /// @param rate The timecode rate.
+    /// @param drop_frame Whether to use drop frame timecode.
+    /// @param timecode The timecode, empty if there is an error.
+    /// @param error_status Optional error status.
+    /// @return The length of the timecode.
+    size_t to_timecode(
+        double          rate,
+        IsDropFrameRate drop_frame,
+        std::string&    timecode,
+        ErrorStatus*    error_status = nullptr) const;
+
+    /// @brief Convert frame numbers into timecodes.
+    ///
+    /// This is the same as calling to_timecode(rate, drop_frame) on a time
+    /// of each frame number at the given rate, except that the rate and the
+    /// drop frame constants are resolved once.  The timecodes are written
+    /// one after another to timecodes, without separators or null
+    /// terminators.
+    ///
+    /// Conversion stops at the first frame number that cannot be
+    /// converted.
+    ///
+    /// @param frames The frame numbers, count values.
+    /// @param count The number of frame numbers.
+    /// @param rate The timecode rate.
+    /// @param drop_frame Whether to use drop frame timecode.
+    /// @param timecodes The timecodes, count * timecode_length characters.
+    /// @param error_status Optional error status.
+    static bool to_timecodes(
+        double const*   frames,
+        size_t          count,
+        double          rate,
+        IsDropFrameRate drop_frame,
+        char*           timecodes,
+        ErrorStatus*    error_status = nullptr);
+
     /// @brief Convert to the nearest timecode (e.g., "HH:MM:SS;FRAME").
     ///
     /// @param rate The timecode rate.
@@ -273,6 +359,26 @@ public:
             error_status);
     }
 
+    /// @brief Convert to the nearest timecode (e.g., "HH:MM:SS;FRAME") in a
+    /// buffer, see to_timecode().
+    size_t to_nearest_timecode(
+        double          rate,
+        IsDropFrameRate drop_frame,
+        char*           buffer,
+        size_t          size,
+        ErrorStatus*    error_status = nullptr) const;
+
+    /// @brief Convert to the nearest timecode (e.g., "HH:MM:SS;FRAME") in a
+    /// string, see to_timecode().
+    size_t to_nearest_timecode(
+        double          rate,
+        IsDropFrameRate drop_frame,
+        std::string&    timecode,
+        ErrorStatus*    error_status = nullptr) const;
+
+    /// @brief The maximum length of the strings written by to_time_string().
+    static constexpr size_t max_time_string_length = 16;
+
     /// @brief Return a string in the form "hours:minutes:seconds".
     ///
     /// Seconds may have up to microsecond precision.
@@ -280,6 +386,27 @@ public:
     /// @return The time string, which may have a leading negative sign.
     std::string to_time_string() const;
 
+    /// @brief Write a string in the form "hours:minutes:seconds" in a
+    /// buffer.
+    ///
+    /// The string is written without a null terminator, and only if it fits
+    /// in the buffer; a buffer of max_time_string_length always fits.
+    ///
+    /// @param buffer The buffer.
+    /// @param size The size of the buffer.
+    /// @return The length of the time string.
+    size_t to_time_string(char* buffer, size_t size) const;
+
+    /// @brief Write a string in the form "hours:minutes:seconds" in a
+    /// string.
+    ///
+    /// The string is reused, so converting many times into the same string
+    /// does not allocate.
+    ///
+    /// @param time_string The time string.
+    /// @return The length of the time string.
+    size_t to_time_string(std::string& time_string) const;
+
     /// @brief Add a time to this time.
     constexpr RationalTime const& operator+=(RationalTime other) noexcept
     {
@@ -423,4 +550,65 @@ private:
     }
 };
 
+/// @brief This class converts frame numbers into timecodes at a given rate.
+///
+/// The rate and the drop frame mode are resolved, and the constants of the
+/// conversion are looked up, once when the formatter is constructed, so
+/// converting a frame number is integer arithmetic only. Use a formatter
+/// to convert many frame numbers at the same rate.
+class TimecodeFormatter
+{
+public:
+    /// @brief Construct a new formatter.
+    ///
+    /// As with RationalTime::to_timecode(), the rate is snapped to the
+    /// nearest SMPTE timecode rate. If the rate is not close to a SMPTE
+    /// timecode rate, or drop frame timecode is forced at a rate that does
+    /// not support it, the formatter is not valid.
+    ///
+    /// @param rate The timecode rate.
+    /// @param drop_frame Whether to use drop frame timecode.
+    /// @param error_status Optional error status.
+    explicit TimecodeFormatter(
+        double          rate,
+        IsDropFrameRate drop_frame   = IsDropFrameRate::InferFromRate,
+        ErrorStatus*    error_status = nullptr);
+
+    /// @brief Returns whether the formatter is valid.
+    bool is_valid() const noexcept { return _nominal_fps > 0; }
+
+    /// @brief Returns the timecode rate.
+    double rate() const noexcept { return _rate; }
+
+    /// @brief Returns whether the timecodes are drop frame timecodes.
+    bool is_drop_frame() const noexcept { return _dropframes > 0; }
+
+    /// @brief Convert a frame number at the timecode rate into a timecode.
+    ///
+    /// @param frame The frame number.
+    /// @param timecode The timecode, RationalTime::timecode_length
+    /// characters, without a null terminator.
+    /// @param error_status Optional error status.
+    bool to_timecode(
+        double       frame,
+        char*        timecode,
+        ErrorStatus* error_status = nullptr) const;
+
+    /// @brief Convert a time into a timecode, the same as
+    /// RationalTime::to_timecode().
+    ///
+    /// @param time The time.
+    /// @param error_status Optional error status.
+    std::string
+    to_timecode(RationalTime time, ErrorStatus* error_status = nullptr) const;
+
+private:
+    double _rate                  = 0;
+    int    _nominal_fps           = 0;
+    int    _dropframes            = 0;
+    int    _frames_per_minute     = 0;
+    int    _frames_per_10_minutes = 0;
+    int    _frames_per_24_hours   = 0;
+};
+
 }} // namespace opentime::OPENTIME_VERSION
@@ -0,0 +1,408 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "opentime/timeArrays.h"
+
+namespace opentime { namespace OPENTIME_VERSION {
+
+// The kernels below are written lane by lane: each function takes and
+// returns plain doubles, and repeats the arithmetic of the RationalTime
+// and TimeRange members with the same operations in the same order, so
+// the results are identical. Both sides of each condition are computed and
+// then selected, rather than branched on, so that the loops which call
+// them can be vectorized (e.g. with SSE/AVX or NEON); where they cannot
+// be, they are plain scalar loops.
+
+namespace {
+
+struct Time
+{
+    double value;
+    double rate;
+};
+
+inline Time
+select(bool condition, Time lhs, Time rhs) noexcept
+{
+    return Time{ condition ? lhs.value : rhs.value,
+                 condition ? lhs.rate : rhs.rate };
+}
+
+// See RationalTime::value_rescaled_to().
+inline double
+rescaled(Time time, double new_rate) noexcept
+{
+    const double value = (time.value * new_rate) / time.rate;
+    return new_rate == time.rate ? time.value : value;
+}
+
+// See RationalTime::to_seconds().
+inline double
+seconds(Time time) noexcept
+{
+    return rescaled(time, 1);
+}
+
+// See RationalTime::operator+(); the time with the lower rate is rescaled
+// to the higher rate, so only one of them is.
+inline Time
+add(Time lhs, Time rhs) noexcept
+{
+    const bool lower = lhs.rate < rhs.rate;
+    const Time from  = select(lower, lhs, rhs);
+    const Time to    = select(lower, rhs, lhs);
+    return Time{ rescaled(from, to.rate) + to.value, to.rate };
+}
+
+// See RationalTime::operator-().
+inline Time
+subtract(Time lhs, Time rhs) noexcept
+{
+    const bool   lower = lhs.rate < rhs.rate;
+    const Time   from  = select(lower, lhs, rhs);
+    const Time   to    = select(lower, rhs, lhs);
+    const double value = rescaled(from, to.rate);
+    return Time{ lower ? value - to.value : to.value - value, to.rate };
+}
+
+// See RationalTime::operator<().
+inline bool
+less(Time lhs, Time rhs) noexcept
+{
+    return !((lhs.value / lhs.rate) >= (rhs.value / rhs.rate));
+}
+
+// See RationalTime::operator<=().
+inline bool
+less_equal(Time lhs, Time rhs) noexcept
+{
+    return !((lhs.value / lhs.rate) > (rhs.value / rhs.rate));
+}
+
+// See TimeRange::end_time_exclusive(); the start time is rescaled to the
+// rate of the duration, so the addition needs no further rescaling.
+inline Time
+end_time_exclusive(Time start_time, Time duration) noexcept
+{
+    return Time{ rescaled(start_time, duration.rate) + duration.value,
+                 duration.rate };
+}
+
+// See RationalTime::duration_from_start_end_time(); rescaling to the same
+// rate leaves the value as it is.
+inline Time
+duration_from_start_end_time(Time start_time, Time end_time) noexcept
+{
+    return Time{ rescaled(end_time, start_time.rate) - start_time.value,
+                 start_time.rate };
+}
+
+// See TimeTransform::applied_to().
+inline Time
+applied_to(TimeTransform transform, Time time) noexcept
+{
+    const Time offset{ transform.offset().value(),
+                       transform.offset().rate() };
+    const Time result =
+        add(Time{ time.value * transform.scale(), time.rate }, offset);
+    const double target_rate =
+        transform.rate() > 0 ? transform.rate() : time.rate;
+    return select(
+        target_rate > 0,
+        Time{ rescaled(result, target_rate), target_rate },
+        result);
+}
+
+inline Time
+to_time(RationalTime time) noexcept
+{
+    return Time{ time.value(), time.rate() };
+}
+
+struct Range
+{
+    Time start_time;
+    Time duration;
+};
+
+// The arrays are passed as restrict pointers, so that the compiler does
+// not need to check whether the outputs overlap the inputs.
+
+template <typename Function>
+inline void
+map_times(
+    size_t                  count,
+    double const* __restrict values,
+    double const* __restrict rates,
+    double* __restrict       out_values,
+    double* __restrict       out_rates,
+    Function                 function) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Time time = function(Time{ values[i], rates[i] });
+        out_values[i]   = time.value;
+        out_rates[i]    = time.rate;
+    }
+}
+
+template <typename Function>
+inline void
+map_ranges(
+    size_t                  count,
+    double const* __restrict start_values,
+    double const* __restrict start_rates,
+    double const* __restrict duration_values,
+    double const* __restrict duration_rates,
+    double* __restrict       out_start_values,
+    double* __restrict       out_start_rates,
+    double* __restrict       out_duration_values,
+    double* __restrict       out_duration_rates,
+    Function                 function) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Range range =
+            function(Time{ start_values[i], start_rates[i] },
+                     Time{ duration_values[i], duration_rates[i] });
+        out_start_values[i]    = range.start_time.value;
+        out_start_rates[i]     = range.start_time.rate;
+        out_duration_values[i] = range.duration.value;
+        out_duration_rates[i]  = range.duration.rate;
+    }
+}
+
+// The predicate is given the start time and the exclusive end time.
+template <typename Predicate>
+inline void
+test_ranges(
+    size_t                  count,
+    double const* __restrict start_values,
+    double const* __restrict start_rates,
+    double const* __restrict duration_values,
+    double const* __restrict duration_rates,
+    uint8_t* __restrict      out,
+    Predicate                predicate) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Time start_time{ start_values[i], start_rates[i] };
+        const Time end_time = end_time_exclusive(
+            start_time,
+            Time{ duration_values[i], duration_rates[i] });
+        out[i] = predicate(start_time, end_time);
+    }
+}
+
+} // namespace
+
+RationalTimeArray::RationalTimeArray(std::vector<RationalTime> const& times)
+{
+    reserve(times.size());
+    for (const auto& time: times)
+    {
+        push_back(time);
+    }
+}
+
+void
+RationalTimeArray::reserve(size_t size)
+{
+    _values.reserve(size);
+    _rates.reserve(size);
+}
+
+std::vector<RationalTime>
+RationalTimeArray::to_rational_times() const
+{
+    std::vector<RationalTime> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i)
+    {
+        result.push_back((*this)[i]);
+    }
+    return result;
+}
+
+RationalTimeArray
+RationalTimeArray::rescaled_to(double new_rate) const
+{
+    RationalTimeArray result;
+    result._values.resize(size());
+    result._rates.resize(size());
+    map_times(
+        size(),
+        _values.data(),
+        _rates.data(),
+        result._values.data(),
+        result._rates.data(),
+        [new_rate](Time time) {
+            return Time{ rescaled(time, new_rate), new_rate };
+        });
+    return result;
+}
+
+RationalTimeArray
+RationalTimeArray::transformed_by(TimeTransform transform) const
+{
+    RationalTimeArray result;
+    result._values.resize(size());
+    result._rates.resize(size());
+    map_times(
+        size(),
+        _values.data(),
+        _rates.data(),
+        result._values.data(),
+        result._rates.data(),
+        [transform](Time time) { return applied_to(transform, time); });
+    return result;
+}
+
+TimeRangeArray::TimeRangeArray(std::vector<TimeRange> const& ranges)
+{
+    reserve(ranges.size());
+    for (const auto& range: ranges)
+    {
+        push_back(range);
+    }
+}
+
+void
+TimeRangeArray::reserve(size_t size)
+{
+    _start_values.reserve(size);
+    _start_rates.reserve(size);
+    _duration_values.reserve(size);
+    _duration_rates.reserve(size);
+}
+
+std::vector<TimeRange>
+TimeRangeArray::to_time_ranges() const
+{
+    std::vector<TimeRange> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i)
+    {
+        result.push_back((*this)[i]);
+    }
+    return result;
+}
+
+template <typename Function>
+TimeRangeArray
+TimeRangeArray::_map(Function function) const
+{
+    TimeRangeArray result;
+    result._start_values.resize(size());
+    result._start_rates.resize(size());
+    result._duration_values.resize(size());
+    result._duration_rates.resize(size());
+    map_ranges(
+        size(),
+        _start_values.data(),
+        _start_rates.data(),
+        _duration_values.data(),
+        _duration_rates.data(),
+        result._start_values.data(),
+        result._start_rates.data(),
+        result._duration_values.data(),
+        result._duration_rates.data(),
+        function);
+    return result;
+}
+
+template <typename Predicate>
+std::vector<uint8_t>
+TimeRangeArray::_test(Predicate predicate) const
+{
+    std::vector<uint8_t> result(size());
+    test_ranges(
+        size(),
+        _start_values.data(),
+        _start_rates.data(),
+        _duration_values.data(),
+        _duration_rates.data(),
+        result.data(),
+        predicate);
+    return result;
+}
+
+TimeRangeArray
+TimeRangeArray::transformed_by(TimeTransform transform) const
+{
+    return _map([transform](Time start_time, Time duration) {
+        const Time end_time = end_time_exclusive(start_time, duration);
+        const Time new_start_time = applied_to(transform, start_time);
+        return Range{ new_start_time,
+                      duration_from_start_end_time(
+                          new_start_time,
+                          applied_to(transform, end_time)) };
+    });
+}
+
+std::vector<uint8_t>
+TimeRangeArray::contains(RationalTime other) const
+{
+    const Time time = to_time(other);
+    return _test([time](Time start_time, Time end_time) {
+        return less_equal(start_time, time) & less(time, end_time);
+    });
+}
+
+std::vector<uint8_t>
+TimeRangeArray::contains(TimeRange other, double epsilon_s) const
+{
+    const double other_start = other.start_time().to_seconds();
+    const double other_end   = other.end_time_exclusive().to_seconds();
+    return _test([=](Time start_time, Time end_time) {
+        return (other_start - seconds(start_time) >= epsilon_s)
+               & (seconds(end_time) - other_end >= epsilon_s);
+    });
+}
+
+std::vector<uint8_t>
+TimeRangeArray::intersects(TimeRange other, double epsilon_s) const
+{
+    const double other_start = other.start_time().to_seconds();
+    const double other_end   = other.end_time_exclusive().to_seconds();
+    return _test([=](Time start_time, Time end_time) {
+        return (other_end - seconds(start_time) >= epsilon_s)
+               & (seconds(end_time) - other_start >= epsilon_s);
+    });
+}
+
+TimeRangeArray
+TimeRangeArray::clamped_to(TimeRange bounds) const
+{
+    const Time bounds_start = to_time(bounds.start_time());
+    const Time bounds_end   = to_time(bounds.end_time_exclusive());
+    return _map([=](Time start_time, Time duration) {
+        const Time new_start_time =
+            select(less(start_time, bounds_start), bounds_start, start_time);
+        const Time end_time = end_time_exclusive(new_start_time, duration);
+        return Range{ new_start_time,
+                      subtract(
+                          select(less(bounds_end, end_time), bounds_end, end_time),
+                          new_start_time) };
+    });
+}
+
+TimeRangeArray
+TimeRangeArray::extended_by(TimeRange other) const
+{
+    const Time other_start = to_time(other.start_time());
+    const Time other_end   = to_time(other.end_time_exclusive());
+    return _map([=](Time start_time, Time duration) {
+        const Time end_time = end_time_exclusive(start_time, duration);
+        const Time new_start_time =
+            select(less(other_start, start_time), other_start, start_time);
+        const Time new_end_time =
+            select(less(end_time, other_end), other_end, end_time);
+        return Range{ new_start_time,
+                      duration_from_start_end_time(
+                          new_start_time,
+                          new_end_time) };
+    });
+}
+
+}} // namespace opentime::OPENTIME_VERSION
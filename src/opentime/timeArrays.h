@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentime/rationalTime.h"
+#include "opentime/timeRange.h"
+#include "opentime/timeTransform.h"
+#include "opentime/version.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opentime { namespace OPENTIME_VERSION {
+
+/// @brief This class represents an array of times.
+///
+/// The values and the rates are stored in separate contiguous arrays, so
+/// that the operations on the whole array are simple loops over doubles
+/// that the compiler can vectorize. Each operation gives the same result
+/// as the RationalTime or TimeTransform operation on each time.
+class RationalTimeArray
+{
+public:
+    /// @brief Construct a new empty array.
+    RationalTimeArray() noexcept = default;
+
+    /// @brief Construct a new array with the given times.
+    explicit RationalTimeArray(std::vector<RationalTime> const& times);
+
+    /// @brief Returns the number of times.
+    size_t size() const noexcept { return _values.size(); }
+
+    /// @brief Returns whether the array is empty.
+    bool empty() const noexcept { return _values.empty(); }
+
+    /// @brief Reserve space for the given number of times.
+    void reserve(size_t size);
+
+    /// @brief Add a time to the end of the array.
+    void push_back(RationalTime time)
+    {
+        _values.push_back(time.value());
+        _rates.push_back(time.rate());
+    }
+
+    /// @brief Returns the time at the given index.
+    RationalTime operator[](size_t index) const noexcept
+    {
+        return RationalTime{ _values[index], _rates[index] };
+    }
+
+    /// @brief Returns the values.
+    std::vector<double> const& values() const noexcept { return _values; }
+
+    /// @brief Returns the rates.
+    std::vector<double> const& rates() const noexcept { return _rates; }
+
+    /// @brief Returns the times.
+    std::vector<RationalTime> to_rational_times() const;
+
+    /// @brief Returns the times rescaled to the given rate.
+    RationalTimeArray rescaled_to(double new_rate) const;
+
+    /// @brief Returns the times with the given transform applied, see
+    /// TimeTransform::applied_to().
+    RationalTimeArray transformed_by(TimeTransform transform) const;
+
+private:
+    std::vector<double> _values;
+    std::vector<double> _rates;
+};
+
+/// @brief This class represents an array of time ranges.
+///
+/// The start times and the durations are stored in separate contiguous
+/// arrays of values and rates, see RationalTimeArray. Each operation gives
+/// the same result as the TimeRange or TimeTransform operation on each
+/// range. The predicates return one byte per range, which is 1 if the
+/// predicate is true and 0 otherwise.
+class TimeRangeArray
+{
+public:
+    /// @brief Construct a new empty array.
+    TimeRangeArray() noexcept = default;
+
+    /// @brief Construct a new array with the given time ranges.
+    explicit TimeRangeArray(std::vector<TimeRange> const& ranges);
+
+    /// @brief Returns the number of time ranges.
+    size_t size() const noexcept { return _start_values.size(); }
+
+    /// @brief Returns whether the array is empty.
+    bool empty() const noexcept { return _start_values.empty(); }
+
+    /// @brief Reserve space for the given number of time ranges.
+    void reserve(size_t size);
+
+    /// @brief Add a time range to the end of the array.
+    void push_back(TimeRange range)
+    {
+        _start_values.push_back(range.start_time().value());
+        _start_rates.push_back(range.start_time().rate());
+        _duration_values.push_back(range.duration().value());
+        _duration_rates.push_back(range.duration().rate());
+    }
+
+    /// @brief Returns the time range at the given index.
+    TimeRange operator[](size_t index) const noexcept
+    {
+        return TimeRange{
+            RationalTime{ _start_values[index], _start_rates[index] },
+            RationalTime{ _duration_values[index], _duration_rates[index] }
+        };
+    }
+
+    /// @brief Returns the start time values.
+    std::vector<double> const& start_values() const noexcept
+    {
+        return _start_values;
+    }
+
+    /// @brief Returns the start time rates.
+    std::vector<double> const& start_rates() const noexcept
+    {
+        return _start_rates;
+    }
+
+    /// @brief Returns the duration values.
+    std::vector<double> const& duration_values() const noexcept
+    {
+        return _duration_values;
+    }
+
+    /// @brief Returns the duration rates.
+    std::vector<double> const& duration_rates() const noexcept
+    {
+        return _duration_rates;
+    }
+
+    /// @brief Returns the time ranges.
+    std::vector<TimeRange> to_time_ranges() const;
+
+    /// @brief Returns the time ranges with the given transform applied, see
+    /// TimeTransform::applied_to().
+    TimeRangeArray transformed_by(TimeTransform transform) const;
+
+    /// @brief Returns whether each time range contains the given time, see
+    /// TimeRange::contains().
+    std::vector<uint8_t> contains(RationalTime other) const;
+
+    /// @brief Returns whether each time range contains the given time
+    /// range, see TimeRange::contains().
+    std::vector<uint8_t>
+    contains(TimeRange other, double epsilon_s = DEFAULT_EPSILON_s) const;
+
+    /// @brief Returns whether each time range intersects the given time
+    /// range, see TimeRange::intersects().
+    std::vector<uint8_t>
+    intersects(TimeRange other, double epsilon_s = DEFAULT_EPSILON_s) const;
+
+    /// @brief Returns the time ranges clamped to the given time range.
+    ///
+    /// Each time range is the result of <em>bounds.clamped(range)</em>.
+    TimeRangeArray clamped_to(TimeRange bounds) const;
+
+    /// @brief Returns the time ranges extended by the given time range, see
+    /// TimeRange::extended_by().
+    TimeRangeArray extended_by(TimeRange other) const;
+
+private:
+    // Apply a function to each range, see timeArrays.cpp.
+    template <typename Function>
+    TimeRangeArray _map(Function function) const;
+
+    // Test a predicate on each range, see timeArrays.cpp.
+    template <typename Predicate>
+    std::vector<uint8_t> _test(Predicate predicate) const;
+
+    std::vector<double> _start_values;
+    std::vector<double> _start_rates;
+    std::vector<double> _duration_values;
+    std::vector<double> _duration_rates;
+};
+
+}} // namespace opentime::OPENTIME_VERSION
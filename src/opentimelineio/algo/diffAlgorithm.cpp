@@ -0,0 +1,736 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "opentimelineio/algo/diffAlgorithm.h"
+
+#include "opentimelineio/clip.h"
+#include "opentimelineio/gap.h"
+#include "opentimelineio/item.h"
+#include "opentimelineio/stack.h"
+#include "opentimelineio/track.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION { namespace algo {
+
+namespace
+{
+
+// Matching children, as (index in before, index in after) pairs in
+// increasing order.
+using Matches = std::vector<std::pair<size_t, size_t>>;
+
+// Regions without unique anchors are matched with a full LCS table, as long
+// as it has no more than this many cells.
+constexpr size_t max_lcs_cells = size_t(1) << 22;
+
+inline uint64_t
+combine_keys(uint64_t seed, uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+// The key children are matched by: their schema, name and media.
+uint64_t
+match_key(Composable const* child, ErrorStatus* error_status)
+{
+    std::hash<std::string> string_hash;
+
+    uint64_t key = string_hash(child->schema_name());
+    key          = combine_keys(key, string_hash(child->name()));
+    if (auto clip = dynamic_cast<Clip const*>(child))
+    {
+        key = combine_keys(
+            key,
+            string_hash(clip->active_media_reference_key()));
+        if (auto media_reference = clip->media_reference())
+        {
+            auto const hash = media_reference->content_hash(error_status);
+            key = combine_keys(combine_keys(key, hash.high), hash.low);
+        }
+    }
+    return key;
+}
+
+enum class Change
+{
+    none,
+    trim,
+    other
+};
+
+Change
+change_between(
+    Composable const* before,
+    Composable const* after,
+    ErrorStatus*      error_status)
+{
+    if (before->content_hash(error_status) == after->content_hash(error_status)
+        || before->is_equivalent_to(*after))
+    {
+        return Change::none;
+    }
+
+    auto before_item = dynamic_cast<Item const*>(before);
+    auto after_item  = dynamic_cast<Item const*>(after);
+    if (!before_item || !after_item)
+    {
+        return Change::other;
+    }
+
+    SerializableObject::Retainer<Item> trimmed(
+        dynamic_cast<Item*>(before_item->clone(error_status)));
+    if (!trimmed)
+    {
+        return Change::other;
+    }
+    trimmed->set_source_range(after_item->source_range());
+    return trimmed->is_equivalent_to(*after_item) ? Change::trim
+                                                  : Change::other;
+}
+
+// The longest run of candidates that increases in both indices, given
+// candidates in increasing order of their first index.
+Matches
+longest_increasing(Matches const& candidates)
+{
+    // tails[k] is the candidate ending the best run of length k + 1 so far
+    std::vector<size_t> tails;
+    std::vector<size_t> previous(candidates.size(), SIZE_MAX);
+    for (size_t c = 0; c < candidates.size(); ++c)
+    {
+        auto tail = std::lower_bound(
+            tails.begin(),
+            tails.end(),
+            candidates[c].second,
+            [&candidates](size_t t, size_t value) {
+                return candidates[t].second < value;
+            });
+        if (tail != tails.begin())
+        {
+            previous[c] = *(tail - 1);
+        }
+        if (tail == tails.end())
+        {
+            tails.push_back(c);
+        }
+        else
+        {
+            *tail = c;
+        }
+    }
+
+    Matches run(tails.size());
+    size_t  c = tails.empty() ? SIZE_MAX : tails.back();
+    for (size_t k = run.size(); k-- > 0;)
+    {
+        run[k] = candidates[c];
+        c      = previous[c];
+    }
+    return run;
+}
+
+void
+match_lcs(
+    std::vector<uint64_t> const& a,
+    std::vector<uint64_t> const& b,
+    size_t                       a0,
+    size_t                       a1,
+    size_t                       b0,
+    size_t                       b1,
+    Matches*                     matches)
+{
+    const size_t n = a1 - a0;
+    const size_t m = b1 - b0;
+
+    // lengths[i * (m + 1) + j] is the LCS length of a[a0 + i, a1) and
+    // b[b0 + j, b1)
+    std::vector<uint32_t> lengths((n + 1) * (m + 1), 0);
+    auto at = [&lengths, m](size_t i, size_t j) -> uint32_t& {
+        return lengths[i * (m + 1) + j];
+    };
+    for (size_t i = n; i-- > 0;)
+    {
+        for (size_t j = m; j-- > 0;)
+        {
+            at(i, j) = a[a0 + i] == b[b0 + j]
+                           ? at(i + 1, j + 1) + 1
+                           : std::max(at(i + 1, j), at(i, j + 1));
+        }
+    }
+
+    size_t i = 0, j = 0;
+    while (i < n && j < m)
+    {
+        if (a[a0 + i] == b[b0 + j])
+        {
+            matches->emplace_back(a0 + i++, b0 + j++);
+        }
+        else if (at(i + 1, j) >= at(i, j + 1))
+        {
+            ++i;
+        }
+        else
+        {
+            ++j;
+        }
+    }
+}
+
+// Patience diff of a[a0, a1) and b[b0, b1): common ends are matched first,
+// then keys that occur once on each side anchor the matching of the rest.
+void
+match_range(
+    std::vector<uint64_t> const& a,
+    std::vector<uint64_t> const& b,
+    size_t                       a0,
+    size_t                       a1,
+    size_t                       b0,
+    size_t                       b1,
+    Matches*                     matches)
+{
+    while (a0 < a1 && b0 < b1 && a[a0] == b[b0])
+    {
+        matches->emplace_back(a0++, b0++);
+    }
+
+    size_t suffix = 0;
+    while (a0 < a1 - suffix && b0 < b1 - suffix
+           && a[a1 - suffix - 1] == b[b1 - suffix - 1])
+    {
+        ++suffix;
+    }
+    a1 -= suffix;
+    b1 -= suffix;
+
+    if (a0 < a1 && b0 < b1)
+    {
+        struct Occurrences
+        {
+            size_t count_a = 0;
+            size_t count_b = 0;
+            size_t index_b = 0;
+        };
+
+        std::unordered_map<uint64_t, Occurrences> occurrences;
+        for (size_t i = a0; i < a1; ++i)
+        {
+            ++occurrences[a[i]].count_a;
+        }
+        for (size_t j = b0; j < b1; ++j)
+        {
+            auto& o = occurrences[b[j]];
+            ++o.count_b;
+            o.index_b = j;
+        }
+
+        Matches candidates;
+        for (size_t i = a0; i < a1; ++i)
+        {
+            auto const& o = occurrences[a[i]];
+            if (o.count_a == 1 && o.count_b == 1)
+            {
+                candidates.emplace_back(i, o.index_b);
+            }
+        }
+
+        auto const anchors = longest_increasing(candidates);
+        if (!anchors.empty())
+        {
+            size_t i = a0, j = b0;
+            for (auto const& anchor: anchors)
+            {
+                match_range(a, b, i, anchor.first, j, anchor.second, matches);
+                matches->push_back(anchor);
+                i = anchor.first + 1;
+                j = anchor.second + 1;
+            }
+            match_range(a, b, i, a1, j, b1, matches);
+        }
+        else if ((a1 - a0 + 1) * (b1 - b0 + 1) <= max_lcs_cells)
+        {
+            match_lcs(a, b, a0, a1, b0, b1, matches);
+        }
+    }
+
+    for (size_t k = 0; k < suffix; ++k)
+    {
+        matches->emplace_back(a1 + k, b1 + k);
+    }
+}
+
+// Partial sums over the slots of an alignment (a Fenwick tree).
+template <typename T>
+class PrefixSums
+{
+public:
+    PrefixSums(size_t size)
+        : _sums(size + 1, T())
+    {}
+
+    void add(size_t slot, T value)
+    {
+        for (++slot; slot < _sums.size(); slot += slot & (~slot + 1))
+        {
+            _sums[slot] = _sums[slot] + value;
+        }
+    }
+
+    // The sum over the slots before slot.
+    T before(size_t slot) const
+    {
+        T sum = T();
+        for (; slot > 0; slot -= slot & (~slot + 1))
+        {
+            sum = sum + _sums[slot];
+        }
+        return sum;
+    }
+
+private:
+    std::vector<T> _sums;
+};
+
+// A position of the alignment of the children of before and after.
+struct Slot
+{
+    enum class Type
+    {
+        matched,
+        removed,
+        inserted,
+        moved_from,
+        moved_to
+    };
+
+    Type   type;
+    size_t before_index = 0;
+    size_t after_index  = 0;
+    size_t origin       = 0; // moved_to: the moved_from slot
+    Change change       = Change::none;
+};
+
+} // namespace
+
+std::vector<EditOperation>
+diff_children(
+    Composition const* before,
+    Composition const* after,
+    ErrorStatus*       error_status)
+{
+    std::vector<EditOperation> script;
+
+    auto const& before_children = before->children();
+    auto const& after_children  = after->children();
+
+    // hashing each side in one pass caches the hashes of all its children
+    before->content_hash(error_status);
+    after->content_hash(error_status);
+
+    std::vector<uint64_t> before_keys, after_keys;
+    before_keys.reserve(before_children.size());
+    for (auto const& child: before_children)
+    {
+        before_keys.push_back(match_key(child, error_status));
+    }
+    after_keys.reserve(after_children.size());
+    for (auto const& child: after_children)
+    {
+        after_keys.push_back(match_key(child, error_status));
+    }
+    if (is_error(error_status))
+    {
+        return script;
+    }
+
+    Matches matches;
+    match_range(
+        before_keys,
+        after_keys,
+        0,
+        before_keys.size(),
+        0,
+        after_keys.size(),
+        &matches);
+
+    // lay the matches out as an alignment, removals before insertions
+    std::vector<Slot> slots;
+    slots.reserve(before_children.size() + after_children.size());
+    matches.emplace_back(before_children.size(), after_children.size());
+    size_t i = 0, j = 0;
+    for (auto const& match: matches)
+    {
+        for (; i < match.first; ++i)
+        {
+            Slot slot{ Slot::Type::removed };
+            slot.before_index = i;
+            slots.push_back(slot);
+        }
+        for (; j < match.second; ++j)
+        {
+            Slot slot{ Slot::Type::inserted };
+            slot.after_index = j;
+            slots.push_back(slot);
+        }
+        if (i < before_children.size() && j < after_children.size())
+        {
+            Slot slot{ Slot::Type::matched };
+            slot.before_index = i++;
+            slot.after_index  = j++;
+            slot.change       = change_between(
+                before_children[slot.before_index],
+                after_children[slot.after_index],
+                error_status);
+            slots.push_back(slot);
+        }
+    }
+
+    // pair up removed and inserted children that are the same, or only
+    // differ in their source range, as moves (gaps are never moved)
+    std::unordered_map<uint64_t, std::vector<size_t>> removed_slots;
+    for (size_t s = 0; s < slots.size(); ++s)
+    {
+        if (slots[s].type == Slot::Type::removed
+            && !dynamic_cast<Gap const*>(
+                before_children[slots[s].before_index].value))
+        {
+            removed_slots[before_keys[slots[s].before_index]].push_back(s);
+        }
+    }
+    std::unordered_map<uint64_t, size_t> next_removed_slot;
+    for (size_t s = 0; s < slots.size() && !removed_slots.empty(); ++s)
+    {
+        if (slots[s].type != Slot::Type::inserted)
+        {
+            continue;
+        }
+        auto const key   = after_keys[slots[s].after_index];
+        auto       found = removed_slots.find(key);
+        if (found == removed_slots.end()
+            || next_removed_slot[key] == found->second.size())
+        {
+            continue;
+        }
+
+        const size_t origin = found->second[next_removed_slot[key]];
+        const Change change = change_between(
+            before_children[slots[origin].before_index],
+            after_children[slots[s].after_index],
+            error_status);
+        if (change != Change::other)
+        {
+            ++next_removed_slot[key];
+            slots[origin].type = Slot::Type::moved_from;
+            slots[s].type      = Slot::Type::moved_to;
+            slots[s].origin    = origin;
+            slots[s].change    = change;
+        }
+    }
+    if (is_error(error_status))
+    {
+        return script;
+    }
+
+    // Walk the alignment, keeping track of which slots hold a child and of
+    // their durations, to find the index and time of every operation.
+    const bool sequential = dynamic_cast<Stack const*>(before) == nullptr;
+    auto       duration_of = [sequential, error_status](Composable const* c) {
+        auto item = dynamic_cast<Item const*>(c);
+        return sequential && item ? item->trimmed_range(error_status).duration()
+                                  : RationalTime();
+    };
+
+    PrefixSums<int>          present(slots.size());
+    PrefixSums<RationalTime> durations(slots.size());
+    for (size_t s = 0; s < slots.size(); ++s)
+    {
+        if (slots[s].type != Slot::Type::inserted
+            && slots[s].type != Slot::Type::moved_to)
+        {
+            present.add(s, 1);
+            durations.add(
+                s,
+                duration_of(before_children[slots[s].before_index]));
+        }
+    }
+
+    auto operation = [&](EditOperation::Kind kind, size_t s) {
+        EditOperation op;
+        op.kind  = kind;
+        op.index = present.before(s);
+        op.time  = durations.before(s);
+        return op;
+    };
+    auto trim = [&](size_t s, Composable const* from, Composable const* to) {
+        auto from_range = dynamic_cast<Item const*>(from)->trimmed_range(
+            error_status);
+        auto to_range =
+            dynamic_cast<Item const*>(to)->trimmed_range(error_status);
+
+        EditOperation op = operation(EditOperation::Kind::trim, s);
+        op.delta_in      = to_range.start_time() - from_range.start_time();
+        op.delta_out =
+            to_range.end_time_exclusive() - from_range.end_time_exclusive();
+        op.source_range = dynamic_cast<Item const*>(to)->source_range();
+        op.child        = const_cast<Composable*>(from);
+        script.push_back(op);
+        durations.add(s, duration_of(to) - duration_of(from));
+    };
+
+    for (size_t s = 0; s < slots.size(); ++s)
+    {
+        auto const& slot = slots[s];
+        Composable* from = slot.type == Slot::Type::inserted
+                               ? nullptr
+                               : before_children[slot.before_index].value;
+        Composable* to = slot.type == Slot::Type::removed
+                                 || slot.type == Slot::Type::moved_from
+                             ? nullptr
+                             : after_children[slot.after_index].value;
+
+        switch (slot.type)
+        {
+            case Slot::Type::matched:
+                if (slot.change == Change::trim)
+                {
+                    trim(s, from, to);
+                }
+                else if (slot.change == Change::other)
+                {
+                    EditOperation op =
+                        operation(EditOperation::Kind::remove, s);
+                    op.child = from;
+                    script.push_back(op);
+                    durations.add(s, duration_of(to) - duration_of(from));
+
+                    op       = operation(EditOperation::Kind::insert, s);
+                    op.child = to;
+                    script.push_back(op);
+                }
+                break;
+            case Slot::Type::removed: {
+                EditOperation op = operation(EditOperation::Kind::remove, s);
+                op.child         = from;
+                script.push_back(op);
+                present.add(s, -1);
+                durations.add(s, RationalTime() - duration_of(from));
+                break;
+            }
+            case Slot::Type::inserted: {
+                EditOperation op = operation(EditOperation::Kind::insert, s);
+                op.child         = to;
+                script.push_back(op);
+                present.add(s, 1);
+                durations.add(s, duration_of(to));
+                break;
+            }
+            case Slot::Type::moved_from:
+                break;
+            case Slot::Type::moved_to: {
+                from = before_children[slots[slot.origin].before_index].value;
+                EditOperation op =
+                    operation(EditOperation::Kind::move, slot.origin);
+                op.child = from;
+                present.add(slot.origin, -1);
+                durations.add(slot.origin, RationalTime() - duration_of(from));
+                op.new_index = present.before(s);
+                op.new_time  = durations.before(s);
+                script.push_back(op);
+                present.add(s, 1);
+                durations.add(s, duration_of(from));
+                if (slot.change == Change::trim)
+                {
+                    trim(s, from, to);
+                }
+                break;
+            }
+        }
+    }
+
+    if (is_error(error_status))
+    {
+        script.clear();
+    }
+    return script;
+}
+
+std::vector<EditOperation>
+diff_timelines(
+    Timeline const* before,
+    Timeline const* after,
+    ErrorStatus*    error_status)
+{
+    std::vector<EditOperation> script;
+
+    auto const& before_tracks = before->tracks()->children();
+    auto const& after_tracks  = after->tracks()->children();
+    const size_t common = std::min(before_tracks.size(), after_tracks.size());
+    for (size_t t = 0; t < common; ++t)
+    {
+        auto before_track =
+            dynamic_cast<Composition const*>(before_tracks[t].value);
+        auto after_track =
+            dynamic_cast<Composition const*>(after_tracks[t].value);
+        if (!before_track || !after_track)
+        {
+            if (error_status)
+            {
+                *error_status = ErrorStatus(
+                    ErrorStatus::TYPE_MISMATCH,
+                    "timeline tracks must be compositions");
+            }
+            return {};
+        }
+
+        for (auto& op: diff_children(before_track, after_track, error_status))
+        {
+            op.track_index = int(t);
+            script.push_back(op);
+        }
+        if (is_error(error_status))
+        {
+            return {};
+        }
+    }
+
+    for (size_t t = before_tracks.size(); t-- > common;)
+    {
+        EditOperation op;
+        op.kind        = EditOperation::Kind::remove;
+        op.track_index = -1;
+        op.index       = int(t);
+        op.child       = before_tracks[t];
+        script.push_back(op);
+    }
+    for (size_t t = common; t < after_tracks.size(); ++t)
+    {
+        EditOperation op;
+        op.kind        = EditOperation::Kind::insert;
+        op.track_index = -1;
+        op.index       = int(t);
+        op.child       = after_tracks[t];
+        script.push_back(op);
+    }
+    return script;
+}
+
+static bool
+apply_edit_operation(
+    Composition*         composition,
+    EditOperation const& op,
+    ErrorStatus*         error_status)
+{
+    const int size = int(composition->children().size());
+    const int limit =
+        op.kind == EditOperation::Kind::insert ? size + 1 : size;
+    if (op.index < 0 || op.index >= limit
+        || (op.kind == EditOperation::Kind::move
+            && (op.new_index < 0 || op.new_index >= size)))
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus::ILLEGAL_INDEX;
+        }
+        return false;
+    }
+
+    switch (op.kind)
+    {
+        case EditOperation::Kind::insert: {
+            SerializableObject::Retainer<Composable> child(
+                op.child ? dynamic_cast<Composable*>(
+                    op.child.value->clone(error_status))
+                         : nullptr);
+            if (!child)
+            {
+                if (error_status && !is_error(error_status))
+                {
+                    *error_status = ErrorStatus::NOT_A_CHILD;
+                }
+                return false;
+            }
+            return composition->insert_child(op.index, child, error_status);
+        }
+        case EditOperation::Kind::remove:
+            return composition->remove_child(op.index, error_status);
+        case EditOperation::Kind::trim: {
+            auto item = dynamic_cast<Item*>(
+                composition->children()[op.index].value);
+            if (!item)
+            {
+                if (error_status)
+                {
+                    *error_status = ErrorStatus::NOT_AN_ITEM;
+                }
+                return false;
+            }
+            item->set_source_range(op.source_range);
+            return true;
+        }
+        case EditOperation::Kind::move: {
+            SerializableObject::Retainer<Composable> child =
+                composition->children()[op.index];
+            return composition->remove_child(op.index, error_status)
+                   && composition->insert_child(
+                       op.new_index,
+                       child,
+                       error_status);
+        }
+    }
+    return false;
+}
+
+bool
+apply_edit_script(
+    Composition*                      composition,
+    std::vector<EditOperation> const& script,
+    ErrorStatus*                      error_status)
+{
+    for (auto const& op: script)
+    {
+        if (!apply_edit_operation(composition, op, error_status))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+apply_edit_script(
+    Timeline*                         timeline,
+    std::vector<EditOperation> const& script,
+    ErrorStatus*                      error_status)
+{
+    auto stack = timeline->tracks();
+    for (auto const& op: script)
+    {
+        Composition* composition = stack;
+        if (op.track_index >= 0)
+        {
+            composition =
+                op.track_index < int(stack->children().size())
+                    ? dynamic_cast<Composition*>(
+                        stack->children()[op.track_index].value)
+                    : nullptr;
+            if (!composition)
+            {
+                if (error_status)
+                {
+                    *error_status = ErrorStatus::ILLEGAL_INDEX;
+                }
+                return false;
+            }
+        }
+        if (!apply_edit_operation(composition, op, error_status))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}}} // namespace opentimelineio::OPENTIMELINEIO_VERSION::algo
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentimelineio/composition.h"
+#include "opentimelineio/timeline.h"
+
+#include <optional>
+#include <vector>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION { namespace algo {
+
+// A single step of an edit script, as computed by diff_children() or
+// diff_timelines().
+//
+// The steps of a script are applied in order, and the indices and times of
+// each step refer to the composition as left by the steps before it.  The
+// times are those of the corresponding editAlgorithm calls:
+//
+//   insert = algo::insert(child, composition, time), at a child boundary
+//   remove = algo::remove(composition, time, false)
+//     trim = the delta_in / delta_out of algo::trim, without adjusting
+//            the neighbouring children
+//     move = a remove at time followed by an insert at new_time
+//
+struct EditOperation
+{
+    enum class Kind
+    {
+        insert,
+        remove,
+        trim,
+        move
+    };
+
+    Kind kind = Kind::insert;
+
+    // Index of the track in the timeline's stack, or -1 for operations that
+    // insert or remove whole tracks.  Ignored when the script is applied to
+    // a single composition.
+    int track_index = 0;
+
+    // Index and start time of the child.
+    int          index = 0;
+    RationalTime time;
+
+    // move: index and start time of the child once moved, counted without
+    // the child itself.
+    int          new_index = 0;
+    RationalTime new_time;
+
+    // trim: how the child's start and end are adjusted, and the child's new
+    // source range.
+    RationalTime             delta_in;
+    RationalTime             delta_out;
+    std::optional<TimeRange> source_range;
+
+    // insert: the child to insert (a clone of it is inserted).
+    // otherwise: the child in the original composition.
+    SerializableObject::Retainer<Composable> child;
+};
+
+// Compute the edit script that turns the children of before into the
+// children of after.
+//
+// Children are matched by schema, name and media (the content of a clip's
+// active media reference), first on the children whose match is unique on
+// both sides, and then between those anchors.  Matched children that only
+// differ in their source range are trimmed, and unmatched children that
+// reappear elsewhere are moved; all others are removed or inserted.
+// Nested compositions are compared as a whole.
+//
+// Times are the children's start times in a track, or zero in a stack.
+std::vector<EditOperation> diff_children(
+    Composition const* before,
+    Composition const* after,
+    ErrorStatus*       error_status = nullptr);
+
+// Compute the edit script that turns the tracks of before into the tracks
+// of after.
+//
+// Tracks are paired by their index in the timeline's stack, and diffed
+// with diff_children().  Tracks beyond those are removed from, or inserted
+// into, the stack at the end of the script.
+std::vector<EditOperation> diff_timelines(
+    Timeline const* before,
+    Timeline const* after,
+    ErrorStatus*    error_status = nullptr);
+
+// Apply an edit script computed by diff_children() to a composition.
+//
+// Applying the script of diff_children(before, after) to before (or to a
+// clone of it) leaves it equivalent to after.
+bool apply_edit_script(
+    Composition*                      composition,
+    std::vector<EditOperation> const& script,
+    ErrorStatus*                      error_status = nullptr);
+
+// Apply an edit script computed by diff_timelines() to a timeline.
+bool apply_edit_script(
+    Timeline*                         timeline,
+    std::vector<EditOperation> const& script,
+    ErrorStatus*                      error_status = nullptr);
+
+}}} // namespace opentimelineio::OPENTIMELINEIO_VERSION::algo
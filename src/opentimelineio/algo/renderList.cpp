@@ -0,0 +1,462 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "opentimelineio/algo/renderList.h"
+
+#include "opentimelineio/stack.h"
+#include "opentimelineio/track.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION { namespace algo {
+
+namespace
+{
+
+// Frame positions are rounded with this tolerance, in frames, so that a
+// range which ends on a frame doesn't take that frame through rounding.
+constexpr double frame_epsilon = 1e-6;
+
+// Output frames [start, end).
+struct Frames
+{
+    int64_t start = 0;
+    int64_t end   = 0;
+
+    bool empty() const noexcept { return start >= end; }
+};
+
+// The frames of a clip, or of part of it, and the transform from the time
+// of the tracks to the time of the clip.
+struct Layer
+{
+    Frames            frames;
+    Clip const*       clip       = nullptr;
+    Transition const* transition = nullptr;
+    TimeTransform     transform;
+};
+
+// The layers of an item, in order of their frames, which don't overlap.
+using Layers = std::vector<Layer>;
+
+class Sampler
+{
+public:
+    Sampler(TimeRange const& range, double rate)
+        : _origin_s(range.start_time().to_seconds())
+        , _rate(rate)
+    {
+        const double count =
+            first_frame_at(range.end_time_exclusive().to_seconds());
+        _count = count > 0 ? int64_t(count) : 0;
+    }
+
+    int64_t count() const noexcept { return _count; }
+
+    // The first frame sampled at or after the given time, in seconds.
+    double first_frame_at(double seconds) const noexcept
+    {
+        return std::ceil((seconds - _origin_s) * _rate - frame_epsilon);
+    }
+
+    // The frames sampled inside a range of the parent of an item, given
+    // the transform from the time of the tracks to the time of the parent,
+    // and the frames of the parent.
+    Frames frames_of(
+        TimeRange const&     range_in_parent,
+        TimeTransform const& to_parent,
+        Frames const&        window) const noexcept
+    {
+        const double scale    = to_parent.scale();
+        const double offset_s = to_parent.offset().to_seconds();
+        const double start_s  = range_in_parent.start_time().to_seconds();
+        const double end_s =
+            range_in_parent.end_time_exclusive().to_seconds();
+
+        // a freeze frame holds one time of the parent for all of its frames
+        if (scale == 0)
+        {
+            return start_s <= offset_s && offset_s < end_s ? window
+                                                           : Frames();
+        }
+
+        double first = first_frame_at((start_s - offset_s) / scale);
+        double last  = first_frame_at((end_s - offset_s) / scale);
+        if (scale < 0)
+        {
+            std::swap(first, last);
+        }
+        if (std::isnan(first) || std::isnan(last))
+        {
+            return Frames();
+        }
+        const double lowest  = double(window.start);
+        const double highest = double(window.end);
+        return Frames{ int64_t(std::clamp(first, lowest, highest)),
+                       int64_t(std::clamp(last, lowest, highest)) };
+    }
+
+private:
+    double  _origin_s;
+    double  _rate;
+    int64_t _count = 0;
+};
+
+Layer
+part_of(Layer const& layer, int64_t start, int64_t end)
+{
+    Layer part  = layer;
+    part.frames = Frames{ start, end };
+    return part;
+}
+
+bool
+starts_before(Layer const& lhs, Layer const& rhs)
+{
+    return lhs.frames.start < rhs.frames.start;
+}
+
+// Return the top layers over the bottom layers.
+Layers
+overlay(Layers const& bottom, Layers const& top)
+{
+    if (top.empty())
+    {
+        return bottom;
+    }
+
+    // the parts of the bottom layers that no top layer covers
+    Layers uncovered;
+    size_t cover = 0;
+    for (const auto& layer: bottom)
+    {
+        int64_t start = layer.frames.start;
+        while (cover < top.size() && top[cover].frames.end <= start)
+        {
+            ++cover;
+        }
+        for (size_t i = cover;
+             i < top.size() && top[i].frames.start < layer.frames.end;
+             ++i)
+        {
+            if (top[i].frames.start > start)
+            {
+                uncovered.push_back(
+                    part_of(layer, start, top[i].frames.start));
+            }
+            start = std::max(start, top[i].frames.end);
+        }
+        if (start < layer.frames.end)
+        {
+            uncovered.push_back(part_of(layer, start, layer.frames.end));
+        }
+    }
+
+    Layers result(uncovered.size() + top.size());
+    std::merge(
+        uncovered.begin(),
+        uncovered.end(),
+        top.begin(),
+        top.end(),
+        result.begin(),
+        starts_before);
+    return result;
+}
+
+// Split the layers of a track at the frames of its transitions, and mark
+// the parts inside them.  Both are in order, and don't overlap.
+Layers
+split_at_transitions(
+    Layers const&                                          layers,
+    std::vector<std::pair<Frames, Transition const*>> const& transitions)
+{
+    if (transitions.empty())
+    {
+        return layers;
+    }
+
+    Layers result;
+    result.reserve(layers.size() + 2 * transitions.size());
+    size_t next = 0;
+    for (const auto& layer: layers)
+    {
+        int64_t start = layer.frames.start;
+        while (start < layer.frames.end)
+        {
+            while (next < transitions.size()
+                   && transitions[next].first.end <= start)
+            {
+                ++next;
+            }
+            if (next == transitions.size()
+                || transitions[next].first.start >= layer.frames.end)
+            {
+                result.push_back(part_of(layer, start, layer.frames.end));
+                break;
+            }
+
+            const Frames& frames = transitions[next].first;
+            if (frames.start > start)
+            {
+                result.push_back(part_of(layer, start, frames.start));
+                start = frames.start;
+            }
+            const int64_t end = std::min(layer.frames.end, frames.end);
+            result.push_back(part_of(layer, start, end));
+            if (!result.back().transition)
+            {
+                result.back().transition = transitions[next].second;
+            }
+            start = end;
+        }
+    }
+    return result;
+}
+
+// Add the layers of an item within the given frames.
+void
+add_layers(
+    Timeline const* timeline,
+    Item const*     item,
+    Frames const&   window,
+    Sampler const&  sampler,
+    Layers&         layers,
+    ErrorStatus*    error_status)
+{
+    if (!item->visible())
+    {
+        return;
+    }
+
+    if (auto clip = dynamic_cast<Clip const*>(item))
+    {
+        const TimeTransform transform =
+            timeline->media_time_transform(clip, error_status);
+        if (!is_error(error_status))
+        {
+            layers.push_back({ window, clip, nullptr, transform });
+        }
+        return;
+    }
+
+    auto composition = dynamic_cast<Composition const*>(item);
+    if (!composition || composition->children().empty())
+    {
+        return;
+    }
+
+    const TimeTransform to_composition =
+        timeline->media_time_transform(composition, error_status);
+    if (is_error(error_status))
+    {
+        return;
+    }
+    const auto ranges = composition->range_of_all_children(error_status);
+    if (is_error(error_status))
+    {
+        return;
+    }
+
+    // the children of a track follow each other, and the children of any
+    // other composition are layered, with the later ones on top
+    const bool track = dynamic_cast<Track const*>(composition) != nullptr;
+    std::vector<std::pair<Frames, Transition const*>> transitions;
+    Layers                                            own_layers;
+    if (track)
+    {
+        own_layers.reserve(composition->children().size());
+    }
+    for (const auto& child: composition->children())
+    {
+        auto range = ranges.find(child.value);
+        if (range == ranges.end())
+        {
+            continue;
+        }
+
+        const Frames frames =
+            sampler.frames_of(range->second, to_composition, window);
+        if (frames.empty())
+        {
+            continue;
+        }
+
+        if (auto transition = dynamic_cast<Transition const*>(child.value))
+        {
+            if (track)
+            {
+                transitions.emplace_back(frames, transition);
+            }
+        }
+        else if (auto child_item = dynamic_cast<Item const*>(child.value))
+        {
+            if (track)
+            {
+                add_layers(
+                    timeline,
+                    child_item,
+                    frames,
+                    sampler,
+                    own_layers,
+                    error_status);
+            }
+            else
+            {
+                Layers child_layers;
+                add_layers(
+                    timeline,
+                    child_item,
+                    frames,
+                    sampler,
+                    child_layers,
+                    error_status);
+                own_layers = overlay(own_layers, child_layers);
+            }
+            if (is_error(error_status))
+            {
+                return;
+            }
+        }
+    }
+
+    if (track)
+    {
+        // a track that plays backwards has its children in reverse
+        if (!std::is_sorted(
+                own_layers.begin(),
+                own_layers.end(),
+                starts_before))
+        {
+            std::sort(own_layers.begin(), own_layers.end(), starts_before);
+        }
+        auto frames_before = [](auto const& lhs, auto const& rhs) {
+            return lhs.first.start < rhs.first.start;
+        };
+        if (!std::is_sorted(
+                transitions.begin(),
+                transitions.end(),
+                frames_before))
+        {
+            std::sort(transitions.begin(), transitions.end(), frames_before);
+        }
+        own_layers = split_at_transitions(own_layers, transitions);
+    }
+
+    // the layers of the composition lie within its frames, after any that
+    // are already there
+    if (layers.empty())
+    {
+        layers = std::move(own_layers);
+    }
+    else
+    {
+        layers.insert(layers.end(), own_layers.begin(), own_layers.end());
+    }
+}
+
+} // namespace
+
+std::vector<RenderSegment>
+render_list(
+    Timeline const*                 timeline,
+    double                          rate,
+    std::optional<TimeRange> const& range,
+    ErrorStatus*                    error_status)
+{
+    std::vector<RenderSegment> result;
+    if (!(rate > 0) || std::isinf(rate))
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::INVALID_TIME_RANGE,
+                "Rate must be positive");
+        }
+        return result;
+    }
+
+    // the layers are computed with a status of their own, so that an error
+    // stops the walk even if the caller doesn't ask for the status
+    ErrorStatus  status;
+    Stack const* tracks = timeline->tracks();
+    const TimeRange rendered_range =
+        range ? *range : tracks->trimmed_range(&status);
+    if (is_error(status))
+    {
+        if (error_status)
+        {
+            *error_status = status;
+        }
+        return result;
+    }
+
+    const Sampler sampler(rendered_range, rate);
+    Layers        layers;
+    add_layers(
+        timeline,
+        tracks,
+        Frames{ 0, sampler.count() },
+        sampler,
+        layers,
+        &status);
+    if (is_error(status))
+    {
+        if (error_status)
+        {
+            *error_status = status;
+        }
+        return result;
+    }
+
+    // fill the frames without a clip, and join the parts of a layer that
+    // were split but are next to each other again
+    Layers  joined;
+    int64_t frame = 0;
+    joined.reserve(layers.size());
+    for (const auto& layer: layers)
+    {
+        if (layer.frames.start > frame)
+        {
+            joined.push_back(part_of(Layer(), frame, layer.frames.start));
+        }
+        if (!joined.empty() && joined.back().frames.end == layer.frames.start
+            && joined.back().clip == layer.clip
+            && joined.back().transition == layer.transition
+            && joined.back().transform == layer.transform)
+        {
+            joined.back().frames.end = layer.frames.end;
+        }
+        else
+        {
+            joined.push_back(layer);
+        }
+        frame = layer.frames.end;
+    }
+    if (frame < sampler.count())
+    {
+        joined.push_back(part_of(Layer(), frame, sampler.count()));
+    }
+
+    result.reserve(joined.size());
+    for (const auto& layer: joined)
+    {
+        RenderSegment segment;
+        segment.start_frame = layer.frames.start;
+        segment.end_frame   = layer.frames.end;
+        if (layer.clip)
+        {
+            segment.clip            = layer.clip;
+            segment.media_reference = layer.clip->media_reference();
+            segment.transition      = layer.transition;
+            segment.source_start    = layer.transform.applied_to(
+                rendered_range.start_time()
+                + RationalTime(double(layer.frames.start), rate));
+            segment.time_scale = layer.transform.scale();
+        }
+        result.push_back(std::move(segment));
+    }
+    return result;
+}
+
+}}} // namespace opentimelineio::OPENTIMELINEIO_VERSION::algo
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentimelineio/clip.h"
+#include "opentimelineio/timeline.h"
+#include "opentimelineio/transition.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION { namespace algo {
+
+// A run of output frames that show the same media, as computed by
+// render_list().
+struct RenderSegment
+{
+    // The output frames [start_frame, end_frame), counted from the start of
+    // the rendered range.
+    int64_t start_frame = 0;
+    int64_t end_frame   = 0;
+
+    // The top visible clip and its active media reference, or null where
+    // no clip is visible.
+    SerializableObject::Retainer<Clip>           clip;
+    SerializableObject::Retainer<MediaReference> media_reference;
+
+    // The transition the frames are in, if any.  The clip is the one on
+    // the same side of the cut as the frames; the clip on the other side is
+    // in the neighbouring segment.
+    SerializableObject::Retainer<Transition> transition;
+
+    // The media time of start_frame, and the media time that passes for
+    // each unit of output time, so that the media time of frame f is
+    //
+    //   source_start + RationalTime((f - start_frame) * time_scale, rate)
+    //
+    // for the output rate.  The time scale is the product of the time
+    // scalars of the linear time warps above the clip, and zero for a
+    // freeze frame.
+    RationalTime source_start;
+    double       time_scale = 1;
+};
+
+// Compute the top visible clip for every output frame of a timeline, as
+// runs of frames.
+//
+// Output frame f is sampled at range.start_time() + RationalTime(f, rate),
+// in the time of the timeline's tracks, and the range defaults to the
+// trimmed range of the tracks.  The frames of an item are the ones sampled
+// inside its range in its parent, within the visible part of its parent.
+// Items that are not visible (gaps, and items that are not enabled) show
+// what is below them; in a stack the later children are on top.
+//
+// The timeline is walked once, and the frames of each clip are computed as
+// a whole, so the cost does not depend on the number of frames.  The media
+// times come from Timeline::media_time_transform(), and a clip under a
+// time effect that isn't linear is an error (NOT_IMPLEMENTED).
+std::vector<RenderSegment> render_list(
+    Timeline const*                 timeline,
+    double                          rate,
+    std::optional<TimeRange> const& range        = std::nullopt,
+    ErrorStatus*                    error_status = nullptr);
+
+}}} // namespace opentimelineio::OPENTIMELINEIO_VERSION::algo
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentimelineio/version.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
+
+/*
+ * Layout of the OTIO binary format:
+ *
+ *   header   "OTIOBIN\0", uint32 format version
+ *   body     the root value
+ *   strings  varint count, then each string as varint length + bytes
+ *   index    varint count, then a uint64 position (from the start of the
+ *            index) for each entry, then the entries in order of their
+ *            subtree paths: the path (varint length + bytes) and the
+ *            uint64 offset of the object
+ *   trailer  uint64 offset of strings, uint64 offset of index (0 if there
+ *            is none), "OTIOBIN\0"
+ *
+ * Every value starts with a one byte tag.  Objects and arrays are records
+ * whose tag is followed by their byte length (uint32, counting everything
+ * after the length itself), so they can be skipped without decoding them.
+ * Object keys and schema names are varint indices into the string table.
+ * Integers are written as (zigzag) varints, everything else little endian.
+ *
+ * Subtree paths name objects by "/" separated components, starting at the
+ * root: "tracks" is the value of a "tracks" key (a timeline's stack), and a
+ * number is an index into the "children" array of a track, stack or
+ * serializable collection.  So "tracks/3/0" is the first child of the
+ * fourth track of a timeline, and the root itself has the empty path.
+ * Paths are ordered by their bytes, so that a path is found by a binary
+ * search over the positions of the entries.  (Version 1 of the format had
+ * the entries unordered, without their positions.)
+ *
+ * This header is private to the library.
+ */
+namespace binary_format {
+
+constexpr char     magic[8]     = { 'O', 'T', 'I', 'O', 'B', 'I', 'N', '\0' };
+constexpr uint32_t version      = 2;
+constexpr size_t   header_size  = 12;
+constexpr size_t   trailer_size = 24;
+
+enum Tag : uint8_t
+{
+    null_tag = 0,
+    false_tag,
+    true_tag,
+    int64_tag,
+    uint64_tag,
+    double_tag,
+    string_tag,
+    string_ref_tag,
+    rational_time_tag,
+    time_range_tag,
+    time_transform_tag,
+    color_tag,
+    reference_tag,
+    v2d_tag,
+    box2d_tag,
+    array_tag,
+    object_tag
+};
+
+inline void
+put_u32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out.push_back(char((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void
+patch_u32(std::string& out, size_t offset, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out[offset + i] = char((value >> (8 * i)) & 0xff);
+    }
+}
+
+inline void
+put_u64(std::string& out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        out.push_back(char((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void
+patch_u64(std::string& out, size_t offset, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        out[offset + i] = char((value >> (8 * i)) & 0xff);
+    }
+}
+
+inline void
+put_varint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+inline void
+put_zigzag(std::string& out, int64_t value)
+{
+    put_varint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+inline void
+put_double(std::string& out, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u64(out, bits);
+}
+
+inline void
+put_bytes(std::string& out, std::string const& value)
+{
+    put_varint(out, value.size());
+    out.append(value);
+}
+
+/// Bounds checked reading of a binary buffer.  Once a read runs past the
+/// end, ok() returns false and all further reads return zeros.
+class Cursor
+{
+public:
+    Cursor(char const* begin, char const* end)
+        : _begin(begin)
+        , _pos(begin)
+        , _end(end)
+    {}
+
+    bool ok() const noexcept { return _ok; }
+
+    size_t offset() const noexcept { return size_t(_pos - _begin); }
+
+    char const* position() const noexcept { return _pos; }
+
+    bool at_end() const noexcept { return _pos >= _end; }
+
+    size_t remaining() const noexcept { return size_t(_end - _pos); }
+
+    bool seek(size_t offset)
+    {
+        if (offset > size_t(_end - _begin))
+        {
+            return _ok = false;
+        }
+        _pos = _begin + offset;
+        return true;
+    }
+
+    bool skip(size_t count)
+    {
+        if (count > size_t(_end - _pos))
+        {
+            return _ok = false;
+        }
+        _pos += count;
+        return true;
+    }
+
+    uint8_t get_u8()
+    {
+        return skip(1) ? uint8_t(_pos[-1]) : 0;
+    }
+
+    uint32_t get_u32()
+    {
+        uint32_t value = 0;
+        if (skip(4))
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                value |= uint32_t(uint8_t(_pos[i - 4])) << (8 * i);
+            }
+        }
+        return value;
+    }
+
+    uint64_t get_u64()
+    {
+        uint64_t value = 0;
+        if (skip(8))
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                value |= uint64_t(uint8_t(_pos[i - 8])) << (8 * i);
+            }
+        }
+        return value;
+    }
+
+    uint64_t get_varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64 && skip(1); shift += 7)
+        {
+            uint8_t byte = uint8_t(_pos[-1]);
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        _ok = false;
+        return 0;
+    }
+
+    int64_t get_zigzag()
+    {
+        uint64_t value = get_varint();
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+
+    double get_double()
+    {
+        uint64_t bits = get_u64();
+        double   value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /// Return a pointer to the next count bytes, and skip them.
+    char const* get_bytes(size_t count)
+    {
+        char const* start = _pos;
+        return skip(count) ? start : nullptr;
+    }
+
+private:
+    char const* _begin;
+    char const* _pos;
+    char const* _end;
+    bool        _ok = true;
+};
+
+} // namespace binary_format
+
+}} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -24,7 +24,12 @@ Clip::Clip(
 }
 
 Clip::~Clip()
-{}
+{
+    for (auto const& m: _media_references)
+    {
+        _unlink_held(m.second);
+    }
+}
 
 MediaReference*
 Clip::media_reference() const noexcept
@@ -91,6 +96,7 @@ Clip::set_media_references(
     std::string const&     new_active_key,
     ErrorStatus*           error_status) noexcept
 {
+    mark_modified();
     if (!check_for_valid_media_reference_key(
             "set_media_references",
             new_active_key,
@@ -100,10 +106,15 @@ Clip::set_media_references(
         return;
     }
 
+    for (auto const& m: _media_references)
+    {
+        _unlink_held(m.second);
+    }
     _media_references.clear();
     for (auto const& m: media_references)
     {
         _media_references[m.first] = m.second ? m.second : new MissingReference;
+        _link_held(_media_references[m.first]);
     }
 
     _active_media_reference_key = new_active_key;
@@ -120,6 +131,7 @@ Clip::set_active_media_reference_key(
     std::string const& new_active_key,
     ErrorStatus*       error_status) noexcept
 {
+    mark_modified();
     if (!check_for_valid_media_reference_key(
             "set_active_media_reference_key",
             new_active_key,
@@ -134,15 +146,32 @@ Clip::set_active_media_reference_key(
 void
 Clip::set_media_reference(MediaReference* media_reference)
 {
-    _media_references[_active_media_reference_key] =
-        media_reference ? media_reference : new MissingReference;
+    mark_modified();
+    auto& active = _media_references[_active_media_reference_key];
+    if (active != media_reference || !active)
+    {
+        _unlink_held(active);
+        active = media_reference ? media_reference : new MissingReference;
+        _link_held(active);
+    }
 }
 
 bool
 Clip::read_from(Reader& reader)
 {
-    return reader.read("media_references", &_media_references)
-           && reader.read(
+    for (auto const& m: _media_references)
+    {
+        _unlink_held(m.second);
+    }
+    if (!reader.read("media_references", &_media_references))
+    {
+        return false;
+    }
+    for (auto const& m: _media_references)
+    {
+        _link_held(m.second);
+    }
+    return reader.read(
                "active_media_reference_key",
                &_active_media_reference_key)
            && Parent::read_from(reader);
@@ -156,6 +185,26 @@ Clip::write_to(Writer& writer) const
     writer.write("active_media_reference_key", _active_media_reference_key);
 }
 
+bool
+Clip::_writes_downgraded(int schema_version) const
+{
+    // subclasses registered under schemas of their own have their own layout
+    return schema_version == 1 && schema_name() == Schema::name;
+}
+
+void
+Clip::_write_downgraded_to(Writer& writer, int) const
+{
+    // Clip.1 held just the active media reference (see the Clip 2->1
+    // downgrade function)
+    Parent::write_to(writer);
+    auto active = _media_references.find(_active_media_reference_key);
+    if (active != _media_references.end() && active->second)
+    {
+        writer.write("media_reference", active->second);
+    }
+}
+
 TimeRange
 Clip::available_range(ErrorStatus* error_status) const
 {
@@ -223,4 +272,58 @@ Clip::available_image_bounds(ErrorStatus* error_status) const
     return active_media->available_image_bounds();
 }
 
+void
+Clip::_held_objects(std::vector<SerializableObject*>& held) const
+{
+    Parent::_held_objects(held);
+    for (auto const& m: _media_references)
+    {
+        held.push_back(m.second.value);
+    }
+}
+
+SerializableObject*
+Clip::_clone_instance() const
+{
+    return new Clip;
+}
+
+bool
+Clip::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& clip = static_cast<Clip const&>(source);
+    for (auto const& m: _media_references)
+    {
+        _unlink_held(m.second);
+    }
+    _media_references.clear();
+    for (auto const& e: clip._media_references)
+    {
+        if (!cloner.clone(e.second, &_media_references[e.first]))
+        {
+            return false;
+        }
+        _link_held(_media_references[e.first]);
+    }
+    _active_media_reference_key = clip._active_media_reference_key;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Clip::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& clip = static_cast<Clip const&>(other);
+    return comparer.equivalent(
+               "active_media_reference_key",
+               _active_media_reference_key,
+               clip._active_media_reference_key)
+           && Parent::_fields_equivalent_to(other, comparer)
+           && comparer.equivalent(
+               "media_references",
+               _media_references,
+               clip._media_references);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
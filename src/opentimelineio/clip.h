@@ -93,6 +93,16 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _held_objects(std::vector<SerializableObject*>&) const override;
+
+    bool _writes_downgraded(int schema_version) const override;
+    void _write_downgraded_to(Writer&, int schema_version) const override;
+
 private:
     template <typename MediaRefMap>
     bool check_for_valid_media_reference_key(
@@ -34,7 +34,15 @@ Composable::_set_parent(Composition* new_parent) noexcept
         return false;
     }
 
+    if (_parent)
+    {
+        _parent->_unlink_held(this);
+    }
     _parent = new_parent;
+    if (_parent)
+    {
+        _parent->_link_held(this);
+    }
     return true;
 }
 
@@ -81,4 +89,10 @@ Composable::available_image_bounds(ErrorStatus* error_status) const
     return std::optional<IMATH_NAMESPACE::Box2d>();
 }
 
+SerializableObject*
+Composable::_clone_instance() const
+{
+    return new Composable;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -63,6 +63,8 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+
 private:
     Composition* _parent;
     friend class Composition;
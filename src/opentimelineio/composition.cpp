@@ -35,6 +35,7 @@ Composition::composition_kind() const
 void
 Composition::clear_children()
 {
+    mark_modified();
     for (Composable* child: _children)
     {
         child->_set_parent(nullptr);
@@ -49,6 +50,7 @@ Composition::set_children(
     std::vector<Composable*> const& children,
     ErrorStatus*                    error_status)
 {
+    mark_modified();
     for (auto child: children)
     {
         if (child->parent())
@@ -77,6 +79,7 @@ Composition::insert_child(
     Composable*  child,
     ErrorStatus* error_status)
 {
+    mark_modified();
     if (child->parent())
     {
         if (error_status)
@@ -105,6 +108,7 @@ Composition::insert_child(
 bool
 Composition::set_child(int index, Composable* child, ErrorStatus* error_status)
 {
+    mark_modified();
     index = adjusted_vector_index(index, _children);
     if (index < 0 || index >= int(_children.size()))
     {
@@ -138,6 +142,7 @@ Composition::set_child(int index, Composable* child, ErrorStatus* error_status)
 bool
 Composition::remove_child(int index, ErrorStatus* error_status)
 {
+    mark_modified();
     if (_children.empty())
     {
         if (error_status)
@@ -719,4 +724,59 @@ Composition::find_clips(
     return find_children<Clip>(error_status, search_range, shallow_search);
 }
 
+void
+Composition::_held_objects(std::vector<SerializableObject*>& held) const
+{
+    Parent::_held_objects(held);
+    for (auto const& child: _children)
+    {
+        held.push_back(child.value);
+    }
+}
+
+SerializableObject*
+Composition::_clone_instance() const
+{
+    return new Composition;
+}
+
+bool
+Composition::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& composition = static_cast<Composition const&>(source);
+
+    decltype(_children) children;
+    if (!cloner.clone(composition._children, &children))
+    {
+        return false;
+    }
+
+    for (Composable* child: children)
+    {
+        if (!child->_set_parent(this))
+        {
+            cloner.error(ErrorStatus::CHILD_ALREADY_PARENTED);
+            return false;
+        }
+        _child_set.insert(child);
+    }
+    _children.swap(children);
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Composition::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& composition = static_cast<Composition const&>(other);
+    return Parent::_fields_equivalent_to(other, comparer)
+           && comparer.equivalent(
+               "children",
+               _children,
+               composition._children);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -178,6 +178,13 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _held_objects(std::vector<SerializableObject*>&) const override;
+
     std::vector<Composition*> _path_from_child(
         Composable const* child,
         ErrorStatus*      error_status = nullptr) const;
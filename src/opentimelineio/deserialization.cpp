@@ -1,18 +1,31 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright Contributors to the OpenTimelineIO project
 
+#include "binaryFormat.h"
+#include "exactSum.h"
 #include "opentime/rationalTime.h"
 #include "opentime/timeRange.h"
 #include "opentime/timeTransform.h"
 #include "opentimelineio/color.h"
+#include "opentimelineio/deserialization.h"
+#include "opentimelineio/item.h"
 #include "opentimelineio/serializableObject.h"
 #include "opentimelineio/serializableObjectWithMetadata.h"
+#include "opentimelineio/transition.h"
 #include "stringUtils.h"
 
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
 #define RAPIDJSON_NAMESPACE OTIO_rapidjson
 #include <rapidjson/cursorstreamwrapper.h>
 #include <rapidjson/error/en.h>
 #include <rapidjson/filereadstream.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/reader.h>
 
 #if defined(_WINDOWS)
@@ -23,6 +36,11 @@
 #        define NOMINMAX
 #    endif // NOMINMAX
 #    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
 #endif
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
@@ -57,6 +75,10 @@ public:
         }
     }
 
+    // Drop what the resolver holds without reading it in, after decoding
+    // failed part way and left objects that are incomplete.
+    void discard() { _resolver.clear(); }
+
     bool Null() { return store(std::any()); }
     bool Bool(bool b) { return store(std::any(b)); }
 
@@ -86,6 +108,17 @@ public:
             return false;
         }
 
+        if (_lazy_depth)
+        {
+            if (length == 11
+                && (memcmp(str, "OTIO_SCHEMA", 11) == 0
+                    || memcmp(str, "OTIO_REF_ID", 11) == 0))
+            {
+                _lazy_has_schema = true;
+            }
+            return true;
+        }
+
         if (_stack.empty() || !_stack.back().is_dict)
         {
             _internal_error(
@@ -93,7 +126,27 @@ public:
             return false;
         }
 
-        _stack.back().cur_key = std::string(str, length);
+        auto& top   = _stack.back();
+        top.cur_key = std::string(str, length);
+        if (top.key_renames)
+        {
+            auto renamed = top.key_renames->find(top.cur_key);
+            if (renamed != top.key_renames->end())
+            {
+                top.cur_key = renamed->second;
+            }
+        }
+
+        /*
+         * In lazy metadata mode, the metadata of schema objects is skipped
+         * over rather than decoded, see StartObject() and EndObject().
+         */
+        if (_lazy_buffer && _stack.back().cur_key == "metadata"
+            && _stack.back().dict.count("OTIO_SCHEMA"))
+        {
+            _lazy_pending = true;
+            _lazy_start   = _offset_function();
+        }
         return true;
     }
 
@@ -104,7 +157,28 @@ public:
             return false;
         }
 
+        _lazy_pending = false;
+        if (_lazy_depth)
+        {
+            return true;
+        }
+
+        std::string parent_schema_name;
+        bool        streamed = _stream_callback && !_stack.empty()
+                        && _is_composition_children(
+                            _stack.back(),
+                            &parent_schema_name);
+
         _stack.emplace_back(_DictOrArray{ false /* is_dict*/ });
+
+        if (streamed)
+        {
+            auto& top               = _stack.back();
+            top.streamed            = true;
+            top.parent_schema_name  = parent_schema_name;
+            top.parent_name         = _parent_name(_stack[_stack.size() - 2]);
+            top.depth               = _stream_depth++;
+        }
         return true;
     }
 
@@ -115,6 +189,14 @@ public:
             return false;
         }
 
+        if (_lazy_depth || _lazy_pending)
+        {
+            _lazy_has_schema = _lazy_depth ? _lazy_has_schema : false;
+            _lazy_pending    = false;
+            _lazy_depth++;
+            return true;
+        }
+
         _stack.emplace_back(_DictOrArray{ true /* is_dict*/ });
         return true;
     }
@@ -126,6 +208,11 @@ public:
             return false;
         }
 
+        if (_lazy_depth)
+        {
+            return true;
+        }
+
         if (_stack.empty())
         {
             _internal_error(
@@ -140,6 +227,14 @@ public:
                     "RapidJSONDecoder::_handle_end_array() called without matching _handle_start_array()");
                 _stack.pop_back();
             }
+            else if (top.streamed)
+            {
+                _stream_depth--;
+                std::optional<TimeRange> range = _streamed_available_range(top);
+                _stack.pop_back();
+                _stack.back().streamed_available_range = range;
+                store(std::any(AnyVector()));
+            }
             else
             {
                 AnyVector va;
@@ -158,6 +253,11 @@ public:
             return false;
         }
 
+        if (_lazy_depth)
+        {
+            return --_lazy_depth ? true : _store_lazy_metadata();
+        }
+
         if (_stack.empty())
         {
             _internal_error(
@@ -181,7 +281,16 @@ public:
                     _error_function,
                     nullptr,
                     static_cast<int>(_line_number_function()));
+                std::optional<TimeRange> streamed_available_range =
+                    top.streamed_available_range;
                 _stack.pop_back();
+
+                if (!_stack.empty() && _stack.back().streamed)
+                {
+                    return _stream(
+                        reader._decode(_resolver),
+                        streamed_available_range);
+                }
                 store(reader._decode(_resolver));
             }
         }
@@ -195,6 +304,12 @@ public:
             return false;
         }
 
+        _lazy_pending = false;
+        if (_lazy_depth)
+        {
+            return true;
+        }
+
         if (_stack.empty())
         {
             _root.swap(a);
@@ -204,6 +319,11 @@ public:
             auto& top = _stack.back();
             if (top.is_dict)
             {
+                if (top.cur_key == "OTIO_SCHEMA"
+                    && a.type() == typeid(std::string))
+                {
+                    _find_key_renames(top, std::any_cast<std::string&>(a));
+                }
                 top.dict.emplace(_stack.back().cur_key, a);
             }
             else
@@ -227,6 +347,52 @@ public:
 
     std::any _root;
 
+    /// Enable lazy metadata mode: buffer holds the whole input, and
+    /// offset_function returns the offset of the reader in it.
+    void set_lazy_metadata(
+        std::shared_ptr<const char> buffer,
+        std::function<size_t()>     offset_function)
+    {
+        _lazy_buffer     = buffer;
+        _offset_function = offset_function;
+    }
+
+    bool _store_lazy_metadata()
+    {
+        // the span started right after the key, before the colon
+        size_t const end   = _offset_function();
+        size_t       start = _lazy_start;
+        while (start < end
+               && (_lazy_buffer.get()[start] == ':'
+                   || isspace((unsigned char) _lazy_buffer.get()[start])))
+        {
+            start++;
+        }
+
+        SerializableObjectWithMetadata::LazyMetadata lazy{ _lazy_buffer,
+                                                           start,
+                                                           end - start };
+        if (lazy.length == 2)
+        {
+            return store(std::any(AnyDictionary()));
+        }
+
+        // metadata holding schema objects is decoded right away, so that
+        // the objects in it are read (and upgraded) as usual
+        if (_lazy_has_schema)
+        {
+            AnyDictionary metadata;
+            ErrorStatus   error_status;
+            if (!lazy.decode(&metadata, &error_status))
+            {
+                _error(error_status);
+                return false;
+            }
+            return store(std::any(std::move(metadata)));
+        }
+        return store(std::any(std::move(lazy)));
+    }
+
     void _internal_error(std::string const& err_msg)
     {
         _error_status = ErrorStatus(
@@ -252,13 +418,664 @@ public:
         AnyDictionary dict;
         AnyVector     array;
         std::string   cur_key;
+
+        // Keys renamed by the upgrade plan of an object of an older schema
+        // version, applied as they are read.
+        TypeRegistry::_UpgradePlan::Renames const* key_renames = nullptr;
+
+        // Streaming state of the children array of a track or stack.
+        bool         streamed = false;
+        std::string  parent_schema_name;
+        std::string  parent_name;
+        int          depth = 0;
+        int          index = 0;
+        RationalTime total_duration;
+        RationalTime front_transition_in_offset;
+        RationalTime back_transition_out_offset;
+
+        // The total duration of the children of a track, kept exact as in
+        // Track::available_range().
+        ExactSum exact_total_duration;
+
+        // Available range of a track or stack whose children were streamed,
+        // since the decoded object won't have any children.
+        std::optional<TimeRange> streamed_available_range;
     };
 
+    // Look up the key renames of the upgrade plan of the given schema
+    // label, e.g. "Marker.1", for the object being read into top.
+    void _find_key_renames(_DictOrArray& top, std::string const& label)
+    {
+        auto e = _upgrade_plans.find(label);
+        if (e == _upgrade_plans.end())
+        {
+            std::shared_ptr<TypeRegistry::_UpgradePlan const> plan;
+            const size_t sep = label.rfind('.');
+            if (sep != std::string::npos && sep + 1 < label.size()
+                && isdigit(static_cast<unsigned char>(label[sep + 1])))
+            {
+                const int version = std::atoi(label.c_str() + sep + 1);
+                auto      type_record =
+                    TypeRegistry::instance()._lookup_type_record(
+                        label.substr(0, sep));
+                if (type_record && version < type_record->schema_version)
+                {
+                    plan = type_record->upgrade_plan(version);
+                }
+            }
+            e = _upgrade_plans.emplace(label, plan).first;
+        }
+        top.key_renames = e->second ? e->second->leading_renames() : nullptr;
+    }
+
+    std::unordered_map<
+        std::string,
+        std::shared_ptr<TypeRegistry::_UpgradePlan const>>
+        _upgrade_plans;
+
+    /*
+     * Streaming support: when a stream callback is set, the children of
+     * tracks and stacks are handed to the callback as soon as they have
+     * been decoded instead of being collected.  Their position in the parent
+     * is computed on the fly, in the same way as
+     * Track::range_of_all_children() and Stack::available_range().
+     */
+    static bool _is_composition_children(
+        _DictOrArray const& parent,
+        std::string*        schema_name)
+    {
+        if (!parent.is_dict || parent.cur_key != "children")
+        {
+            return false;
+        }
+
+        auto schema = _lookup<std::string>(parent.dict, "OTIO_SCHEMA");
+        int  schema_version;
+        if (!schema
+            || !split_schema_string(*schema, schema_name, &schema_version))
+        {
+            return false;
+        }
+        return *schema_name == "Track" || *schema_name == "Stack";
+    }
+
+    static std::string _parent_name(_DictOrArray const& parent)
+    {
+        auto name = _lookup<std::string>(parent.dict, "name");
+        return name ? *name : std::string();
+    }
+
+    static std::optional<TimeRange>
+    _streamed_available_range(_DictOrArray const& frame)
+    {
+        if (frame.parent_schema_name == "Stack")
+        {
+            if (frame.index == 0)
+            {
+                return TimeRange();
+            }
+            return TimeRange(
+                RationalTime(0, frame.total_duration.rate()),
+                frame.total_duration);
+        }
+
+        RationalTime duration = frame.total_duration
+                                + frame.front_transition_in_offset
+                                + frame.back_transition_out_offset;
+        ExactSum exact_duration = frame.exact_total_duration;
+        exact_duration.add(frame.front_transition_in_offset);
+        exact_duration.add(frame.back_transition_out_offset);
+        duration = exact_duration.exact(duration);
+        return TimeRange(RationalTime(0, duration.rate()), duration);
+    }
+
+    bool _stream(std::any&& decoded, std::optional<TimeRange> available_range)
+    {
+        if (has_errored())
+        {
+            return false;
+        }
+
+        Composable* child = nullptr;
+        if (decoded.type() == typeid(SerializableObject::Retainer<>))
+        {
+            child = dynamic_cast<Composable*>(
+                std::any_cast<SerializableObject::Retainer<>&>(decoded).value);
+        }
+        if (!child)
+        {
+            _error(ErrorStatus(
+                ErrorStatus::TYPE_MISMATCH,
+                string_printf(
+                    "expected a Composable as child (near line %d)",
+                    _line_number_function())));
+            return false;
+        }
+
+        // Everything decoded so far belongs to this child (or to fields
+        // of its ancestors that have already been completed), so it can be
+        // read in now.
+        _resolver.finalize(_error_function);
+        _resolver.clear();
+        if (has_errored())
+        {
+            return false;
+        }
+
+        ErrorStatus  error_status;
+        RationalTime duration;
+        Transition*  transition = dynamic_cast<Transition*>(child);
+        if (transition)
+        {
+            duration = transition->duration();
+        }
+        else if (Item* item = dynamic_cast<Item*>(child))
+        {
+            auto source_range = item->source_range();
+            duration          = source_range ? source_range->duration()
+                                : available_range
+                                    ? available_range->duration()
+                                    : item->duration(&error_status);
+        }
+        if (is_error(error_status))
+        {
+            _error(error_status);
+            return false;
+        }
+
+        auto&              frame = _stack.back();
+        StreamedComposable streamed;
+        streamed.child              = child;
+        streamed.parent_schema_name = frame.parent_schema_name;
+        streamed.parent_name        = frame.parent_name;
+        streamed.depth              = frame.depth;
+        streamed.index              = frame.index;
+
+        if (frame.parent_schema_name == "Stack")
+        {
+            streamed.range_in_parent =
+                TimeRange(RationalTime(0, duration.rate()), duration);
+            frame.total_duration = frame.index == 0
+                                       ? duration
+                                       : std::max(frame.total_duration, duration);
+        }
+        else
+        {
+            // the start time is summed up, and kept exact, at the same rate
+            // as in Track::range_of_child_at_index()
+            RationalTime start_time =
+                RationalTime(0, duration.rate()) + frame.total_duration;
+            ExactSum exact_start_time = frame.exact_total_duration;
+            if (transition)
+            {
+                start_time -= transition->in_offset();
+                exact_start_time.subtract(transition->in_offset());
+                if (frame.index == 0)
+                {
+                    frame.front_transition_in_offset = transition->in_offset();
+                }
+                frame.back_transition_out_offset = transition->out_offset();
+            }
+            else
+            {
+                frame.total_duration += duration;
+                frame.exact_total_duration.add(duration);
+                frame.back_transition_out_offset = RationalTime();
+            }
+            streamed.range_in_parent =
+                TimeRange(exact_start_time.exact(start_time), duration);
+        }
+        frame.index++;
+
+        if (!_stream_callback(streamed))
+        {
+            _stopped = true;
+            return false;
+        }
+        return true;
+    }
+
     std::vector<_DictOrArray>               _stack;
     std::function<void(ErrorStatus const&)> _error_function;
     std::function<size_t()>                 _line_number_function;
 
     SerializableObject::Reader::_Resolver _resolver;
+
+    StreamedComposableCallback _stream_callback;
+    int                        _stream_depth = 0;
+    bool                       _stopped      = false;
+
+    std::shared_ptr<const char>        _lazy_buffer;
+    std::function<size_t()>            _offset_function;
+    size_t                             _lazy_start      = 0;
+    int                                _lazy_depth      = 0;
+    bool                               _lazy_pending    = false;
+    bool                               _lazy_has_schema = false;
+};
+
+/**
+ * Reads the binary format described in binaryFormat.h.  The decoder drives
+ * a JSONDecoder with the same events a JSON reader would, except that typed
+ * values (RationalTime, TimeRange, ...) are stored directly rather than
+ * being built up from their dictionary form.
+ */
+class BinaryDecoder
+{
+public:
+    BinaryDecoder(char const* data, size_t size, JSONDecoder& handler)
+        : _data(data)
+        , _size(size)
+        , _handler(handler)
+    {}
+
+    bool decode(ErrorStatus* error_status)
+    {
+        return _open(error_status)
+               && _decode_at(binary_format::header_size, error_status);
+    }
+
+    /// Decode only the object at the given subtree path.
+    bool decode_subtree(std::string const& path, ErrorStatus* error_status)
+    {
+        if (!_open(error_status))
+        {
+            return false;
+        }
+
+        uint64_t offset = 0;
+        if (!_find_subtree(path, &offset))
+        {
+            if (error_status)
+            {
+                *error_status = _index_offset
+                                    ? ErrorStatus(
+                                        ErrorStatus::KEY_NOT_FOUND,
+                                        "no subtree at path '" + path + "'")
+                                    : ErrorStatus(
+                                        ErrorStatus::KEY_NOT_FOUND,
+                                        "binary file has no subtree index");
+            }
+            return false;
+        }
+        return _decode_at(offset, error_status);
+    }
+
+private:
+    bool _open(ErrorStatus* error_status)
+    {
+        using namespace binary_format;
+
+        if (_size < header_size + trailer_size
+            || memcmp(_data, magic, sizeof(magic)) != 0
+            || memcmp(_data + _size - sizeof(magic), magic, sizeof(magic))
+                   != 0)
+        {
+            return _parse_error(error_status, "not an OTIO binary file");
+        }
+
+        Cursor header(_data + sizeof(magic), _data + header_size);
+        _format_version = header.get_u32();
+        if (_format_version > version)
+        {
+            return _parse_error(
+                error_status,
+                "unsupported binary format version");
+        }
+
+        Cursor trailer(_data + _size - trailer_size, _data + _size);
+        _strings_offset = trailer.get_u64();
+        _index_offset   = trailer.get_u64();
+        if (_strings_offset < header_size
+            || _strings_offset > _size - trailer_size
+            || !_read_strings(_strings_offset))
+        {
+            return _parse_error(error_status, "corrupt string table");
+        }
+        if (_index_offset != 0
+            && (_index_offset < _strings_offset
+                || _index_offset > _size - trailer_size))
+        {
+            return _parse_error(error_status, "corrupt subtree index");
+        }
+        return true;
+    }
+
+    bool _decode_at(uint64_t offset, ErrorStatus* error_status)
+    {
+        if (offset < binary_format::header_size || offset >= _strings_offset)
+        {
+            return _parse_error(error_status, "corrupt subtree index");
+        }
+
+        binary_format::Cursor body(_data + offset, _data + _strings_offset);
+        bool status = _value(body);
+        if (offset == binary_format::header_size)
+        {
+            // the root value must span the whole body
+            status = status && body.at_end();
+        }
+        if (status && !_handler.has_errored())
+        {
+            _handler.finalize();
+        }
+        else
+        {
+            _handler.discard();
+        }
+
+        if (_handler.has_errored(error_status))
+        {
+            return false;
+        }
+        if (!status)
+        {
+            return _parse_error(error_status, string_printf(
+                "corrupt value at offset %zu",
+                size_t(offset) + body.offset()));
+        }
+        return true;
+    }
+
+    bool _find_subtree(std::string const& path, uint64_t* offset)
+    {
+        if (_index_offset == 0)
+        {
+            return false;
+        }
+
+        binary_format::Cursor c(
+            _data + _index_offset,
+            _data + _size - binary_format::trailer_size);
+        const uint64_t         count = c.get_varint();
+        const std::string_view wanted(path);
+        if (_format_version < 2)
+        {
+            // the entries of the first version are not ordered
+            for (uint64_t i = 0; i < count && c.ok(); ++i)
+            {
+                if (_index_entry(c, wanted) == 0 && c.ok())
+                {
+                    *offset = c.get_u64();
+                    return c.ok();
+                }
+                c.skip(8);
+            }
+            return false;
+        }
+
+        // a binary search over the positions of the entries, which are
+        // ordered by path
+        const size_t positions = c.offset();
+        if (!c.ok() || count > (c.remaining() / 8))
+        {
+            return false;
+        }
+        uint64_t low  = 0;
+        uint64_t high = count;
+        while (low < high)
+        {
+            const uint64_t middle = low + (high - low) / 2;
+            c.seek(positions + 8 * middle);
+            if (!c.seek(c.get_u64()))
+            {
+                return false;
+            }
+
+            const int order = _index_entry(c, wanted);
+            if (!c.ok())
+            {
+                return false;
+            }
+            if (order == 0)
+            {
+                *offset = c.get_u64();
+                return c.ok();
+            }
+            if (order < 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Read the path of an index entry, and compare it to the given path.
+     * The cursor is left at the offset of the entry.
+     */
+    static int
+    _index_entry(binary_format::Cursor& c, std::string_view wanted)
+    {
+        const uint64_t length = c.get_varint();
+        char const*    entry  = c.get_bytes(size_t(length));
+        if (!entry)
+        {
+            return -1;
+        }
+        return std::string_view(entry, size_t(length)).compare(wanted);
+    }
+
+    bool _parse_error(ErrorStatus* error_status, std::string const& details)
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::JSON_PARSE_ERROR,
+                "binary parse error: " + details);
+        }
+        return false;
+    }
+
+    bool _read_strings(uint64_t offset)
+    {
+        binary_format::Cursor c(
+            _data + offset,
+            _data + _size - binary_format::trailer_size);
+        const uint64_t count = c.get_varint();
+        if (count > _size)
+        {
+            return false;
+        }
+
+        _strings.reserve(size_t(count));
+        for (uint64_t i = 0; i < count && c.ok(); ++i)
+        {
+            const uint64_t length = c.get_varint();
+            char const*    s      = c.get_bytes(size_t(length));
+            if (s)
+            {
+                _strings.emplace_back(s, size_t(length));
+            }
+        }
+        return c.ok();
+    }
+
+    std::string const* _string_ref(binary_format::Cursor& c)
+    {
+        const uint64_t index = c.get_varint();
+        return (c.ok() && index < _strings.size()) ? &_strings[index]
+                                                   : nullptr;
+    }
+
+    bool _string(binary_format::Cursor& c, std::string* result)
+    {
+        const uint64_t length = c.get_varint();
+        char const*    s      = c.get_bytes(size_t(length));
+        if (!s)
+        {
+            return false;
+        }
+        result->assign(s, size_t(length));
+        return true;
+    }
+
+    RationalTime _rational_time(binary_format::Cursor& c)
+    {
+        const double value = c.get_double();
+        return RationalTime(value, c.get_double());
+    }
+
+    bool _value(binary_format::Cursor& c)
+    {
+        using namespace binary_format;
+
+        switch (c.get_u8())
+        {
+            case null_tag:
+                return c.ok() && _handler.Null();
+            case false_tag:
+                return _handler.Bool(false);
+            case true_tag:
+                return _handler.Bool(true);
+            case int64_tag: {
+                const int64_t value = c.get_zigzag();
+                return c.ok() && _handler.Int64(value);
+            }
+            case uint64_tag: {
+                const uint64_t value = c.get_varint();
+                return c.ok() && _handler.Uint64(value);
+            }
+            case double_tag: {
+                const double value = c.get_double();
+                return c.ok() && _handler.Double(value);
+            }
+            case string_tag: {
+                std::string value;
+                return _string(c, &value) && _handler.store(std::any(value));
+            }
+            case string_ref_tag: {
+                std::string const* value = _string_ref(c);
+                return value && _handler.store(std::any(*value));
+            }
+            case rational_time_tag: {
+                const RationalTime value = _rational_time(c);
+                return c.ok() && _handler.store(std::any(value));
+            }
+            case time_range_tag: {
+                const RationalTime start_time = _rational_time(c);
+                const RationalTime duration   = _rational_time(c);
+                return c.ok()
+                       && _handler.store(
+                           std::any(TimeRange(start_time, duration)));
+            }
+            case time_transform_tag: {
+                const RationalTime offset = _rational_time(c);
+                const double       scale  = c.get_double();
+                const double       rate   = c.get_double();
+                return c.ok()
+                       && _handler.store(
+                           std::any(TimeTransform(offset, scale, rate)));
+            }
+            case color_tag: {
+                const double r = c.get_double();
+                const double g = c.get_double();
+                const double b = c.get_double();
+                const double a = c.get_double();
+                std::string  name;
+                return _string(c, &name)
+                       && _handler.store(std::any(Color(r, g, b, a, name)));
+            }
+            case reference_tag: {
+                SerializableObject::ReferenceId value;
+                return _string(c, &value.id)
+                       && _handler.store(std::any(value));
+            }
+            case v2d_tag: {
+                const double x = c.get_double();
+                const double y = c.get_double();
+                return c.ok()
+                       && _handler.store(std::any(IMATH_NAMESPACE::V2d(x, y)));
+            }
+            case box2d_tag: {
+                const double min_x = c.get_double();
+                const double min_y = c.get_double();
+                const double max_x = c.get_double();
+                const double max_y = c.get_double();
+                return c.ok()
+                       && _handler.store(std::any(IMATH_NAMESPACE::Box2d(
+                           IMATH_NAMESPACE::V2d(min_x, min_y),
+                           IMATH_NAMESPACE::V2d(max_x, max_y))));
+            }
+            case array_tag:
+                return _array(c);
+            case object_tag:
+                return _object(c);
+            default:
+                return false;
+        }
+    }
+
+    bool _array(binary_format::Cursor& c)
+    {
+        const uint32_t length = c.get_u32();
+        char const*    start  = c.position();
+        if (!c.skip(length))
+        {
+            return false;
+        }
+
+        // every value takes at least a byte
+        binary_format::Cursor record(start, start + length);
+        const uint64_t        count = record.get_varint();
+        if (!record.ok() || count > record.remaining()
+            || !_handler.StartArray())
+        {
+            return false;
+        }
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            if (!_value(record))
+            {
+                return false;
+            }
+        }
+        return record.at_end() && _handler.EndArray(0)
+               && !_handler.has_errored();
+    }
+
+    bool _object(binary_format::Cursor& c)
+    {
+        const uint32_t length = c.get_u32();
+        char const*    start  = c.position();
+        if (!c.skip(length))
+        {
+            return false;
+        }
+
+        binary_format::Cursor record(start, start + length);
+        if (!_handler.StartObject())
+        {
+            return false;
+        }
+
+        while (!record.at_end())
+        {
+            std::string const* key = _string_ref(record);
+            if (!key
+                || !_handler.Key(
+                    key->c_str(),
+                    OTIO_rapidjson::SizeType(key->size()),
+                    false)
+                || !_value(record))
+            {
+                return false;
+            }
+        }
+        return _handler.EndObject(0) && !_handler.has_errored();
+    }
+
+    char const*              _data;
+    size_t                   _size;
+    JSONDecoder&             _handler;
+    std::vector<std::string> _strings;
+    uint64_t                 _strings_offset = 0;
+    uint64_t                 _index_offset   = 0;
+    uint32_t                 _format_version = 0;
 };
 
 SerializableObject::Reader::Reader(
@@ -558,6 +1375,30 @@ SerializableObject::Reader::_type_check_so(
     return true;
 }
 
+static bool
+_has_lazy_metadata(AnyDictionary const& dict)
+{
+    auto e = dict.find("metadata");
+    return e != dict.end()
+           && e->second.type()
+                  == typeid(SerializableObjectWithMetadata::LazyMetadata);
+}
+
+static bool
+_decode_lazy_metadata(AnyDictionary& dict, ErrorStatus* error_status)
+{
+    auto&         value = dict["metadata"];
+    AnyDictionary metadata;
+    if (!std::any_cast<SerializableObjectWithMetadata::LazyMetadata const&>(
+             value)
+             .decode(&metadata, error_status))
+    {
+        return false;
+    }
+    value = std::any(std::move(metadata));
+    return true;
+}
+
 std::any
 SerializableObject::Reader::_decode(_Resolver& resolver)
 {
@@ -671,7 +1512,28 @@ SerializableObject::Reader::_decode(_Resolver& resolver)
             return std::any();
         }
 
-        ErrorStatus error_status;
+        /*
+         * Metadata skipped over in lazy mode is only left undecoded for
+         * objects that read it themselves (see
+         * SerializableObjectWithMetadata::read_from()); upgrade functions
+         * and every other schema see the decoded dictionary.
+         */
+        bool        lazy_metadata = _has_lazy_metadata(_dict);
+        ErrorStatus error_status;
+        if (lazy_metadata)
+        {
+            auto type_record = r._lookup_type_record(schema_name);
+            if (!type_record || type_record->schema_version != schema_version)
+            {
+                if (!_decode_lazy_metadata(_dict, &error_status))
+                {
+                    _error(error_status);
+                    return std::any();
+                }
+                lazy_metadata = false;
+            }
+        }
+
         if (SerializableObject* so = r._instance_from_schema(
                 schema_name,
                 schema_version,
@@ -679,12 +1541,22 @@ SerializableObject::Reader::_decode(_Resolver& resolver)
                 true /* internal_read */,
                 &error_status))
         {
+            if (lazy_metadata
+                && !dynamic_cast<SerializableObjectWithMetadata*>(so)
+                && !_decode_lazy_metadata(_dict, &error_status))
+            {
+                _error(error_status);
+                Retainer<> discard(so);
+                return std::any();
+            }
+
             if (!ref_id.empty())
             {
                 resolver.object_for_id[ref_id] = so;
             }
             resolver.data_for_object.emplace(so, std::move(_dict));
             resolver.line_number_for_object[so] = _line_number;
+            resolver.objects.emplace_back(so);
             return std::any(SerializableObject::Retainer<>(so));
         }
 
@@ -876,16 +1748,21 @@ SerializableObject::Reader::read(std::string const& key, std::any* value)
     }
 }
 
-bool
-deserialize_json_from_string(
-    std::string const& input,
-    std::any*          destination,
-    ErrorStatus*       error_status)
+template <typename Stream>
+static bool
+_parse_json(
+    Stream&                     stream,
+    std::shared_ptr<const char> lazy_buffer,
+    std::any*                   destination,
+    ErrorStatus*                error_status)
 {
-    OTIO_rapidjson::Reader                            reader;
-    OTIO_rapidjson::StringStream                      ss(input.c_str());
-    OTIO_rapidjson::CursorStreamWrapper<decltype(ss)> csw(ss);
+    OTIO_rapidjson::Reader                      reader;
+    OTIO_rapidjson::CursorStreamWrapper<Stream> csw(stream);
     JSONDecoder handler(std::bind(&decltype(csw)::GetLine, &csw));
+    if (lazy_buffer)
+    {
+        handler.set_lazy_metadata(lazy_buffer, [&csw] { return csw.Tell(); });
+    }
 
     bool status =
         reader.Parse<OTIO_rapidjson::kParseNanAndInfFlag>(csw, handler);
@@ -917,26 +1794,215 @@ deserialize_json_from_string(
     return true;
 }
 
+static bool
+_deserialize_json(
+    std::string const&          input,
+    std::shared_ptr<const char> lazy_buffer,
+    std::any*                   destination,
+    ErrorStatus*                error_status)
+{
+    OTIO_rapidjson::StringStream ss(input.c_str());
+    return _parse_json(ss, lazy_buffer, destination, error_status);
+}
+
 bool
-deserialize_json_from_file(
-    std::string const& file_name,
+deserialize_json_from_string(
+    std::string const& input,
     std::any*          destination,
-    ErrorStatus*       error_status)
+    ErrorStatus*       error_status,
+    bool               lazy_metadata)
+{
+    if (!lazy_metadata)
+    {
+        return _deserialize_json(input, nullptr, destination, error_status);
+    }
+
+    return deserialize_json_from_string(
+        std::string(input),
+        destination,
+        error_status,
+        lazy_metadata);
+}
+
+bool
+deserialize_json_from_string(
+    std::string&& input,
+    std::any*     destination,
+    ErrorStatus*  error_status,
+    bool          lazy_metadata)
 {
+    if (!lazy_metadata)
+    {
+        return _deserialize_json(input, nullptr, destination, error_status);
+    }
+
+    // the objects share the input, which they take over
+    auto owner = std::make_shared<const std::string>(std::move(input));
+    return _deserialize_json(
+        *owner,
+        std::shared_ptr<const char>(owner, owner->c_str()),
+        destination,
+        error_status);
+}
+
+bool
+SerializableObjectWithMetadata::LazyMetadata::decode(
+    AnyDictionary* result,
+    ErrorStatus*   error_status) const
+{
+    std::any decoded;
+    if (!_deserialize_json(
+            std::string(buffer.get() + offset, length),
+            nullptr,
+            &decoded,
+            error_status))
+    {
+        return false;
+    }
+
+    if (decoded.type() != typeid(AnyDictionary))
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::TYPE_MISMATCH,
+                "expected metadata to be a dictionary");
+        }
+        return false;
+    }
+
+    result->swap(std::any_cast<AnyDictionary&>(decoded));
+    return true;
+}
 
+static FILE*
+_open_input_file(std::string const& file_name, bool binary = false)
+{
     FILE* fp = nullptr;
 #if defined(_WINDOWS)
     const int wlen =
         MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, NULL, 0);
     std::vector<wchar_t> wchars(wlen);
     MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, wchars.data(), wlen);
-    if (_wfopen_s(&fp, wchars.data(), L"r") != 0)
+    if (_wfopen_s(&fp, wchars.data(), binary ? L"rb" : L"r") != 0)
     {
         fp = nullptr;
     }
 #else  // _WINDOWS
-    fp = fopen(file_name.c_str(), "r");
+    fp = fopen(file_name.c_str(), binary ? "rb" : "r");
+#endif // _WINDOWS
+    return fp;
+}
+
+/**
+ * Read-only view of a whole file.  On POSIX systems the file is memory
+ * mapped, so only the pages that are actually decoded are read from disk;
+ * elsewhere it is read into memory.
+ */
+class _InputFileView
+{
+public:
+    _InputFileView(std::string const& file_name)
+    {
+#if defined(_WINDOWS)
+        FILE* fp = _open_input_file(file_name, true);
+        if (!fp)
+        {
+            return;
+        }
+
+        char   buffer[65536];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        {
+            _contents.append(buffer, count);
+        }
+        _is_open = ferror(fp) == 0;
+        fclose(fp);
+        _data = _contents.data();
+        _size = _contents.size();
+#else  // _WINDOWS
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0)
+        {
+            _size    = size_t(st.st_size);
+            _is_open = true;
+            if (_size > 0)
+            {
+                void* map =
+                    mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                _is_open = (map != MAP_FAILED);
+                _data = _is_open ? static_cast<char const*>(map) : nullptr;
+            }
+        }
+        close(fd);
+#endif // _WINDOWS
+    }
+
+    ~_InputFileView()
+    {
+#if !defined(_WINDOWS)
+        if (_data)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
 #endif // _WINDOWS
+    }
+
+    _InputFileView(_InputFileView const&)            = delete;
+    _InputFileView& operator=(_InputFileView const&) = delete;
+
+    bool        is_open() const { return _is_open; }
+    char const* data() const { return _data; }
+    size_t      size() const { return _size; }
+
+private:
+    bool        _is_open = false;
+    char const* _data    = nullptr;
+    size_t      _size    = 0;
+#if defined(_WINDOWS)
+    std::string _contents;
+#endif // _WINDOWS
+};
+
+bool
+deserialize_json_from_file(
+    std::string const& file_name,
+    std::any*          destination,
+    ErrorStatus*       error_status,
+    bool               lazy_metadata)
+{
+    if (lazy_metadata)
+    {
+        // the metadata spans refer to the input, so the objects share the
+        // file view, which keeps the file mapped until they are gone
+        auto file = std::make_shared<const _InputFileView>(file_name);
+        if (!file->is_open())
+        {
+            if (error_status)
+            {
+                *error_status =
+                    ErrorStatus(ErrorStatus::FILE_OPEN_FAILED, file_name);
+            }
+            return false;
+        }
+
+        OTIO_rapidjson::MemoryStream ms(file->data(), file->size());
+        return _parse_json(
+            ms,
+            file->size() ? std::shared_ptr<const char>(file, file->data())
+                         : nullptr,
+            destination,
+            error_status);
+    }
+
+    FILE* fp = _open_input_file(file_name);
     if (!fp)
     {
         if (error_status)
@@ -986,4 +2052,193 @@ deserialize_json_from_file(
     return true;
 }
 
+bool
+deserialize_json_stream_from_string(
+    std::string const&                input,
+    StreamedComposableCallback const& callback,
+    ErrorStatus*                      error_status)
+{
+    OTIO_rapidjson::Reader                            reader;
+    OTIO_rapidjson::StringStream                      ss(input.c_str());
+    OTIO_rapidjson::CursorStreamWrapper<decltype(ss)> csw(ss);
+    JSONDecoder handler(std::bind(&decltype(csw)::GetLine, &csw));
+    handler._stream_callback = callback;
+
+    bool status =
+        reader.Parse<OTIO_rapidjson::kParseNanAndInfFlag>(csw, handler);
+    handler.finalize();
+
+    if (handler.has_errored(error_status))
+    {
+        return false;
+    }
+
+    if (!status && !handler._stopped)
+    {
+        if (error_status)
+        {
+            auto msg      = GetParseError_En(reader.GetParseErrorCode());
+            *error_status = ErrorStatus(
+                ErrorStatus::JSON_PARSE_ERROR,
+                string_printf(
+                    "JSON parse error on input string: %s "
+                    "(line %d, column %d)",
+                    msg,
+                    csw.GetLine(),
+                    csw.GetColumn()));
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+deserialize_json_stream_from_file(
+    std::string const&                file_name,
+    StreamedComposableCallback const& callback,
+    ErrorStatus*                      error_status)
+{
+    FILE* fp = _open_input_file(file_name);
+    if (!fp)
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_OPEN_FAILED, file_name);
+        }
+        return false;
+    }
+
+    OTIO_rapidjson::Reader reader;
+
+    char                           readBuffer[65536];
+    OTIO_rapidjson::FileReadStream fs(fp, readBuffer, sizeof(readBuffer));
+    OTIO_rapidjson::CursorStreamWrapper<decltype(fs)> csw(fs);
+    JSONDecoder handler(std::bind(&decltype(csw)::GetLine, &csw));
+    handler._stream_callback = callback;
+
+    bool status =
+        reader.Parse<OTIO_rapidjson::kParseNanAndInfFlag>(csw, handler);
+    fclose(fp);
+
+    handler.finalize();
+
+    if (handler.has_errored(error_status))
+    {
+        return false;
+    }
+
+    if (!status && !handler._stopped)
+    {
+        auto msg = GetParseError_En(reader.GetParseErrorCode());
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::JSON_PARSE_ERROR,
+                string_printf(
+                    "JSON parse error on input string: %s "
+                    "(line %d, column %d)",
+                    msg,
+                    csw.GetLine(),
+                    csw.GetColumn()));
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+deserialize_binary_from_string(
+    std::string const& input,
+    std::any*          destination,
+    ErrorStatus*       error_status)
+{
+    JSONDecoder   handler([] { return size_t(0); });
+    BinaryDecoder decoder(input.data(), input.size(), handler);
+    if (!decoder.decode(error_status))
+    {
+        return false;
+    }
+
+    destination->swap(handler._root);
+    return true;
+}
+
+bool
+deserialize_binary_from_file(
+    std::string const& file_name,
+    std::any*          destination,
+    ErrorStatus*       error_status)
+{
+    _InputFileView file(file_name);
+    if (!file.is_open())
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_OPEN_FAILED, file_name);
+        }
+        return false;
+    }
+
+    JSONDecoder   handler([] { return size_t(0); });
+    BinaryDecoder decoder(file.data(), file.size(), handler);
+    if (!decoder.decode(error_status))
+    {
+        return false;
+    }
+
+    destination->swap(handler._root);
+    return true;
+}
+
+bool
+deserialize_binary_subtree_from_string(
+    std::string const& input,
+    std::string const& path,
+    std::any*          destination,
+    ErrorStatus*       error_status)
+{
+    JSONDecoder   handler([] { return size_t(0); });
+    BinaryDecoder decoder(input.data(), input.size(), handler);
+    if (!decoder.decode_subtree(path, error_status))
+    {
+        return false;
+    }
+
+    destination->swap(handler._root);
+    return true;
+}
+
+bool
+deserialize_binary_subtree_from_file(
+    std::string const& file_name,
+    std::string const& path,
+    std::any*          destination,
+    ErrorStatus*       error_status)
+{
+    _InputFileView file(file_name);
+    if (!file.is_open())
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_OPEN_FAILED, file_name);
+        }
+        return false;
+    }
+
+    JSONDecoder   handler([] { return size_t(0); });
+    BinaryDecoder decoder(file.data(), file.size(), handler);
+    if (!decoder.decode_subtree(path, error_status))
+    {
+        return false;
+    }
+
+    destination->swap(handler._root);
+    return true;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -3,24 +3,147 @@
 
 #pragma once
 
+#include "opentimelineio/composable.h"
 #include "opentimelineio/serializableObject.h"
 #include "opentimelineio/version.h"
 
 #include <any>
+#include <functional>
 #include <string>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 /// @brief Deserialize JSON data from a string.
+///
+/// With lazy_metadata, the metadata of each SerializableObjectWithMetadata
+/// is not decoded while reading.  The object keeps its JSON text instead
+/// (sharing a copy of the input with all other objects read with it; pass
+/// the input as an rvalue to hand it over without the copy), and
+/// decodes it on the first call to metadata().  Until metadata() is called
+/// on a non-const object, serializing the object to JSON writes the text
+/// back out as is (only re-indented to fit), provided that both are pretty
+/// printed or both are compact.  Metadata that contains schema objects is
+/// always decoded right away.
 bool deserialize_json_from_string(
     std::string const& input,
     std::any*          destination,
-    ErrorStatus*       error_status = nullptr);
+    ErrorStatus*       error_status  = nullptr,
+    bool               lazy_metadata = false);
+
+/// @brief Deserialize JSON data from a string, taking over the string in
+/// lazy metadata mode.
+bool deserialize_json_from_string(
+    std::string&& input,
+    std::any*     destination,
+    ErrorStatus*  error_status  = nullptr,
+    bool          lazy_metadata = false);
 
 /// @brief Deserialize JSON data from a file.
+///
+/// See deserialize_json_from_string() for the meaning of lazy_metadata; in
+/// lazy mode the file is memory mapped where possible, and stays mapped
+/// until all of the objects read from it are gone.
 bool deserialize_json_from_file(
     std::string const& file_name,
     std::any*          destination,
+    ErrorStatus*       error_status  = nullptr,
+    bool               lazy_metadata = false);
+
+/// @brief Deserialize binary data from a string.
+///
+/// See serialize_binary_to_string() for a description of the format.
+bool deserialize_binary_from_string(
+    std::string const& input,
+    std::any*          destination,
+    ErrorStatus*       error_status = nullptr);
+
+/// @brief Deserialize binary data from a file.
+bool deserialize_binary_from_file(
+    std::string const& file_name,
+    std::any*          destination,
+    ErrorStatus*       error_status = nullptr);
+
+/// @brief Deserialize a single object from binary data, without decoding
+/// the rest of the input.
+///
+/// The path names the object by "/" separated components starting at the
+/// root: "tracks" for a timeline's stack, and indices into the children of
+/// tracks, stacks and serializable collections.  For example "tracks/3" is
+/// the fourth track of a timeline, and "tracks/3/0" the first item in it.
+///
+/// References (OTIO_REF_ID) to objects outside the subtree are not
+/// resolved.
+bool deserialize_binary_subtree_from_string(
+    std::string const& input,
+    std::string const& path,
+    std::any*          destination,
     ErrorStatus*       error_status = nullptr);
 
+/// @brief Deserialize a single object from a binary file, without decoding
+/// the rest of the file.
+///
+/// The file is memory mapped where possible, so only the requested part is
+/// read.  See deserialize_binary_subtree_from_string().
+bool deserialize_binary_subtree_from_file(
+    std::string const& file_name,
+    std::string const& path,
+    std::any*          destination,
+    ErrorStatus*       error_status = nullptr);
+
+/// @brief A child of a track or stack, as handed out by the streaming
+/// readers.
+struct StreamedComposable
+{
+    /// @brief The child.
+    ///
+    /// Tracks and stacks are handed out after all of their own children,
+    /// and without them.
+    SerializableObject::Retainer<Composable> child;
+
+    /// @brief The schema name of the parent, "Track" or "Stack".
+    std::string parent_schema_name;
+
+    /// @brief The name of the parent.
+    std::string parent_name;
+
+    /// @brief The nesting depth of the parent, 0 for the outermost
+    /// composition whose children are streamed (e.g. a timeline's stack).
+    int depth = 0;
+
+    /// @brief The index of the child in the parent.
+    int index = 0;
+
+    /// @brief The range of the child in the parent, as given by
+    /// Track::range_of_child_at_index() or Stack::range_of_child_at_index().
+    TimeRange range_in_parent;
+};
+
+/// @brief Callback for the streaming readers; return false to stop reading.
+using StreamedComposableCallback =
+    std::function<bool(StreamedComposable const&)>;
+
+/// @brief Read JSON data from a string, handing out the children of tracks
+/// and stacks one at a time instead of building the whole object graph.
+///
+/// Each child is passed to the callback as soon as it has been parsed, and
+/// released afterwards unless the callback retains it, so peak memory is
+/// bounded by the nesting depth rather than by the size of the input.
+/// References (OTIO_REF_ID) between different children are not supported.
+///
+/// Returns true if the input was read completely, or until the callback
+/// returned false.
+bool deserialize_json_stream_from_string(
+    std::string const&                input,
+    StreamedComposableCallback const& callback,
+    ErrorStatus*                      error_status = nullptr);
+
+/// @brief Read JSON data from a file, handing out the children of tracks
+/// and stacks one at a time.
+///
+/// See deserialize_json_stream_from_string().
+bool deserialize_json_stream_from_file(
+    std::string const&                file_name,
+    StreamedComposableCallback const& callback,
+    ErrorStatus*                      error_status = nullptr);
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
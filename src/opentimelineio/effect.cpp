@@ -35,4 +35,30 @@ Effect::write_to(Writer& writer) const
     writer.write("enabled", _enabled);
 }
 
+SerializableObject*
+Effect::_clone_instance() const
+{
+    return new Effect;
+}
+
+bool
+Effect::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& effect = static_cast<Effect const&>(source);
+    _effect_name       = effect._effect_name;
+    _enabled           = effect._enabled;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Effect::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& effect = static_cast<Effect const&>(other);
+    return comparer.equivalent("effect_name", _effect_name, effect._effect_name)
+           && comparer.equivalent("enabled", _enabled, effect._enabled)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
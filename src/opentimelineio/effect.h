@@ -39,6 +39,7 @@ public:
     /// @brief Set the effect name.
     void set_effect_name(std::string const& effect_name)
     {
+        mark_modified();
         _effect_name = effect_name;
     }
 
@@ -46,7 +47,11 @@ public:
     bool enabled() const { return _enabled; };
 
     /// @brief Set whether the effect is enabled.
-    void set_enabled(bool enabled) { _enabled = enabled; }  
+    void set_enabled(bool enabled)
+    {
+        mark_modified();
+        _enabled = enabled;
+    }
 
 protected:
     virtual ~Effect();
@@ -54,6 +59,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string _effect_name;
     bool        _enabled;
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentime/exactTime.h"
+#include "opentime/rationalTime.h"
+#include "opentimelineio/version.h"
+
+#include <cstdint>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
+
+// A running sum of times, kept exact while the times can be represented as
+// ExactTime (as the times at all the common rates can), so that the times
+// late in a track do not drift when its children have different rates.
+class ExactSum
+{
+public:
+    void add(RationalTime time) { _add(time, false); }
+
+    void subtract(RationalTime time) { _add(time, true); }
+
+    // Return the sum, given the same sum computed with RationalTime
+    // arithmetic, at that sum's rate.
+    RationalTime exact(RationalTime sum)
+    {
+        const int64_t ticks_per_sample = _ticks_per_sample_at(sum.rate());
+        if (!_exact || !ticks_per_sample)
+        {
+            return sum;
+        }
+        return RationalTime(
+            ExactTime(_ticks).samples(ticks_per_sample),
+            sum.rate());
+    }
+
+private:
+    void _add(RationalTime time, bool negate)
+    {
+        if (!_exact)
+        {
+            return;
+        }
+
+        auto exact_time = ExactTime::from_samples(
+            time.value(),
+            _ticks_per_sample_at(time.rate()));
+        if (!exact_time)
+        {
+            _exact = false;
+        }
+        else if (negate)
+        {
+            _ticks -= exact_time->ticks();
+        }
+        else
+        {
+            _ticks += exact_time->ticks();
+        }
+    }
+
+    int64_t _ticks_per_sample_at(double rate)
+    {
+        if (rate != _rate)
+        {
+            _rate             = rate;
+            _ticks_per_sample = ExactTime::ticks_per_sample(rate);
+        }
+        return _ticks_per_sample;
+    }
+
+    // the sum in ticks, which is only valid while every time added to it
+    // was exact
+    int64_t _ticks            = 0;
+    bool    _exact            = true;
+    double  _rate             = 0;
+    int64_t _ticks_per_sample = 0;
+};
+
+}} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -30,4 +30,31 @@ ExternalReference::write_to(Writer& writer) const
     writer.write("target_url", _target_url);
 }
 
+SerializableObject*
+ExternalReference::_clone_instance() const
+{
+    return new ExternalReference;
+}
+
+bool
+ExternalReference::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    _target_url = static_cast<ExternalReference const&>(source)._target_url;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+ExternalReference::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    return comparer.equivalent(
+               "target_url",
+               _target_url,
+               static_cast<ExternalReference const&>(other)._target_url)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
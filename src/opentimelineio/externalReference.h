@@ -40,6 +40,7 @@ public:
     /// @brief Set the media file URL.
     void set_target_url(std::string const& target_url)
     {
+        mark_modified();
         _target_url = target_url;
     }
 
@@ -49,6 +50,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string _target_url;
 };
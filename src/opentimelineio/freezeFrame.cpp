@@ -12,4 +12,10 @@ FreezeFrame::FreezeFrame(std::string const& name, AnyDictionary const& metadata)
 FreezeFrame::~FreezeFrame()
 {}
 
+SerializableObject*
+FreezeFrame::_clone_instance() const
+{
+    return new FreezeFrame;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
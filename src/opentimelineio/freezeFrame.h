@@ -31,6 +31,8 @@ public:
 
 protected:
     virtual ~FreezeFrame();
+
+    SerializableObject* _clone_instance() const override;
 };
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -49,4 +49,10 @@ Gap::write_to(Writer& writer) const
     Parent::write_to(writer);
 }
 
+SerializableObject*
+Gap::_clone_instance() const
+{
+    return new Gap;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -15,7 +15,12 @@ GeneratorReference::GeneratorReference(
     : Parent(name, available_range, metadata, available_image_bounds)
     , _generator_kind(generator_kind)
     , _parameters(parameters)
-{}
+{
+    if (_holds_objects(_parameters))
+    {
+        _expose_dictionary();
+    }
+}
 
 GeneratorReference::~GeneratorReference()
 {}
@@ -23,9 +28,16 @@ GeneratorReference::~GeneratorReference()
 bool
 GeneratorReference::read_from(Reader& reader)
 {
-    return reader.read("generator_kind", &_generator_kind)
-           && reader.read("parameters", &_parameters)
-           && Parent::read_from(reader);
+    if (!reader.read("generator_kind", &_generator_kind)
+        || !reader.read("parameters", &_parameters))
+    {
+        return false;
+    }
+    if (_holds_objects(_parameters))
+    {
+        _expose_dictionary();
+    }
+    return Parent::read_from(reader);
 }
 
 void
@@ -36,4 +48,54 @@ GeneratorReference::write_to(Writer& writer) const
     writer.write("parameters", _parameters);
 }
 
+void
+GeneratorReference::_dictionaries(
+    std::vector<AnyDictionary const*>& dictionaries) const
+{
+    Parent::_dictionaries(dictionaries);
+    dictionaries.push_back(&_parameters);
+}
+
+SerializableObject*
+GeneratorReference::_clone_instance() const
+{
+    return new GeneratorReference;
+}
+
+bool
+GeneratorReference::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& reference = static_cast<GeneratorReference const&>(source);
+    _generator_kind       = reference._generator_kind;
+    _parameters.clear();
+    if (!cloner.clone(reference._parameters, &_parameters))
+    {
+        return false;
+    }
+    if (_holds_objects(_parameters))
+    {
+        _expose_dictionary();
+    }
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+GeneratorReference::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& reference = static_cast<GeneratorReference const&>(other);
+    return comparer.equivalent(
+               "generator_kind",
+               _generator_kind,
+               reference._generator_kind)
+           && comparer.equivalent(
+               "parameters",
+               _parameters,
+               reference._parameters)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -44,11 +44,16 @@ public:
     /// @brief Set the kind of generator.
     void set_generator_kind(std::string const& generator_kind)
     {
+        mark_modified();
         _generator_kind = generator_kind;
     }
 
     /// @brief Modify the generator parameters.
-    AnyDictionary& parameters() noexcept { return _parameters; }
+    AnyDictionary& parameters() noexcept
+    {
+        _watch_dictionaries();
+        return _parameters;
+    }
 
     /// @brief Return the generator parameters.
     AnyDictionary parameters() const noexcept { return _parameters; }
@@ -59,6 +64,13 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _dictionaries(std::vector<AnyDictionary const*>&) const override;
+
 private:
     std::string   _generator_kind;
     AnyDictionary _parameters;
@@ -268,4 +268,67 @@ ImageSequenceReference::write_to(Writer& writer) const
     }
     writer.write("missing_frame_policy", missing_frame_policy_value);
 }
+
+SerializableObject*
+ImageSequenceReference::_clone_instance() const
+{
+    return new ImageSequenceReference;
+}
+
+bool
+ImageSequenceReference::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& reference =
+        static_cast<ImageSequenceReference const&>(source);
+    _target_url_base      = reference._target_url_base;
+    _name_prefix          = reference._name_prefix;
+    _name_suffix          = reference._name_suffix;
+    _start_frame          = reference._start_frame;
+    _frame_step           = reference._frame_step;
+    _rate                 = reference._rate;
+    _frame_zero_padding   = reference._frame_zero_padding;
+    _missing_frame_policy = reference._missing_frame_policy;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+ImageSequenceReference::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& reference = static_cast<ImageSequenceReference const&>(other);
+    return comparer.equivalent(
+               "target_url_base",
+               _target_url_base,
+               reference._target_url_base)
+           && comparer.equivalent(
+               "name_prefix",
+               _name_prefix,
+               reference._name_prefix)
+           && comparer.equivalent(
+               "name_suffix",
+               _name_suffix,
+               reference._name_suffix)
+           && comparer.equivalent(
+               "start_frame",
+               _start_frame,
+               reference._start_frame)
+           && comparer.equivalent(
+               "frame_step",
+               _frame_step,
+               reference._frame_step)
+           && comparer.equivalent("rate", _rate, reference._rate)
+           && comparer.equivalent(
+               "frame_zero_padding",
+               _frame_zero_padding,
+               reference._frame_zero_padding)
+           && comparer.equivalent(
+               "missing_frame_policy",
+               _missing_frame_policy,
+               reference._missing_frame_policy)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
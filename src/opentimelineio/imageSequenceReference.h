@@ -71,6 +71,7 @@ public:
     /// @brief Set the URL base.
     void set_target_url_base(std::string const& target_url_base)
     {
+        mark_modified();
         _target_url_base = target_url_base;
     }
 
@@ -80,6 +81,7 @@ public:
     /// @brief Set the file name prefix.
     void set_name_prefix(std::string const& target_url_base)
     {
+        mark_modified();
         _name_prefix = target_url_base;
     }
 
@@ -89,6 +91,7 @@ public:
     /// @brief Set the file name suffix.
     void set_name_suffix(std::string const& target_url_base)
     {
+        mark_modified();
         _name_suffix = target_url_base;
     }
 
@@ -98,6 +101,7 @@ public:
     /// @brief Set the start frame.
     void set_start_frame(int start_frame) noexcept
     {
+        mark_modified();
         _start_frame = start_frame;
     }
 
@@ -105,13 +109,21 @@ public:
     int frame_step() const noexcept { return _frame_step; }
 
     /// @brief Set the frame step.
-    void set_frame_step(int frame_step) noexcept { _frame_step = frame_step; }
+    void set_frame_step(int frame_step) noexcept
+    {
+        mark_modified();
+        _frame_step = frame_step;
+    }
 
     /// @brief Return the frame rate.
     double rate() const noexcept { return _rate; }
 
     /// @brief Set the frame rate.
-    void set_rate(double rate) noexcept { _rate = rate; }
+    void set_rate(double rate) noexcept
+    {
+        mark_modified();
+        _rate = rate;
+    }
 
     /// @brief Return the frame number zero padding.
     int frame_zero_padding() const noexcept { return _frame_zero_padding; }
@@ -119,6 +131,7 @@ public:
     /// @brief Set the frame number zero padding.
     void set_frame_zero_padding(int frame_zero_padding) noexcept
     {
+        mark_modified();
         _frame_zero_padding = frame_zero_padding;
     }
 
@@ -162,6 +175,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string        _target_url_base;
     std::string        _name_prefix;
@@ -0,0 +1,432 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentimelineio/version.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
+
+/// @brief A static interval tree of values with time ranges.
+///
+/// The values are sorted by the start of their ranges and laid out as an
+/// implicit balanced binary tree, where each node also records the latest
+/// end of the ranges below it. A query only descends into the subtrees that
+/// can hold a result, so it takes O(log n + k) time for k results, rather
+/// than testing every range.
+///
+/// The tree can't be modified; it is built again from all the values when
+/// they change, or merged from the trees of parts of them (see merged()).
+template <typename T>
+class IntervalTree
+{
+public:
+    /// @brief Create an empty tree.
+    IntervalTree() = default;
+
+    /// @brief Create a tree of the given values.
+    ///
+    /// @param values The values.
+    /// @param range_of A function returning the TimeRange of a value.
+    template <typename RangeFunction>
+    IntervalTree(std::vector<T> values, RangeFunction range_of);
+
+    /// @brief Create a tree of the values of several trees.
+    ///
+    /// The result is the tree of all their values in the order of the
+    /// trees, but the values are merged rather than sorted again, in
+    /// O(n log k) time for n values in k trees.
+    ///
+    /// @param trees The trees.
+    static IntervalTree merged(std::vector<IntervalTree const*> const& trees);
+
+    /// @brief Return the number of values.
+    size_t size() const noexcept { return _values.size(); }
+
+    /// @brief Return whether the tree is empty.
+    bool empty() const noexcept { return _values.empty(); }
+
+    /// @brief Return the values, in order of start time.
+    std::vector<T> const& values() const noexcept { return _values; }
+
+    /// @brief Call a function with each value whose range intersects the
+    /// given range (see TimeRange::intersects()), in order of start time.
+    template <typename Function>
+    void for_each_intersecting(
+        TimeRange const& search_range,
+        Function&&       function,
+        double           epsilon_s = opentime::DEFAULT_EPSILON_s) const
+    {
+        _for_each_intersecting(
+            0,
+            _values.size(),
+            search_range.start_time().to_seconds(),
+            search_range.end_time_exclusive().to_seconds(),
+            epsilon_s,
+            function);
+    }
+
+    /// @brief Call a function with each value whose range contains the
+    /// given time (see TimeRange::contains()), in order of start time.
+    template <typename Function>
+    void for_each_containing(RationalTime time, Function&& function) const
+    {
+        _for_each_containing(0, _values.size(), time.to_seconds(), function);
+    }
+
+    /// @brief Call a function with the values whose ranges are nearest to
+    /// the given time, nearest first, up to the given count.
+    ///
+    /// The distance is zero for the ranges that contain the time, which
+    /// come first in order of start time, and otherwise the distance from
+    /// the time to the start or end of the range; of two values at the same
+    /// distance, the earlier one comes first.
+    template <typename Function>
+    void for_each_nearest(
+        RationalTime time,
+        size_t       count,
+        Function&&   function) const;
+
+private:
+    // Return whether a range that starts at a goes before one that starts
+    // at b; the ranges that don't have a start go last.
+    static bool _starts_before(double a, double b) noexcept
+    {
+        return a < b || (!std::isnan(a) && std::isnan(b));
+    }
+
+    double _build_max_ends(size_t begin, size_t end);
+
+    template <typename Function>
+    void _for_each_containing(
+        size_t    begin,
+        size_t    end,
+        double    time_s,
+        Function& function) const;
+
+    template <typename Function>
+    void _for_each_intersecting(
+        size_t    begin,
+        size_t    end,
+        double    start_s,
+        double    end_s,
+        double    epsilon_s,
+        Function& function) const;
+
+    std::vector<T> _values;
+
+    // The start and end of each range in seconds, computed as
+    // TimeRange::intersects() does, and the latest end in the subtree of
+    // each node.
+    std::vector<double> _starts;
+    std::vector<double> _ends;
+    std::vector<double> _max_ends;
+
+    // The number of ranges with a start, and the indices of the ranges with
+    // an end in order of end, for the nearest values.
+    size_t              _start_count = 0;
+    std::vector<size_t> _by_end;
+};
+
+template <typename T>
+template <typename RangeFunction>
+inline IntervalTree<T>::IntervalTree(
+    std::vector<T> values,
+    RangeFunction  range_of)
+{
+    const size_t        count = values.size();
+    std::vector<double> starts(count);
+    std::vector<double> ends(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const TimeRange range = range_of(values[i]);
+        const double    end   = range.end_time_exclusive().to_seconds();
+        starts[i]             = range.start_time().to_seconds();
+
+        // a range without an end intersects nothing, and must not hide the
+        // other ranges from the latest ends
+        ends[i] = std::isnan(end) ? -std::numeric_limits<double>::infinity()
+                                  : end;
+    }
+
+    // values that start together keep their order, and ranges that don't
+    // have a start (e.g. with a zero rate) go last
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return _starts_before(starts[a], starts[b]);
+    });
+
+    _values.reserve(count);
+    _starts.reserve(count);
+    _ends.reserve(count);
+    for (const size_t i: order)
+    {
+        _values.push_back(std::move(values[i]));
+        _starts.push_back(starts[i]);
+        _ends.push_back(ends[i]);
+    }
+    _max_ends.resize(count);
+    _build_max_ends(0, count);
+
+    _start_count = size_t(
+        std::find_if(
+            _starts.begin(),
+            _starts.end(),
+            [](double start) { return std::isnan(start); })
+        - _starts.begin());
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!std::isinf(_ends[i]))
+        {
+            _by_end.push_back(i);
+        }
+    }
+    std::stable_sort(_by_end.begin(), _by_end.end(), [&](size_t a, size_t b) {
+        return _ends[a] < _ends[b];
+    });
+}
+
+// Merge the runs of the order in pairs until one is left; the merges are
+// stable, so of two values that go together, the one of the earlier run
+// goes first.
+template <typename Compare>
+inline void
+_merge_runs(
+    std::vector<size_t>& order,
+    std::vector<size_t>  bounds,
+    Compare              compare)
+{
+    while (bounds.size() > 2)
+    {
+        std::vector<size_t> merged_bounds = { 0 };
+        size_t              r             = 0;
+        for (; r + 2 < bounds.size(); r += 2)
+        {
+            std::inplace_merge(
+                order.begin() + bounds[r],
+                order.begin() + bounds[r + 1],
+                order.begin() + bounds[r + 2],
+                compare);
+            merged_bounds.push_back(bounds[r + 2]);
+        }
+        if (r + 1 < bounds.size())
+        {
+            merged_bounds.push_back(bounds[r + 1]);
+        }
+        bounds = std::move(merged_bounds);
+    }
+}
+
+template <typename T>
+inline IntervalTree<T>
+IntervalTree<T>::merged(std::vector<IntervalTree const*> const& trees)
+{
+    // the values of the trees one after the other, as runs in order of
+    // start, which are merged into the order of all of them
+    std::vector<double> starts;
+    std::vector<size_t> trees_of;
+    std::vector<size_t> bounds = { 0 };
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+        starts.insert(
+            starts.end(),
+            trees[t]->_starts.begin(),
+            trees[t]->_starts.end());
+        trees_of.resize(starts.size(), t);
+        bounds.push_back(starts.size());
+    }
+    const size_t        count = starts.size();
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    _merge_runs(order, bounds, [&starts](size_t a, size_t b) {
+        return _starts_before(starts[a], starts[b]);
+    });
+
+    IntervalTree        result;
+    std::vector<size_t> indices(count);
+    result._values.reserve(count);
+    result._starts.reserve(count);
+    result._ends.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t t = trees_of[order[i]];
+        const size_t j = order[i] - bounds[t];
+        indices[order[i]] = i;
+        result._values.push_back(trees[t]->_values[j]);
+        result._starts.push_back(starts[order[i]]);
+        result._ends.push_back(trees[t]->_ends[j]);
+    }
+    result._max_ends.resize(count);
+    result._build_max_ends(0, count);
+
+    // the ranges in order of end, of which the ones earlier in the result go
+    // first when they end together
+    std::vector<size_t> end_bounds = { 0 };
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+        result._start_count += trees[t]->_start_count;
+        for (const size_t j: trees[t]->_by_end)
+        {
+            result._by_end.push_back(indices[bounds[t] + j]);
+        }
+        end_bounds.push_back(result._by_end.size());
+    }
+    auto const& ends = result._ends;
+    _merge_runs(result._by_end, end_bounds, [&ends](size_t a, size_t b) {
+        return ends[a] < ends[b] || (!(ends[b] < ends[a]) && a < b);
+    });
+    return result;
+}
+
+// The node of the values [begin, end) is the one in the middle, and the
+// values before and after it are its subtrees.
+template <typename T>
+inline double
+IntervalTree<T>::_build_max_ends(size_t begin, size_t end)
+{
+    if (begin >= end)
+    {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    const size_t middle = begin + (end - begin) / 2;
+    const double before = _build_max_ends(begin, middle);
+    const double after  = _build_max_ends(middle + 1, end);
+    _max_ends[middle]   = std::max(_ends[middle], std::max(before, after));
+    return _max_ends[middle];
+}
+
+template <typename T>
+template <typename Function>
+inline void
+IntervalTree<T>::_for_each_intersecting(
+    size_t    begin,
+    size_t    end,
+    double    start_s,
+    double    end_s,
+    double    epsilon_s,
+    Function& function) const
+{
+    while (begin < end)
+    {
+        const size_t middle = begin + (end - begin) / 2;
+
+        // nothing below this node ends late enough
+        if (!(_max_ends[middle] - start_s >= epsilon_s))
+        {
+            return;
+        }
+
+        _for_each_intersecting(
+            begin,
+            middle,
+            start_s,
+            end_s,
+            epsilon_s,
+            function);
+
+        // this node, and everything after it, starts too late
+        if (!(end_s - _starts[middle] >= epsilon_s))
+        {
+            return;
+        }
+
+        if (_ends[middle] - start_s >= epsilon_s)
+        {
+            function(_values[middle]);
+        }
+        begin = middle + 1;
+    }
+}
+
+template <typename T>
+template <typename Function>
+inline void
+IntervalTree<T>::_for_each_containing(
+    size_t    begin,
+    size_t    end,
+    double    time_s,
+    Function& function) const
+{
+    while (begin < end)
+    {
+        const size_t middle = begin + (end - begin) / 2;
+        if (!(time_s < _max_ends[middle]))
+        {
+            return;
+        }
+
+        _for_each_containing(begin, middle, time_s, function);
+        if (!(_starts[middle] <= time_s))
+        {
+            return;
+        }
+
+        if (time_s < _ends[middle])
+        {
+            function(_values[middle]);
+        }
+        begin = middle + 1;
+    }
+}
+
+template <typename T>
+template <typename Function>
+inline void
+IntervalTree<T>::for_each_nearest(
+    RationalTime time,
+    size_t       count,
+    Function&&   function) const
+{
+    size_t found = 0;
+    for_each_containing(time, [&](T const& value) {
+        if (found < count)
+        {
+            function(value);
+            ++found;
+        }
+    });
+
+    // Then walk forward through the ranges that start after the time, and
+    // back through the ranges that end at or before it, taking the nearer
+    // of the two each time.
+    const double time_s = time.to_seconds();
+    const auto   starts = _starts.begin();
+    size_t       after  = size_t(
+        std::upper_bound(starts, starts + _start_count, time_s) - starts);
+    size_t before = size_t(
+        std::upper_bound(
+            _by_end.begin(),
+            _by_end.end(),
+            time_s,
+            [&](double t, size_t i) { return t < _ends[i]; })
+        - _by_end.begin());
+    while (found < count && (after < _start_count || before > 0))
+    {
+        // a range with a negative duration can end before it starts
+        if (before > 0 && !(_starts[_by_end[before - 1]] <= time_s))
+        {
+            --before;
+            continue;
+        }
+
+        const bool take_before =
+            before > 0
+            && (after == _start_count
+                || time_s - _ends[_by_end[before - 1]]
+                       <= _starts[after] - time_s);
+        function(_values[take_before ? _by_end[--before] : after++]);
+        ++found;
+    }
+}
+
+}} // namespace opentimelineio::OPENTIMELINEIO_VERSION
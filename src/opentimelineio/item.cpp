@@ -24,10 +24,32 @@ Item::Item(
     , _markers(markers.begin(), markers.end())
     , _enabled(enabled)
     , _color(color)
-{}
+{
+    _link_held(_effects);
+    _link_held(_markers);
+}
 
 Item::~Item()
-{}
+{
+    _unlink_held(_effects);
+    _unlink_held(_markers);
+}
+
+std::vector<SerializableObject::Retainer<Effect>>&
+Item::effects() noexcept
+{
+    _unlink_held(_effects);
+    _watch_held();
+    return _effects;
+}
+
+std::vector<SerializableObject::Retainer<Marker>>&
+Item::markers() noexcept
+{
+    _unlink_held(_markers);
+    _watch_held();
+    return _markers;
+}
 
 bool
 Item::visible() const
@@ -174,10 +196,15 @@ Item::transformed_time_range(
 bool
 Item::read_from(Reader& reader)
 {
-    return reader.read_if_present("source_range", &_source_range)
-           && reader.read_if_present("effects", &_effects)
-           && reader.read_if_present("markers", &_markers)
-           && reader.read_if_present("enabled", &_enabled)
+    if (!reader.read_if_present("source_range", &_source_range)
+        || !reader.read_if_present("effects", &_effects)
+        || !reader.read_if_present("markers", &_markers))
+    {
+        return false;
+    }
+    _link_held(_effects);
+    _link_held(_markers);
+    return reader.read_if_present("enabled", &_enabled)
            && reader.read_if_present("color", &_color)
            && Parent::read_from(reader);
 }
@@ -193,4 +220,58 @@ Item::write_to(Writer& writer) const
     writer.write("color", _color);
 }
 
+void
+Item::_held_objects(std::vector<SerializableObject*>& held) const
+{
+    Parent::_held_objects(held);
+    for (auto const& effect: _effects)
+    {
+        held.push_back(effect.value);
+    }
+    for (auto const& marker: _markers)
+    {
+        held.push_back(marker.value);
+    }
+}
+
+SerializableObject*
+Item::_clone_instance() const
+{
+    return new Item;
+}
+
+bool
+Item::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& item = static_cast<Item const&>(source);
+    _source_range    = item._source_range;
+    _color           = item._color;
+    _enabled         = item._enabled;
+    if (!cloner.clone(item._effects, &_effects)
+        || !cloner.clone(item._markers, &_markers))
+    {
+        return false;
+    }
+    _link_held(_effects);
+    _link_held(_markers);
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Item::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& item = static_cast<Item const&>(other);
+    return comparer.equivalent(
+               "source_range",
+               _source_range,
+               item._source_range)
+           && comparer.equivalent("enabled", _enabled, item._enabled)
+           && comparer.equivalent("color", _color, item._color)
+           && Parent::_fields_equivalent_to(other, comparer)
+           && comparer.equivalent("effects", _effects, item._effects)
+           && comparer.equivalent("markers", _markers, item._markers);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
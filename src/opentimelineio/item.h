@@ -53,7 +53,11 @@ public:
     bool enabled() const { return _enabled; };
 
     /// @brief Set whether the item is enabled.
-    void set_enabled(bool enabled) { _enabled = enabled; }
+    void set_enabled(bool enabled)
+    {
+        mark_modified();
+        _enabled = enabled;
+    }
 
     /// @brief Return the source range of the item.
     std::optional<TimeRange> source_range() const noexcept
@@ -64,11 +68,12 @@ public:
     /// @brief Set the source range of the item.
     void set_source_range(std::optional<TimeRange> const& source_range)
     {
+        mark_modified();
         _source_range = source_range;
     }
 
     /// @brief Modify the list of effects.
-    std::vector<Retainer<Effect>>& effects() noexcept { return _effects; }
+    std::vector<Retainer<Effect>>& effects() noexcept;
 
     /// @brief Return the list of effects.
     std::vector<Retainer<Effect>> const& effects() const noexcept
@@ -77,7 +82,7 @@ public:
     }
 
     /// @brief Modify the list of markers.
-    std::vector<Retainer<Marker>>& markers() noexcept { return _markers; }
+    std::vector<Retainer<Marker>>& markers() noexcept;
 
     /// @brief Return the list of markers.
     std::vector<Retainer<Marker>> const& markers() const noexcept
@@ -127,6 +132,7 @@ public:
     /// @brief Set the color of the item.
     void set_color(std::optional<Color> const& color)
     {
+        mark_modified();
         _color = color;
     }
 
@@ -136,6 +142,13 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _held_objects(std::vector<SerializableObject*>&) const override;
+
 private:
     std::optional<TimeRange>      _source_range;
     std::vector<Retainer<Effect>> _effects;
@@ -31,4 +31,31 @@ LinearTimeWarp::write_to(Writer& writer) const
     writer.write("time_scalar", _time_scalar);
 }
 
+SerializableObject*
+LinearTimeWarp::_clone_instance() const
+{
+    return new LinearTimeWarp;
+}
+
+bool
+LinearTimeWarp::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    _time_scalar = static_cast<LinearTimeWarp const&>(source)._time_scalar;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+LinearTimeWarp::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    return comparer.equivalent(
+               "time_scalar",
+               _time_scalar,
+               static_cast<LinearTimeWarp const&>(other)._time_scalar)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -39,6 +39,7 @@ public:
     /// @brief Set the amount to scale the time.
     void set_time_scalar(double time_scalar) noexcept
     {
+        mark_modified();
         _time_scalar = time_scalar;
     }
 
@@ -48,6 +49,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     double _time_scalar;
 };
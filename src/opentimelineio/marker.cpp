@@ -39,4 +39,35 @@ Marker::write_to(Writer& writer) const
     writer.write("comment", _comment);
 }
 
+SerializableObject*
+Marker::_clone_instance() const
+{
+    return new Marker;
+}
+
+bool
+Marker::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& marker = static_cast<Marker const&>(source);
+    _color             = marker._color;
+    _marked_range      = marker._marked_range;
+    _comment           = marker._comment;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Marker::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& marker = static_cast<Marker const&>(other);
+    return comparer.equivalent("color", _color, marker._color)
+           && comparer.equivalent(
+               "marked_range",
+               _marked_range,
+               marker._marked_range)
+           && comparer.equivalent("comment", _comment, marker._comment)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
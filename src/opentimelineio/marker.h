@@ -59,7 +59,11 @@ public:
     std::string color() const noexcept { return _color; }
 
     /// @brief Set the marker color.
-    void set_color(std::string const& color) { _color = color; }
+    void set_color(std::string const& color)
+    {
+        mark_modified();
+        _color = color;
+    }
 
     /// @brief Return the marker time range.
     TimeRange marked_range() const noexcept { return _marked_range; }
@@ -67,6 +71,7 @@ public:
     /// @brief Set the marker time range.
     void set_marked_range(TimeRange const& marked_range) noexcept
     {
+        mark_modified();
         _marked_range = marked_range;
     }
 
@@ -74,7 +79,11 @@ public:
     std::string comment() const noexcept { return _comment; }
 
     /// @brief Set the marker comment.
-    void set_comment(std::string const& comment) { _comment = comment; }
+    void set_comment(std::string const& comment)
+    {
+        mark_modified();
+        _comment = comment;
+    }
 
 protected:
     virtual ~Marker();
@@ -82,6 +91,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string _color;
     TimeRange   _marked_range;
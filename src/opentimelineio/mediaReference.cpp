@@ -42,4 +42,38 @@ MediaReference::write_to(Writer& writer) const
     writer.write("available_image_bounds", _available_image_bounds);
 }
 
+SerializableObject*
+MediaReference::_clone_instance() const
+{
+    return new MediaReference;
+}
+
+bool
+MediaReference::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& reference   = static_cast<MediaReference const&>(source);
+    _available_range        = reference._available_range;
+    _available_image_bounds = reference._available_image_bounds;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+MediaReference::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& reference = static_cast<MediaReference const&>(other);
+    return comparer.equivalent(
+               "available_range",
+               _available_range,
+               reference._available_range)
+           && comparer.equivalent(
+               "available_image_bounds",
+               _available_image_bounds,
+               reference._available_image_bounds)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -47,6 +47,7 @@ public:
     /// @brief Set the available range of the media reference.
     void set_available_range(std::optional<TimeRange> const& available_range)
     {
+        mark_modified();
         _available_range = available_range;
     }
 
@@ -63,6 +64,7 @@ public:
     void set_available_image_bounds(
         std::optional<IMATH_NAMESPACE::Box2d> const& available_image_bounds)
     {
+        mark_modified();
         _available_image_bounds = available_image_bounds;
     }
 
@@ -72,6 +74,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::optional<TimeRange>              _available_range;
     std::optional<IMATH_NAMESPACE::Box2d> _available_image_bounds;
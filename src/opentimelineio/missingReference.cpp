@@ -34,4 +34,10 @@ MissingReference::write_to(Writer& writer) const
     Parent::write_to(writer);
 }
 
+SerializableObject*
+MissingReference::_clone_instance() const
+{
+    return new MissingReference;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
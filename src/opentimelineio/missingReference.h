@@ -44,6 +44,8 @@ protected:
 
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
+
+    SerializableObject* _clone_instance() const override;
 };
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
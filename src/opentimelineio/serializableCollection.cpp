@@ -13,14 +13,20 @@ SerializableCollection::SerializableCollection(
     AnyDictionary const&             metadata)
     : Parent(name, metadata)
     , _children(children.begin(), children.end())
-{}
+{
+    _link_held(_children);
+}
 
 SerializableCollection::~SerializableCollection()
-{}
+{
+    _unlink_held(_children);
+}
 
 void
 SerializableCollection::clear_children()
 {
+    mark_modified();
+    _unlink_held(_children);
     _children.clear();
 }
 
@@ -28,12 +34,17 @@ void
 SerializableCollection::set_children(
     std::vector<SerializableObject*> const& children)
 {
+    mark_modified();
+    _unlink_held(_children);
     _children = decltype(_children)(children.begin(), children.end());
+    _link_held(_children);
 }
 
 void
 SerializableCollection::insert_child(int index, SerializableObject* child)
 {
+    mark_modified();
+    _link_held(child);
     index = adjusted_vector_index(index, _children);
     if (index >= int(_children.size()))
     {
@@ -51,6 +62,7 @@ SerializableCollection::set_child(
     SerializableObject* child,
     ErrorStatus*        error_status)
 {
+    mark_modified();
     index = adjusted_vector_index(index, _children);
     if (index < 0 || index >= int(_children.size()))
     {
@@ -61,13 +73,19 @@ SerializableCollection::set_child(
         return false;
     }
 
-    _children[index] = child;
+    if (_children[index] != child)
+    {
+        _unlink_held(_children[index]);
+        _link_held(child);
+        _children[index] = child;
+    }
     return true;
 }
 
 bool
 SerializableCollection::remove_child(int index, ErrorStatus* error_status)
 {
+    mark_modified();
     if (_children.empty())
     {
         if (error_status)
@@ -81,11 +99,14 @@ SerializableCollection::remove_child(int index, ErrorStatus* error_status)
 
     if (size_t(index) >= _children.size())
     {
+        _unlink_held(_children.back());
         _children.pop_back();
     }
     else
     {
-        _children.erase(_children.begin() + std::max(index, 0));
+        index = std::max(index, 0);
+        _unlink_held(_children[index]);
+        _children.erase(_children.begin() + index);
     }
 
     return true;
@@ -94,7 +115,12 @@ SerializableCollection::remove_child(int index, ErrorStatus* error_status)
 bool
 SerializableCollection::read_from(Reader& reader)
 {
-    return reader.read("children", &_children) && Parent::read_from(reader);
+    if (!reader.read("children", &_children))
+    {
+        return false;
+    }
+    _link_held(_children);
+    return Parent::read_from(reader);
 }
 
 void
@@ -113,4 +139,48 @@ SerializableCollection::find_clips(
     return find_children<Clip>(error_status, search_range, shallow_search);
 }
 
+void
+SerializableCollection::_held_objects(
+    std::vector<SerializableObject*>& held) const
+{
+    Parent::_held_objects(held);
+    for (auto const& child: _children)
+    {
+        held.push_back(child.value);
+    }
+}
+
+SerializableObject*
+SerializableCollection::_clone_instance() const
+{
+    return new SerializableCollection;
+}
+
+bool
+SerializableCollection::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& collection =
+        static_cast<SerializableCollection const&>(source);
+    _children.clear();
+    if (!cloner.clone(collection._children, &_children))
+    {
+        return false;
+    }
+    _link_held(_children);
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+SerializableCollection::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& collection =
+        static_cast<SerializableCollection const&>(other);
+    return Parent::_fields_equivalent_to(other, comparer)
+           && comparer.equivalent("children", _children, collection._children);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
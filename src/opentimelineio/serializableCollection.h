@@ -55,6 +55,8 @@ public:
     /// @brief Modify the list of children.
     std::vector<Retainer<SerializableObject>>& children() noexcept
     {
+        _unlink_held(_children);
+        _watch_held();
         return _children;
     }
 
@@ -107,6 +109,13 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _held_objects(std::vector<SerializableObject*>&) const override;
+
 private:
     std::vector<Retainer<SerializableObject>> _children;
 };
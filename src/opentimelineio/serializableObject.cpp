@@ -7,10 +7,45 @@
 #include "stringUtils.h"
 #include "typeRegistry.h"
 
+#include <algorithm>
+
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
+std::atomic<uint64_t> SerializableObject::_next_revision{ 1 };
+
+static bool
+_value_holds_objects(std::any const& value)
+{
+    if (value.type() == typeid(SerializableObject::Retainer<>))
+    {
+        return true;
+    }
+    if (value.type() == typeid(AnyDictionary))
+    {
+        for (auto const& e: std::any_cast<AnyDictionary const&>(value))
+        {
+            if (_value_holds_objects(e.second))
+            {
+                return true;
+            }
+        }
+    }
+    if (value.type() == typeid(AnyVector))
+    {
+        for (auto const& e: std::any_cast<AnyVector const&>(value))
+        {
+            if (_value_holds_objects(e))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 SerializableObject::SerializableObject()
     : _cached_type_record(nullptr)
+    , _revision(_next_revision.fetch_add(1, std::memory_order_relaxed))
 {
     _managed_ref_count = 0;
 }
@@ -57,6 +92,265 @@ SerializableObject::_type_record() const
     return _cached_type_record;
 }
 
+void
+SerializableObject::mark_modified() noexcept
+{
+    const uint64_t revision =
+        _next_revision.fetch_add(1, std::memory_order_relaxed);
+    for (SerializableObject* object = this; object; object = object->_holder)
+    {
+        object->_revision.store(revision, std::memory_order_release);
+    }
+}
+
+void
+SerializableObject::_expose() noexcept
+{
+    if (!_exposed)
+    {
+        _exposed = true;
+        _add_exposed_counts(1, 0);
+    }
+}
+
+void
+SerializableObject::_expose_dictionary() noexcept
+{
+    if (!_dictionary_exposed)
+    {
+        _dictionary_exposed = true;
+        _add_exposed_counts(0, 1);
+    }
+}
+
+void
+SerializableObject::_watch_held() noexcept
+{
+    if (!_watch)
+    {
+        _watch = std::make_unique<_Watch>();
+    }
+    if (!_watch->held)
+    {
+        _watch->held           = true;
+        _watch->held_revisions = _held_revisions();
+        _add_exposed_counts(1, 0);
+    }
+}
+
+void
+SerializableObject::_watch_dictionaries() noexcept
+{
+    if (!_watch)
+    {
+        _watch = std::make_unique<_Watch>();
+    }
+    if (!_watch->dictionaries)
+    {
+        _watch->dictionaries      = true;
+        _watch->dictionaries_hash = _dictionaries_hash();
+        _add_exposed_counts(0, 1);
+    }
+}
+
+void
+SerializableObject::_held_objects(std::vector<SerializableObject*>&) const
+{}
+
+void
+SerializableObject::_dictionaries(
+    std::vector<AnyDictionary const*>& dictionaries) const
+{
+    dictionaries.push_back(&_dynamic_fields);
+}
+
+std::vector<std::pair<SerializableObject const*, uint64_t>>
+SerializableObject::_held_revisions() const
+{
+    std::vector<SerializableObject*> held;
+    _held_objects(held);
+
+    // an object that took the place of another always has a different
+    // revision, even at the same address
+    std::vector<std::pair<SerializableObject const*, uint64_t>> revisions;
+    revisions.reserve(held.size());
+    for (auto object: held)
+    {
+        revisions.emplace_back(object, object ? object->revision() : 0);
+    }
+    return revisions;
+}
+
+bool
+SerializableObject::revalidate(bool including_dictionaries) const
+{
+    std::vector<SerializableObject const*> path;
+    return _revalidate(including_dictionaries, path);
+}
+
+bool
+SerializableObject::_revalidate(
+    bool                                    including_dictionaries,
+    std::vector<SerializableObject const*>& path) const
+{
+    if (!is_exposed(including_dictionaries))
+    {
+        return true;
+    }
+    if (std::find(path.begin(), path.end(), this) != path.end())
+    {
+        return false;
+    }
+    bool valid = !_exposed && !(including_dictionaries && _dictionary_exposed);
+
+    // the objects held first, so that their new revisions are compared
+    // below; those handed out aren't linked, and their exposure doesn't
+    // reach this object
+    const bool watching_held = _watch && _watch->held;
+    std::vector<SerializableObject*> held;
+    _held_objects(held);
+    path.push_back(this);
+    for (auto object: held)
+    {
+        if (object && (watching_held || object->_holder == this))
+        {
+            valid = object->_revalidate(including_dictionaries, path) && valid;
+        }
+    }
+    path.pop_back();
+
+    if (!_watch)
+    {
+        return valid;
+    }
+    bool modified = false;
+    if (watching_held)
+    {
+        auto revisions = _held_revisions();
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (revisions != _watch->held_revisions)
+        {
+            _watch->held_revisions.swap(revisions);
+            modified = true;
+        }
+    }
+    if (including_dictionaries && _watch->dictionaries)
+    {
+        // objects put in a dictionary through a reference expose it for
+        // good, as they would if they had been set
+        std::vector<AnyDictionary const*> dictionaries;
+        _dictionaries(dictionaries);
+        for (auto dictionary: dictionaries)
+        {
+            valid = valid && !_holds_objects(*dictionary);
+        }
+
+        const ContentHash           hash = _dictionaries_hash();
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (hash != _watch->dictionaries_hash)
+        {
+            _watch->dictionaries_hash = hash;
+            modified                  = true;
+        }
+    }
+    if (modified)
+    {
+        // the revision is bookkeeping rather than part of the object
+        const_cast<SerializableObject*>(this)->mark_modified();
+    }
+    return valid;
+}
+
+void
+SerializableObject::_add_exposed_counts(
+    int count,
+    int dictionary_count) noexcept
+{
+    for (SerializableObject* object = this; object; object = object->_holder)
+    {
+        object->_exposed_count += count;
+        object->_dictionary_exposed_count += dictionary_count;
+    }
+}
+
+void
+SerializableObject::_link_held(SerializableObject* held) noexcept
+{
+    if (!held)
+    {
+        return;
+    }
+
+    // the links always form trees, which mark_modified() relies on
+    bool linkable = !held->_holder;
+    for (SerializableObject* object = this; linkable && object;
+         object                     = object->_holder)
+    {
+        linkable = object != held;
+    }
+    if (!linkable)
+    {
+        _expose();
+        return;
+    }
+
+    held->_holder = this;
+    _add_exposed_counts(
+        held->_exposed_count,
+        held->_dictionary_exposed_count);
+}
+
+void
+SerializableObject::_unlink_held(SerializableObject* held) noexcept
+{
+    if (held && held->_holder == this)
+    {
+        _add_exposed_counts(
+            -held->_exposed_count,
+            -held->_dictionary_exposed_count);
+        held->_holder = nullptr;
+    }
+}
+
+bool
+SerializableObject::_holds_objects(AnyDictionary const& dictionary)
+{
+    for (auto const& e: dictionary)
+    {
+        if (_value_holds_objects(e.second))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+SerializableObject::_cached_content_hash(
+    ContentHash* hash,
+    bool         revalidated) const
+{
+    const uint64_t revision = _revision.load(std::memory_order_acquire);
+    if ((is_exposed() && !revalidated)
+        || _content_hash_revision.load(std::memory_order_acquire) != revision)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    *hash = _content_hash;
+    return _content_hash_revision.load(std::memory_order_relaxed) == revision;
+}
+
+void
+SerializableObject::_store_content_hash(ContentHash hash, uint64_t revision)
+    const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _content_hash = hash;
+    _content_hash_revision.store(revision, std::memory_order_release);
+}
+
 bool
 SerializableObject::_is_deletable()
 {
@@ -94,6 +388,10 @@ SerializableObject::read_from(Reader& reader)
             _dynamic_fields.emplace(e.first, std::move(e.second));
         }
     }
+    if (_holds_objects(_dynamic_fields))
+    {
+        _expose_dictionary();
+    }
     return true;
 }
 
@@ -112,17 +410,216 @@ SerializableObject::is_unknown_schema() const
     return false;
 }
 
+SerializableObject*
+SerializableObject::_clone_instance() const
+{
+    return nullptr;
+}
+
+bool
+SerializableObject::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    if (!cloner.clone(source._dynamic_fields, &_dynamic_fields))
+    {
+        return false;
+    }
+    if (_holds_objects(_dynamic_fields))
+    {
+        _expose_dictionary();
+    }
+    return true;
+}
+
+bool
+SerializableObject::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    return comparer.equivalent_entries(_dynamic_fields, other._dynamic_fields);
+}
+
+bool
+SerializableObject::_writes_downgraded(int) const
+{
+    return false;
+}
+
+void
+SerializableObject::_write_downgraded_to(Writer&, int) const
+{}
+
+bool
+SerializableObject::_has_native_fields() const
+{
+    auto type_record = _type_record();
+    int  state = type_record->native_fields.load(std::memory_order_relaxed);
+    if (state < 0)
+    {
+        // Subclasses the class doesn't know about and schemas defined
+        // outside of C++ get an object of some base class back here, and
+        // UnknownSchema gets nothing.
+        SerializableObject* instance = _clone_instance();
+        state = instance && typeid(*instance) == typeid(*this)
+                && instance->_type_record() == type_record;
+        if (instance)
+        {
+            instance->possibly_delete();
+        }
+        type_record->native_fields.store(state, std::memory_order_relaxed);
+    }
+    return state;
+}
+
+SerializableObject*
+SerializableObject::clone(ErrorStatus* error_status) const
+{
+    Cloner     cloner(error_status);
+    Retainer<> result(cloner.clone(this));
+    return cloner._has_errored ? nullptr : result.take_value();
+}
+
+SerializableObject*
+SerializableObject::Cloner::clone(SerializableObject const* value)
+{
+    if (!value)
+    {
+        return nullptr;
+    }
+
+    /*
+     * An object we are already in the middle of cloning can only be reached
+     * again through a cycle; hand back the (partial) clone, just as the
+     * writer would write a reference to it.  With instancing support every
+     * clone is remembered, so that shared instances stay shared.
+     */
+    auto e = _clones.find(value);
+    if (e != _clones.end())
+    {
+        return e->second;
+    }
+
+    if (!value->_has_native_fields())
+    {
+        ErrorStatus         error_status;
+        SerializableObject* result =
+            value->clone_via_serialization(&error_status);
+        if (!result)
+        {
+            error(error_status);
+        }
+        return result;
+    }
+
+    SerializableObject* result = value->_clone_instance();
+    Retainer<>          retainer(result);
+    _clones[value] = result;
+    bool ok        = result->_clone_fields_from(*value, *this);
+#ifndef OTIO_INSTANCING_SUPPORT
+    _clones.erase(value);
+#endif
+
+    if (!ok)
+    {
+        _has_errored = true;
+        return nullptr;
+    }
+    return retainer.take_value();
+}
+
+void
+SerializableObject::Cloner::error(ErrorStatus const& error_status)
+{
+    if (_error_status)
+    {
+        *_error_status = error_status;
+    }
+    _has_errored = true;
+}
+
+bool
+SerializableObject::Cloner::clone(std::any const& value, std::any* dest)
+{
+    std::type_info const& type = value.type();
+    if (type == typeid(Retainer<>))
+    {
+        Retainer<> result;
+        if (!clone(std::any_cast<Retainer<> const&>(value), &result))
+        {
+            return false;
+        }
+        *dest = std::move(result);
+    }
+    else if (type == typeid(AnyDictionary))
+    {
+        AnyDictionary result;
+        if (!clone(std::any_cast<AnyDictionary const&>(value), &result))
+        {
+            return false;
+        }
+        *dest = std::move(result);
+    }
+    else if (type == typeid(AnyVector))
+    {
+        AnyVector result;
+        if (!clone(std::any_cast<AnyVector const&>(value), &result))
+        {
+            return false;
+        }
+        *dest = std::move(result);
+    }
+    else
+    {
+        *dest = value;
+    }
+    return true;
+}
+
+bool
+SerializableObject::Cloner::clone(
+    AnyDictionary const& value,
+    AnyDictionary*       dest)
+{
+    for (auto const& e: value)
+    {
+        auto it = dest->emplace_hint(dest->end(), e.first, std::any());
+        if (!clone(e.second, &it->second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+SerializableObject::Cloner::clone(AnyVector const& value, AnyVector* dest)
+{
+    dest->reserve(dest->size() + value.size());
+    for (auto const& e: value)
+    {
+        dest->emplace_back();
+        if (!clone(e, &dest->back()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::string
 SerializableObject::to_json_string(
     ErrorStatus*              error_status,
     const schema_version_map* schema_version_targets,
-    int                       indent) const
+    int                       indent,
+    int                       max_threads) const
 {
     return serialize_json_to_string(
         std::any(Retainer<>(this)),
         schema_version_targets,
         error_status,
-        indent);
+        indent,
+        max_threads);
 }
 
 bool
@@ -130,14 +627,18 @@ SerializableObject::to_json_file(
     std::string const&        file_name,
     ErrorStatus*              error_status,
     const schema_version_map* schema_version_targets,
-    int                       indent) const
+    int                       indent,
+    int                       max_threads,
+    bool                      sync) const
 {
     return serialize_json_to_file(
         std::any(Retainer<>(this)),
         file_name,
         schema_version_targets,
         error_status,
-        indent);
+        indent,
+        max_threads,
+        sync);
 }
 
 SerializableObject*
@@ -16,13 +16,16 @@
 #include "Imath/ImathBox.h"
 #include "serialization.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 class CloningEncoder;
+class HashingEncoder;
 
 /// @brief A serializable object.
 class SerializableObject
@@ -55,21 +58,30 @@ public:
     /// @param error_status The return status.
     /// @param target_family_label_spec @todo Add comment.
     /// @param indent The number of spaces to use for indentation.
+    /// @param max_threads The maximum number of threads used to encode
+    /// independent subtrees, see serialize_json_to_file().
+    /// @param sync Whether to flush the file to disk before closing it, see
+    /// serialize_json_to_file().
     bool to_json_file(
         std::string const&        file_name,
         ErrorStatus*              error_status             = nullptr,
         const schema_version_map* target_family_label_spec = nullptr,
-        int                       indent                   = 4) const;
+        int                       indent                   = 4,
+        int                       max_threads              = 1,
+        bool                      sync                     = false) const;
 
     /// @brief Serialize this object to a JSON string.
     ///
     /// @param error_status The return status.
     /// @param target_family_label_spec @todo Add comment.
     /// @param indent The number of spaces to use for indentation.
+    /// @param max_threads The maximum number of threads used to encode
+    /// independent subtrees, see serialize_json_to_string().
     std::string to_json_string(
         ErrorStatus*              error_status             = nullptr,
         const schema_version_map* target_family_label_spec = nullptr,
-        int                       indent                   = 4) const;
+        int                       indent                   = 4,
+        int                       max_threads              = 1) const;
 
     /// @brief Deserialize this object from a JSON file.
     ///
@@ -88,21 +100,139 @@ public:
         ErrorStatus*       error_status = nullptr);
 
     /// @brief Return whether this object is equivalent to another.
-    bool is_equivalent_to(SerializableObject const& other) const;
+    ///
+    /// Two objects are equivalent when they would serialize to the same
+    /// data.  The core schemas are compared field by field, stopping at the
+    /// first difference; other objects are compared through serialization.
+    ///
+    /// @param other The object to compare with.
+    /// @param difference_path If given and the objects differ, set to the
+    /// "/" separated keys (and array indices) leading to the first
+    /// difference, e.g. "tracks/children/0/children/3/source_range".  It is
+    /// left empty when the objects themselves have different schemas.
+    bool is_equivalent_to(
+        SerializableObject const& other,
+        std::string*              difference_path = nullptr) const;
+
+    /// @brief A 128-bit content hash, see content_hash().
+    struct ContentHash
+    {
+        uint64_t high = 0;
+        uint64_t low  = 0;
+
+        /// @brief Return the hash as 32 hexadecimal digits.
+        std::string to_string() const;
+
+        friend bool operator==(ContentHash lhs, ContentHash rhs) noexcept
+        {
+            return lhs.high == rhs.high && lhs.low == rhs.low;
+        }
+
+        friend bool operator!=(ContentHash lhs, ContentHash rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    /// @brief Return a hash of this object's content.
+    ///
+    /// The hash covers the schema name and version and every field of this
+    /// object and of the objects it holds, exactly as they would be
+    /// serialized, and is the same on every run and platform.  It is not a
+    /// cryptographic hash.
+    ///
+    /// Objects with equal hashes serialize identically, and so are
+    /// equivalent (see is_equivalent_to()).  The converse does not hold:
+    /// times at different rates, or ranges within epsilon of each other,
+    /// compare equal but hash differently.
+    ///
+    /// The hash of every object is cached, and reused for the objects it is
+    /// held by, for as long as its revision stays the same and it is not
+    /// exposed (see revision() and is_exposed()).
+    ///
+    /// If the object can't be serialized, an empty hash is returned and
+    /// error_status is set appropriately.
+    ContentHash content_hash(ErrorStatus* error_status = nullptr) const;
+
+    /// @brief Record that this object was modified.
+    ///
+    /// This gives the object, and the objects holding it, a new revision.
+    /// It is called by every function that modifies an object, so only code
+    /// that modifies an object's fields directly needs to call it.
+    void mark_modified() noexcept;
+
+    /// @brief Return the revision of this object.
+    ///
+    /// The revision is unique to this object and changes whenever it, or
+    /// one of the objects it holds, is modified, so anything computed from
+    /// an object can be cached for as long as its revision stays the same
+    /// and it is not exposed.
+    uint64_t revision() const noexcept
+    {
+        return _revision.load(std::memory_order_acquire);
+    }
+
+    /// @brief Return whether this object, or one of the objects it holds,
+    /// may have been modified without a change of revision.
+    ///
+    /// An object is exposed once it hands out a non-const reference into
+    /// its fields (such as metadata(), dynamic_fields() or Item::markers()),
+    /// since those can change at any time; revalidate() gives it a new
+    /// revision when they did.  An object is exposed for good when it holds
+    /// objects whose modifications don't reach it (such as objects in its
+    /// metadata, or a media reference shared with another clip).
+    ///
+    /// @param including_dictionaries Whether to count the dictionaries
+    /// (metadata, dynamic fields and generator parameters, and any objects
+    /// held in them), which anything computed only from the other fields,
+    /// such as the indices of a timeline, can leave out.
+    bool is_exposed(bool including_dictionaries = true) const noexcept
+    {
+        return _exposed_count > 0
+               || (including_dictionaries && _dictionary_exposed_count > 0);
+    }
+
+    /// @brief Give this object, and the objects it holds, a new revision if
+    /// they were modified through the references they handed out.
+    ///
+    /// Anything computed from an exposed object can be cached by its
+    /// revision, as long as the object is revalidated before each use of
+    /// the cache.  Only the objects that are exposed are visited.
+    ///
+    /// Returns whether the revision can be relied on, which is the case
+    /// unless this object, or one of the objects it holds, is exposed for
+    /// good.
+    ///
+    /// @param including_dictionaries Whether to check the dictionaries as
+    /// well (see is_exposed()).
+    bool revalidate(bool including_dictionaries = true) const;
 
     /// @brief Makes a (deep) clone of this instance.
     ///
-    /// Descendent objects are cloned as well.
+    /// Descendent objects are cloned as well.  The core schemas are copied
+    /// directly; other objects (such as UnknownSchema instances or schemas
+    /// defined in Python) are cloned through serialization.
     ///
     /// If the operation fails, nullptr is returned and error_status
     /// is set appropriately.
     SerializableObject* clone(ErrorStatus* error_status = nullptr) const;
 
+    /// @brief Makes a (deep) clone of this instance by serializing it and
+    /// reading the result back.
+    ///
+    /// This works for any object, but is slower than clone().
+    SerializableObject*
+    clone_via_serialization(ErrorStatus* error_status = nullptr) const;
+
     /// @brief Allow external system (e.g. Python, Swift) to add serializable
     /// fields on the fly.
     ///
     /// C++ implementations should have no need for this functionality.
-    AnyDictionary& dynamic_fields() { return _dynamic_fields; }
+    AnyDictionary& dynamic_fields()
+    {
+        _watch_dictionaries();
+        return _dynamic_fields;
+    }
 
     template <typename T = SerializableObject>
     struct Retainer;
@@ -218,6 +348,11 @@ public:
             std::map<std::string, SerializableObject*>   object_for_id;
             std::map<SerializableObject*, int>           line_number_for_object;
 
+            // The objects of data_for_object, which are kept until they are
+            // read in, since the value that holds one can be dropped before
+            // then (e.g. by a duplicate key, or by a schema upgrade).
+            std::vector<Retainer<>> objects;
+
             void finalize(error_function_t error_function)
             {
                 for (auto e: data_for_object)
@@ -232,6 +367,14 @@ public:
                     e.first->read_from(r);
                 }
             }
+
+            void clear()
+            {
+                data_for_object.clear();
+                object_for_id.clear();
+                line_number_for_object.clear();
+                objects.clear();
+            }
         };
 
         std::any _decode(_Resolver& resolver);
@@ -442,7 +585,8 @@ public:
             std::any const&           value,
             class Encoder&            encoder,
             const schema_version_map* downgrade_version_manifest = nullptr,
-            ErrorStatus*              error_status               = nullptr);
+            ErrorStatus*              error_status               = nullptr,
+            int                       max_threads                = 1);
 
         void write(std::string const& key, bool value);
         void write(std::string const& key, int64_t value);
@@ -481,6 +625,15 @@ public:
             write(key, retainer.value);
         }
 
+        /// Write a value that is already encoded as JSON text (such as
+        /// lazily read metadata).  Returns false without writing anything
+        /// if the encoder can't take the text as is; the caller should then
+        /// write the decoded value instead.
+        bool write_json_text(
+            std::string const& key,
+            char const*        json,
+            size_t             length);
+
     private:
         /// Convenience routines for converting various STL structures of specific
         /// types to a parallel hierarchy holding std::any.
@@ -573,6 +726,8 @@ public:
         void _build_dispatch_tables();
         void _write(std::string const& key, std::any const& value);
         void _encoder_write_key(std::string const& key);
+        bool _can_write_subtrees(AnyVector const& value) const;
+        void _write_subtrees(AnyVector const& value);
 
         bool _any_dict_equals(std::any const& lhs, std::any const& rhs);
         bool _any_array_equals(std::any const& lhs, std::any const& rhs);
@@ -599,6 +754,192 @@ public:
 
         class Encoder&            _encoder;
         const schema_version_map* _downgrade_version_manifest;
+        int                       _max_threads = 1;
+        friend class SerializableObject;
+        friend class TimelineStreamWriter;
+    };
+
+    /// @brief This class provides cloning functionality.
+    ///
+    /// A cloner is handed to _clone_fields_from(), which uses it to deep
+    /// clone the objects (and containers of objects) held by the source.
+    class Cloner
+    {
+    public:
+        /// @brief Return a clone of the given object, or null on error
+        /// (or if the object is null).
+        ///
+        /// Objects whose class supports it are copied directly; anything
+        /// else is cloned through serialization (see
+        /// SerializableObject::clone_via_serialization()).
+        SerializableObject* clone(SerializableObject const* value);
+
+        bool clone(std::any const& value, std::any* dest);
+        bool clone(AnyDictionary const& value, AnyDictionary* dest);
+        bool clone(AnyVector const& value, AnyVector* dest);
+
+        template <typename T>
+        bool clone(Retainer<T> const& value, Retainer<T>* dest)
+        {
+            if (!value)
+            {
+                *dest = Retainer<T>();
+                return true;
+            }
+
+            Retainer<> result(clone(value.value));
+            *dest = Retainer<T>(dynamic_cast<T*>(result.value));
+            return dest->value != nullptr;
+        }
+
+        template <typename T>
+        bool clone(
+            std::vector<Retainer<T>> const& value,
+            std::vector<Retainer<T>>*       dest)
+        {
+            dest->resize(value.size());
+            for (size_t i = 0; i < value.size(); ++i)
+            {
+                if (!clone(value[i], &(*dest)[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// @brief Record an error, failing the clone.
+        void error(ErrorStatus const& error_status);
+
+    private:
+        Cloner(ErrorStatus* error_status)
+            : _error_status(error_status)
+        {}
+
+        ErrorStatus* _error_status;
+        bool         _has_errored = false;
+
+        std::unordered_map<SerializableObject const*, SerializableObject*>
+            _clones;
+
+        friend class SerializableObject;
+    };
+
+    /// @brief This class provides structural comparison functionality.
+    ///
+    /// A comparer is handed to _fields_equivalent_to(), which uses it to
+    /// compare each field of two objects under the field's serialized key.
+    /// A comparison that finds a difference records where it is and returns
+    /// false, so implementations can simply chain them with &&.
+    class Comparer
+    {
+    public:
+        template <typename T>
+        bool equivalent(char const* key, T const& lhs, T const& rhs)
+        {
+            return lhs == rhs || _difference_at(key);
+        }
+
+        bool equivalent(
+            char const*     key,
+            std::any const& lhs,
+            std::any const& rhs);
+        bool equivalent(
+            char const*          key,
+            AnyDictionary const& lhs,
+            AnyDictionary const& rhs);
+        bool equivalent(
+            char const*      key,
+            AnyVector const& lhs,
+            AnyVector const& rhs);
+        bool equivalent(
+            char const*               key,
+            SerializableObject const* lhs,
+            SerializableObject const* rhs);
+
+        template <typename T>
+        bool equivalent(
+            char const*        key,
+            Retainer<T> const& lhs,
+            Retainer<T> const& rhs)
+        {
+            return equivalent(
+                key,
+                static_cast<SerializableObject const*>(lhs.value),
+                static_cast<SerializableObject const*>(rhs.value));
+        }
+
+        template <typename T>
+        bool equivalent(
+            char const*                     key,
+            std::vector<Retainer<T>> const& lhs,
+            std::vector<Retainer<T>> const& rhs)
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return _difference_at(key);
+            }
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                if (!_equivalent(lhs[i].value, rhs[i].value))
+                {
+                    _difference_at(i);
+                    return _difference_at(key);
+                }
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool equivalent(
+            char const*                               key,
+            std::map<std::string, Retainer<T>> const& lhs,
+            std::map<std::string, Retainer<T>> const& rhs)
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return _difference_at(key);
+            }
+            for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end();
+                 ++l, ++r)
+            {
+                if (l->first != r->first
+                    || !_equivalent(l->second.value, r->second.value))
+                {
+                    _difference_at(std::min(l->first, r->first).c_str());
+                    return _difference_at(key);
+                }
+            }
+            return true;
+        }
+
+        /// @brief Compare the entries of two dictionaries, as if they were
+        /// fields of the object being compared.
+        bool equivalent_entries(
+            AnyDictionary const& lhs,
+            AnyDictionary const& rhs);
+
+    private:
+        Comparer(std::string* difference_path)
+            : _difference_path(difference_path)
+        {}
+
+        bool _equivalent(std::any const& lhs, std::any const& rhs);
+        bool _equivalent(AnyVector const& lhs, AnyVector const& rhs);
+        bool _equivalent(
+            SerializableObject const* lhs,
+            SerializableObject const* rhs);
+
+        // Record that the difference found lies under the given key (or
+        // array index), and return false.
+        bool _difference_at(char const* key);
+        bool _difference_at(size_t index);
+
+        std::string* _difference_path;
+
+        std::unordered_map<SerializableObject const*, SerializableObject const*>
+            _in_progress;
+
         friend class SerializableObject;
     };
 
@@ -678,6 +1019,105 @@ protected:
 
     virtual std::string _schema_name_for_reference() const;
 
+    /// @brief Return a new, default constructed object of this class for
+    /// clone() to copy into, or null if the class can only be cloned through
+    /// serialization.
+    ///
+    /// Every class that overrides this must also override
+    /// _clone_fields_from() if it has fields of its own.
+    virtual SerializableObject* _clone_instance() const;
+
+    /// @brief Copy the fields of source, an object of the same class, into
+    /// this object, cloning the objects it holds through the cloner.
+    virtual bool _clone_fields_from(SerializableObject const& source, Cloner&);
+
+    /// @brief Return whether the fields of this object are equivalent to
+    /// those of other, an object of the same class, comparing them through
+    /// the comparer.
+    ///
+    /// Every class that overrides _clone_instance() must also override this
+    /// if it has fields of its own.
+    virtual bool
+    _fields_equivalent_to(SerializableObject const& other, Comparer&) const;
+
+    /// @brief Return whether this object can write itself in the layout of
+    /// the given, older, version of its schema.
+    ///
+    /// Objects that can't are downgraded by cloning them into a dictionary
+    /// and running the registered downgrade functions on it.
+    virtual bool _writes_downgraded(int schema_version) const;
+
+    /// @brief Write the fields of this object in the layout of the given,
+    /// older, version of its schema (see _writes_downgraded()).
+    virtual void
+    _write_downgraded_to(Writer& writer, int schema_version) const;
+
+    /// @brief Record that this object holds objects whose modifications
+    /// don't reach it, which exposes it for good (see is_exposed()).
+    void _expose() noexcept;
+
+    /// @brief Record that one of this object's dictionaries holds objects,
+    /// which exposes it for good (see is_exposed()).
+    void _expose_dictionary() noexcept;
+
+    /// @brief Record that a non-const reference to a list of the objects
+    /// this object holds was handed out.
+    ///
+    /// The objects must be unlinked first.  The object is exposed, and
+    /// revalidate() compares the objects it holds with those it held when
+    /// this was first called, or when it was last revalidated.
+    void _watch_held() noexcept;
+
+    /// @brief Record that a non-const reference into one of this object's
+    /// dictionaries was handed out.
+    ///
+    /// The object is exposed, and revalidate() compares its dictionaries
+    /// with what they held when this was first called, or when it was last
+    /// revalidated.
+    void _watch_dictionaries() noexcept;
+
+    /// @brief Add the objects this object holds, other than those in its
+    /// dictionaries, to a list.
+    virtual void _held_objects(std::vector<SerializableObject*>&) const;
+
+    /// @brief Add the dictionaries of this object to a list.
+    virtual void _dictionaries(std::vector<AnyDictionary const*>&) const;
+
+    /// @brief Link an object that this object holds to it, so that its
+    /// modifications give this object a new revision as well.
+    ///
+    /// An object is linked to one holder at most; a holder that can't be
+    /// linked to (because the object is held elsewhere already, or holds
+    /// this object) is exposed instead.  Every holder must unlink the
+    /// objects it links before it lets go of them, or is destroyed.
+    void _link_held(SerializableObject* held) noexcept;
+
+    /// @brief Undo _link_held(), if the object is linked to this object.
+    void _unlink_held(SerializableObject* held) noexcept;
+
+    /// @brief Link every object of a list to this object.
+    template <typename T>
+    void _link_held(std::vector<Retainer<T>> const& held) noexcept
+    {
+        for (auto const& object: held)
+        {
+            _link_held(object.value);
+        }
+    }
+
+    /// @brief Unlink every object of a list from this object.
+    template <typename T>
+    void _unlink_held(std::vector<Retainer<T>> const& held) noexcept
+    {
+        for (auto const& object: held)
+        {
+            _unlink_held(object.value);
+        }
+    }
+
+    /// @brief Return whether a dictionary holds any objects.
+    static bool _holds_objects(AnyDictionary const& dictionary);
+
 private:
     SerializableObject(SerializableObject const&)            = delete;
     SerializableObject& operator=(SerializableObject const&) = delete;
@@ -720,14 +1160,69 @@ private:
 
     TypeRegistry::_TypeRecord const* _type_record() const;
 
+    // Return whether clone() and is_equivalent_to() can work on this
+    // object's fields directly, i.e. whether its class overrides
+    // _clone_instance() and the other field functions.
+    bool _has_native_fields() const;
+
+    static bool
+    _equivalent_via_serialization(std::any const& lhs, std::any const& rhs);
+
     mutable TypeRegistry::_TypeRecord const* _cached_type_record;
     int                                      _managed_ref_count;
     std::function<void()>                    _external_keepalive_monitor;
 
     mutable std::mutex _mutex;
 
+    // Return whether the cached content hash is up to date, and if so,
+    // fetch it.  The hash of an exposed object is only up to date if it
+    // was revalidated.
+    bool _cached_content_hash(ContentHash* hash, bool revalidated = false)
+        const;
+    void _store_content_hash(ContentHash hash, uint64_t revision) const;
+
+    // Add to the exposed counts of this object and of its holders.
+    void _add_exposed_counts(int count, int dictionary_count) noexcept;
+
+    // What the references handed out by this object held when they were
+    // last checked (see _watch_held() and _watch_dictionaries()).
+    struct _Watch
+    {
+        bool held         = false;
+        bool dictionaries = false;
+
+        std::vector<std::pair<SerializableObject const*, uint64_t>>
+                    held_revisions;
+        ContentHash dictionaries_hash;
+    };
+
+    std::vector<std::pair<SerializableObject const*, uint64_t>>
+    _held_revisions() const;
+    ContentHash _dictionaries_hash() const;
+
+    // Revalidate this object, which is not on the path of objects being
+    // revalidated that lead to it (else the objects form a cycle).
+    bool _revalidate(
+        bool                                    including_dictionaries,
+        std::vector<SerializableObject const*>& path) const;
+
+    mutable ContentHash           _content_hash;
+    mutable std::atomic<uint64_t> _content_hash_revision{ 0 };
+
+    std::atomic<uint64_t> _revision;
+    SerializableObject*   _holder                   = nullptr;
+    int                   _exposed_count            = 0;
+    int                   _dictionary_exposed_count = 0;
+    bool                  _exposed                  = false;
+    bool                  _dictionary_exposed       = false;
+
+    std::unique_ptr<_Watch> _watch;
+
+    static std::atomic<uint64_t> _next_revision;
+
     AnyDictionary _dynamic_fields;
     friend class TypeRegistry;
+    friend class HashingEncoder;
 };
 
 template <class T, class U>
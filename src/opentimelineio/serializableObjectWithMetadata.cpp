@@ -2,24 +2,130 @@
 // Copyright Contributors to the OpenTimelineIO project
 
 #include "opentimelineio/serializableObjectWithMetadata.h"
+#include "stringUtils.h"
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
+// Return a read-only block holding the dictionary, which is left empty.
+static std::shared_ptr<const AnyDictionary>
+_share(AnyDictionary& dictionary)
+{
+    auto block = std::make_shared<AnyDictionary>();
+    block->swap(dictionary);
+    return block;
+}
+
 SerializableObjectWithMetadata::SerializableObjectWithMetadata(
     std::string const&   name,
     AnyDictionary const& metadata)
     : _name(name)
-    , _metadata(metadata)
-{}
+{
+    if (_holds_objects(metadata))
+    {
+        _metadata = metadata;
+        _expose_dictionary();
+    }
+    else if (!metadata.empty())
+    {
+        _shared_metadata = std::make_shared<AnyDictionary>(metadata);
+    }
+}
 
 SerializableObjectWithMetadata::~SerializableObjectWithMetadata()
 {}
 
+AnyDictionary&
+SerializableObjectWithMetadata::metadata() noexcept
+{
+    if (_shared_metadata)
+    {
+        // the block was never handed out, so when no clone shares it the
+        // dictionary is simply taken back
+        if (_shared_metadata.use_count() == 1)
+        {
+            _metadata.swap(const_cast<AnyDictionary&>(*_shared_metadata));
+        }
+        else
+        {
+            _metadata = *_shared_metadata;
+        }
+        _shared_metadata.reset();
+    }
+    _decoded_metadata();
+    _lazy_metadata = LazyMetadata();
+    _watch_dictionaries();
+    return _metadata;
+}
+
+AnyDictionary
+SerializableObjectWithMetadata::metadata() const noexcept
+{
+    return _decoded_metadata();
+}
+
+AnyDictionary const&
+SerializableObjectWithMetadata::_decoded_metadata() const noexcept
+{
+    if (_shared_metadata)
+    {
+        return *_shared_metadata;
+    }
+    if (!_metadata_decoded)
+    {
+        // the text was already parsed once, so this only fails if it was
+        // changed underneath us; the metadata is left empty in that case
+        _lazy_metadata.decode(&_metadata);
+        _metadata_decoded = true;
+    }
+    return _metadata;
+}
+
 bool
 SerializableObjectWithMetadata::read_from(Reader& reader)
 {
-    return reader.read_if_present("metadata", &_metadata)
-           && reader.read_if_present("name", &_name)
+    if (reader.has_key("metadata"))
+    {
+        std::any metadata;
+        if (!reader.read("metadata", &metadata))
+        {
+            return false;
+        }
+
+        _shared_metadata.reset();
+        if (metadata.type() == typeid(LazyMetadata))
+        {
+            _lazy_metadata    = std::any_cast<LazyMetadata const&>(metadata);
+            _metadata_decoded = false;
+            _metadata.clear();
+        }
+        else if (metadata.type() == typeid(AnyDictionary))
+        {
+            auto& dictionary = std::any_cast<AnyDictionary&>(metadata);
+            _metadata.clear();
+            if (_holds_objects(dictionary))
+            {
+                _metadata.swap(dictionary);
+                _expose_dictionary();
+            }
+            else if (!dictionary.empty())
+            {
+                _shared_metadata = _share(dictionary);
+            }
+        }
+        else
+        {
+            reader.error(ErrorStatus(
+                ErrorStatus::TYPE_MISMATCH,
+                string_printf(
+                    "expected type %s under key 'metadata': found type %s "
+                    "instead",
+                    type_name_for_error_message<AnyDictionary>().c_str(),
+                    type_name_for_error_message(metadata.type()).c_str())));
+            return false;
+        }
+    }
+
+    return reader.read_if_present("name", &_name)
            && SerializableObject::read_from(reader);
 }
 
@@ -27,8 +133,98 @@ void
 SerializableObjectWithMetadata::write_to(Writer& writer) const
 {
     SerializableObject::write_to(writer);
-    writer.write("metadata", _metadata);
+    if (!_lazy_metadata.buffer
+        || !writer.write_json_text(
+            "metadata",
+            _lazy_metadata.buffer.get() + _lazy_metadata.offset,
+            _lazy_metadata.length))
+    {
+        writer.write("metadata", _decoded_metadata());
+    }
     writer.write("name", _name);
 }
 
+void
+SerializableObjectWithMetadata::_dictionaries(
+    std::vector<AnyDictionary const*>& dictionaries) const
+{
+    Parent::_dictionaries(dictionaries);
+    dictionaries.push_back(&_decoded_metadata());
+}
+
+SerializableObject*
+SerializableObjectWithMetadata::_clone_instance() const
+{
+    return new SerializableObjectWithMetadata;
+}
+
+bool
+SerializableObjectWithMetadata::_clone_fields_from(
+    SerializableObject const& source,
+    Cloner&                   cloner)
+{
+    auto const& object =
+        static_cast<SerializableObjectWithMetadata const&>(source);
+    _name = object._name;
+    if (object.is_metadata_lazy())
+    {
+        // lazily read metadata never holds objects, so the text is shared
+        _lazy_metadata    = object._lazy_metadata;
+        _metadata_decoded = false;
+    }
+    else if (object._shared_metadata)
+    {
+        _shared_metadata = object._shared_metadata;
+    }
+    else if (_holds_objects(object._metadata))
+    {
+        if (!cloner.clone(object._metadata, &_metadata))
+        {
+            return false;
+        }
+        _expose_dictionary();
+    }
+    else if (!object._metadata.empty())
+    {
+        /*
+         * Metadata is only held outside of a shared block once a reference
+         * to it was handed out by metadata(), after which it may be
+         * modified at any time, so it is copied.  The copy stays read-only,
+         * and is passed on to clones of the clone until one of them
+         * modifies its metadata.
+         */
+        AnyDictionary copy(object._metadata);
+        _shared_metadata = _share(copy);
+    }
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+SerializableObjectWithMetadata::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& object =
+        static_cast<SerializableObjectWithMetadata const&>(other);
+    if (!comparer.equivalent("name", _name, object._name))
+    {
+        return false;
+    }
+
+    // metadata shared by clones (or read lazily from the same text) is
+    // equivalent without looking inside
+    bool const same_metadata =
+        (_shared_metadata && _shared_metadata == object._shared_metadata)
+        || (_lazy_metadata.buffer
+            && _lazy_metadata.buffer == object._lazy_metadata.buffer
+            && _lazy_metadata.offset == object._lazy_metadata.offset
+            && _lazy_metadata.length == object._lazy_metadata.length);
+    return (same_metadata
+            || comparer.equivalent(
+                "metadata",
+                _decoded_metadata(),
+                object._decoded_metadata()))
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -6,6 +6,8 @@
 #include "opentimelineio/serializableObject.h"
 #include "opentimelineio/version.h"
 
+#include <memory>
+
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 /// @brief A serializable object with metadata.
@@ -33,13 +35,59 @@ public:
     std::string name() const noexcept { return _name; }
 
     /// @brief Set the object name.
-    void set_name(std::string const& name) { _name = name; }
+    void set_name(std::string const& name)
+    {
+        mark_modified();
+        _name = name;
+    }
 
     /// @brief Modify the object metadata.
-    AnyDictionary& metadata() noexcept { return _metadata; }
+    ///
+    /// Metadata that was read lazily is decoded first, and is no longer
+    /// written out verbatim afterwards.  Metadata shared with other clones
+    /// is copied first.
+    AnyDictionary& metadata() noexcept;
 
     /// @brief Return the object metadata.
-    AnyDictionary metadata() const noexcept { return _metadata; }
+    ///
+    /// Metadata that was read lazily is decoded first.  This is not safe to
+    /// call concurrently on an object whose metadata has not been decoded.
+    AnyDictionary metadata() const noexcept;
+
+    /// @brief The undecoded JSON text of an object's metadata, as kept by
+    /// the JSON readers in lazy metadata mode (see
+    /// deserialize_json_from_string()).
+    struct LazyMetadata
+    {
+        /// The input that was read, which stays alive (as a string or a
+        /// file mapping) while any object refers to it.
+        std::shared_ptr<const char> buffer;
+        size_t                      offset = 0;
+        size_t                      length = 0;
+
+        /// @brief Decode the metadata.
+        bool decode(AnyDictionary* result, ErrorStatus* error_status = nullptr)
+            const;
+    };
+
+    /// @brief Return whether the metadata is still held as undecoded JSON
+    /// text.
+    bool is_metadata_lazy() const noexcept { return bool(_lazy_metadata.buffer); }
+
+    /// @brief Return whether the metadata is held in a read-only block that
+    /// clones of this object share.
+    ///
+    /// Metadata that holds no objects is kept in such a block when it is
+    /// constructed or read, and clone() shares the block without copying
+    /// it, until an object modifies its metadata through metadata().  A
+    /// block that is no longer shared is taken back without a copy; one
+    /// that is gets copied.  Metadata that was handed out by metadata() is
+    /// copied into a new block by the first clone, since it may still be
+    /// modified through the reference.
+    ///
+    /// Only metadata is shared: the objects a clone holds are always new
+    /// objects, since each of them has an identity and a parent of its own.
+    bool is_metadata_shared() const noexcept { return bool(_shared_metadata); }
 
 protected:
     virtual ~SerializableObjectWithMetadata();
@@ -47,9 +95,22 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _dictionaries(std::vector<AnyDictionary const*>&) const override;
+
 private:
-    std::string   _name;
-    AnyDictionary _metadata;
+    AnyDictionary const& _decoded_metadata() const noexcept;
+
+    std::string           _name;
+    mutable AnyDictionary _metadata;
+    mutable LazyMetadata  _lazy_metadata;
+    mutable bool          _metadata_decoded = true;
+
+    std::shared_ptr<const AnyDictionary> _shared_metadata;
 };
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -2,14 +2,29 @@
 // Copyright Contributors to the OpenTimelineIO project
 
 #include "opentimelineio/serialization.h"
+#include "binaryFormat.h"
 #include "errorStatus.h"
 #include "opentimelineio/anyDictionary.h"
 #include "opentimelineio/color.h"
+#include "opentimelineio/effect.h"
+#include "opentimelineio/marker.h"
 #include "opentimelineio/serializableObject.h"
+#include "opentimelineio/stack.h"
+#include "opentimelineio/timeline.h"
+#include "opentimelineio/timelineStreamWriter.h"
 #include "opentimelineio/unknownSchema.h"
 #include "stringUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #define RAPIDJSON_NAMESPACE OTIO_rapidjson
 #include <rapidjson/ostreamwrapper.h>
@@ -27,7 +42,14 @@
 #        define NOMINMAX
 #    endif // NOMINMAX
 #    include <windows.h>
-#endif
+#    include <fcntl.h>
+#    include <io.h>
+#    include <sys/stat.h>
+#else // _WINDOWS
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif // _WINDOWS
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
@@ -81,6 +103,30 @@ public:
     virtual void write_value(IMATH_NAMESPACE::Box2d const&)          = 0;
     virtual void write_value(IMATH_NAMESPACE::V2d const&)            = 0;
 
+    /*
+     * Subtree support, used by the Writer to encode independent subtrees
+     * on worker threads.  An encoder that supports this hands out encoders
+     * which write into private buffers (see take_subtree()); the finished
+     * buffers are then spliced back in order with write_subtree().
+     */
+    virtual Encoder* make_subtree_encoder() { return nullptr; }
+    virtual void     take_subtree(std::string*) {}
+    virtual void     write_subtree(std::string const&) {}
+
+    /*
+     * Values that are already encoded as JSON text, see
+     * Writer::write_json_text().
+     */
+    virtual bool accepts_json_text(char const*, size_t) { return false; }
+    virtual void write_json_text(char const*, size_t) {}
+
+    /*
+     * An encoder may write a whole object in a form of its own (the hashing
+     * encoder writes the content hash of a held object, for instance), in
+     * which case it returns true and the writer skips the object's fields.
+     */
+    virtual bool write_object(SerializableObject const*) { return false; }
+
 protected:
     void _error(ErrorStatus const& error_status)
     {
@@ -523,12 +569,141 @@ private:
     }
 };
 
+using JSONStringWriter = OTIO_rapidjson::Writer<
+    OTIO_rapidjson::StringBuffer,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+using JSONStringPrettyWriter = OTIO_rapidjson::PrettyWriter<
+    OTIO_rapidjson::StringBuffer,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+/**
+ * Format a double the way rapidjson's Writer::Double() does (the shortest
+ * digits that read back to the same value, with a ".0" on integral values
+ * so they are read back as doubles), and return the length of the result,
+ * or zero when the value should be left to rapidjson.  The buffer must
+ * hold at least 32 characters.
+ *
+ * Integral values, which most times and rates are, skip the floating
+ * point formatting altogether.
+ */
+static size_t
+_format_json_double(double value, char* buffer)
+{
+    if (!std::isfinite(value))
+    {
+        return 0;
+    }
+
+    char* out = buffer;
+    char* end = buffer + 32;
+    if (std::signbit(value))
+    {
+        *out++ = '-';
+        value  = -value;
+    }
+
+    if (value < 9007199254740992.0)
+    {
+        const uint64_t integral = static_cast<uint64_t>(value);
+        if (static_cast<double>(integral) == value)
+        {
+            out    = std::to_chars(out, end, integral).ptr;
+            *out++ = '.';
+            *out++ = '0';
+            return size_t(out - buffer);
+        }
+    }
+
+#if defined(__cpp_lib_to_chars)
+    // shortest round trip digits, as "d.ddde[+-]xx"
+    char       scientific[32];
+    const auto result = std::to_chars(
+        scientific,
+        scientific + sizeof(scientific),
+        value,
+        std::chars_format::scientific);
+    if (result.ec != std::errc())
+    {
+        return 0;
+    }
+
+    char  digits[20];
+    int   length = 0;
+    char* p      = scientific;
+    for (; p != result.ptr && *p != 'e'; ++p)
+    {
+        if (*p != '.')
+        {
+            digits[length++] = *p;
+        }
+    }
+    int exponent = 0;
+    std::from_chars(p + (p[1] == '+' ? 2 : 1), result.ptr, exponent);
+
+    // the value is digits * 10^(kk - length), laid out like rapidjson's
+    // Prettify()
+    const int kk = exponent + 1;
+    if (length <= kk && kk <= 21)
+    {
+        // 1234e7 -> 12340000000.0
+        out = std::copy(digits, digits + length, out);
+        out = std::fill_n(out, kk - length, '0');
+        *out++ = '.';
+        *out++ = '0';
+    }
+    else if (0 < kk && kk <= 21)
+    {
+        // 1234e-2 -> 12.34
+        out    = std::copy(digits, digits + kk, out);
+        *out++ = '.';
+        out    = std::copy(digits + kk, digits + length, out);
+    }
+    else if (-6 < kk && kk <= 0)
+    {
+        // 1234e-6 -> 0.001234
+        *out++ = '0';
+        *out++ = '.';
+        out    = std::fill_n(out, -kk, '0');
+        out    = std::copy(digits, digits + length, out);
+    }
+    else
+    {
+        // 1e30, 1234e30 -> 1.234e33
+        *out++ = digits[0];
+        if (length > 1)
+        {
+            *out++ = '.';
+            out    = std::copy(digits + 1, digits + length, out);
+        }
+        *out++ = 'e';
+        out    = std::to_chars(out, end, kk - 1).ptr;
+    }
+    return size_t(out - buffer);
+#else  // __cpp_lib_to_chars
+    return 0;
+#endif // __cpp_lib_to_chars
+}
+
+/**
+ * The pretty_indent passed to a JSONEncoder describes the formatting of the
+ * underlying writer: a negative value for a compact writer, otherwise the
+ * indentation of a pretty writer.  It is only needed so that subtrees
+ * encoded separately can be formatted identically.
+ */
 template <typename RapidJSONWriterType>
 class JSONEncoder : public Encoder
 {
 public:
-    JSONEncoder(RapidJSONWriterType& writer)
+    JSONEncoder(RapidJSONWriterType& writer, int pretty_indent = -1)
         : _writer(writer)
+        , _pretty_indent(pretty_indent)
     {}
 
     virtual ~JSONEncoder() {}
@@ -550,7 +725,7 @@ public:
         _writer.String(value.c_str());
     }
 
-    void write_value(double value) { _writer.Double(value); }
+    void write_value(double value) { _write_double(value); }
 
     void write_value(RationalTime const& value)
     {
@@ -560,10 +735,10 @@ public:
         _writer.String("RationalTime.1");
 
         _writer.Key("rate");
-        _writer.Double(value.rate());
+        _write_double(value.rate());
 
         _writer.Key("value");
-        _writer.Double(value.value());
+        _write_double(value.value());
 
         _writer.EndObject();
     }
@@ -595,10 +770,10 @@ public:
         write_value(value.offset());
 
         _writer.Key("rate");
-        _writer.Double(value.rate());
+        _write_double(value.rate());
 
         _writer.Key("scale");
-        _writer.Double(value.scale());
+        _write_double(value.scale());
 
         _writer.EndObject();
     }
@@ -611,16 +786,16 @@ public:
         _writer.String("Color.1");
 
         _writer.Key("r");
-        _writer.Double(value.r());
+        _write_double(value.r());
 
         _writer.Key("g");
-        _writer.Double(value.g());
+        _write_double(value.g());
 
         _writer.Key("b");
-        _writer.Double(value.b());
+        _write_double(value.b());
 
         _writer.Key("a");
-        _writer.Double(value.a());
+        _write_double(value.a());
 
         _writer.Key("name");
         _writer.String(value.name().c_str());
@@ -646,10 +821,10 @@ public:
         _writer.String("V2d.1");
 
         _writer.Key("x");
-        _writer.Double(value.x);
+        _write_double(value.x);
 
         _writer.Key("y");
-        _writer.Double(value.y);
+        _write_double(value.y);
 
         _writer.EndObject();
     }
@@ -670,775 +845,2692 @@ public:
         _writer.EndObject();
     }
 
-    void start_array(size_t) { _writer.StartArray(); }
-
-    void start_object() { _writer.StartObject(); }
-
-    void end_array() { _writer.EndArray(); }
-
-    void end_object() { _writer.EndObject(); }
-
-private:
-    RapidJSONWriterType& _writer;
-};
-
-template <typename T>
-bool
-_simple_any_comparison(std::any const& lhs, std::any const& rhs)
-{
-    return lhs.type() == typeid(T) && rhs.type() == typeid(T)
-           && std::any_cast<T const&>(lhs) == std::any_cast<T const&>(rhs);
-}
-
-template <>
-bool
-_simple_any_comparison<void>(std::any const& lhs, std::any const& rhs)
-{
-    return lhs.type() == typeid(void) && rhs.type() == typeid(void);
-}
-
-template <>
-bool
-_simple_any_comparison<char const*>(std::any const& lhs, std::any const& rhs)
-{
-    return lhs.type() == typeid(char const*)
-           && rhs.type() == typeid(char const*)
-           && !strcmp(
-               std::any_cast<char const*>(lhs),
-               std::any_cast<char const*>(rhs));
-}
-
-void
-SerializableObject::Writer::_build_dispatch_tables()
-{
-    /*
-     * These are basically atomic writes to the encoder:
-     */
-
-    auto& wt          = _write_dispatch_table;
-    wt[&typeid(void)] = [this](std::any const&) {
-        _encoder.write_null_value();
-    };
-    wt[&typeid(bool)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<bool>(value));
-    };
-    wt[&typeid(int64_t)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<int64_t>(value));
-    };
-    wt[&typeid(double)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<double>(value));
-    };
-    wt[&typeid(std::string)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<std::string const&>(value));
-    };
-    wt[&typeid(char const*)] = [this](std::any const& value) {
-        _encoder.write_value(std::string(std::any_cast<char const*>(value)));
-    };
-    wt[&typeid(RationalTime)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<RationalTime const&>(value));
-    };
-    wt[&typeid(TimeRange)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<TimeRange const&>(value));
-    };
-    wt[&typeid(TimeTransform)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<TimeTransform const&>(value));
-    };
-    wt[&typeid(Color)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<Color const&>(value));
-    };
-    wt[&typeid(IMATH_NAMESPACE::V2d)] = [this](std::any const& value) {
-        _encoder.write_value(std::any_cast<IMATH_NAMESPACE::V2d const&>(value));
-    };
-    wt[&typeid(IMATH_NAMESPACE::Box2d)] = [this](std::any const& value) {
-        _encoder.write_value(
-            std::any_cast<IMATH_NAMESPACE::Box2d const&>(value));
-    };
-
-    /*
-     * These next recurse back through the Writer itself:
-     */
-    wt[&typeid(SerializableObject::Retainer<>)] =
-        [this](std::any const& value) {
-            this->write(
-                _no_key,
-                std::any_cast<SerializableObject::Retainer<>>(value));
-        };
-
-    wt[&typeid(AnyDictionary)] = [this](std::any const& value) {
-        this->write(_no_key, std::any_cast<AnyDictionary const&>(value));
-    };
-
-    wt[&typeid(AnyVector)] = [this](std::any const& value) {
-        this->write(_no_key, std::any_cast<AnyVector const&>(value));
-    };
-
-    /*
-     * Install a backup table, using the actual type name as a key.
-     * This is to deal with type aliasing across compilation units.
-     */
-    for (const auto& e: wt)
+    void start_array(size_t)
     {
-        _write_dispatch_table_by_name[e.first->name()] = e.second;
+        _depth++;
+        _writer.StartArray();
     }
 
-    auto& et                   = _equality_dispatch_table;
-    et[&typeid(void)]          = &_simple_any_comparison<void>;
-    et[&typeid(bool)]          = &_simple_any_comparison<bool>;
-    et[&typeid(int64_t)]       = &_simple_any_comparison<int64_t>;
-    et[&typeid(double)]        = &_simple_any_comparison<double>;
-    et[&typeid(std::string)]   = &_simple_any_comparison<std::string>;
-    et[&typeid(char const*)]   = &_simple_any_comparison<char const*>;
-    et[&typeid(RationalTime)]  = &_simple_any_comparison<RationalTime>;
-    et[&typeid(TimeRange)]     = &_simple_any_comparison<TimeRange>;
-    et[&typeid(TimeTransform)] = &_simple_any_comparison<TimeTransform>;
-    et[&typeid(Color)]         = &_simple_any_comparison<Color>;
-    et[&typeid(SerializableObject::ReferenceId)] =
-        &_simple_any_comparison<SerializableObject::ReferenceId>;
-    et[&typeid(IMATH_NAMESPACE::V2d)] =
-        &_simple_any_comparison<IMATH_NAMESPACE::V2d>;
-    et[&typeid(IMATH_NAMESPACE::Box2d)] =
-        &_simple_any_comparison<IMATH_NAMESPACE::Box2d>;
-
-    /*
-     * These next recurse back through the Writer itself:
-     */
-    et[&typeid(AnyDictionary)] =
-        [this](std::any const& lhs, std::any const& rhs) {
-            return _any_dict_equals(lhs, rhs);
-        };
-    et[&typeid(AnyVector)] = [this](std::any const& lhs, std::any const& rhs) {
-        return _any_array_equals(lhs, rhs);
-    };
-}
+    void start_object()
+    {
+        _depth++;
+        _writer.StartObject();
+    }
 
-bool
-SerializableObject::Writer::_any_dict_equals(
-    std::any const& lhs,
-    std::any const& rhs)
-{
-    if (lhs.type() != typeid(AnyDictionary)
-        || rhs.type() != typeid(AnyDictionary))
+    void end_array()
     {
-        return false;
+        _depth--;
+        _writer.EndArray();
     }
 
-    AnyDictionary const& ld = std::any_cast<AnyDictionary const&>(lhs);
-    AnyDictionary const& rd = std::any_cast<AnyDictionary const&>(rhs);
+    void end_object()
+    {
+        _depth--;
+        _writer.EndObject();
+    }
 
-    auto r_it = rd.begin();
+    Encoder* make_subtree_encoder() override;
 
-    for (const auto& l_it: ld)
+    void write_subtree(std::string const& json) override
     {
-        if (r_it == rd.end())
+        /*
+         * A subtree was encoded as a root value, so a pretty printed one has
+         * to be shifted over to the current depth.  JSON strings can't hold
+         * raw newlines, so every newline in the buffer is a line break.
+         */
+        if (_pretty_indent <= 0 || _depth == 0)
         {
-            return false;
+            _writer.RawValue(
+                json.c_str(),
+                json.size(),
+                OTIO_rapidjson::kObjectType);
+            return;
         }
 
-        if (l_it.first != r_it->first
-            || !_any_equals(l_it.second, r_it->second))
+        std::string const padding(size_t(_depth * _pretty_indent), ' ');
+        std::string       shifted;
+        shifted.reserve(json.size() + json.size() / 8);
+        for (char c: json)
         {
-            return false;
+            shifted.push_back(c);
+            if (c == '\n')
+            {
+                shifted.append(padding);
+            }
         }
-        ++r_it;
+        _writer.RawValue(
+            shifted.c_str(),
+            shifted.size(),
+            OTIO_rapidjson::kObjectType);
     }
-    return r_it == rd.end();
-}
 
-bool
-SerializableObject::Writer::_any_array_equals(
-    std::any const& lhs,
-    std::any const& rhs)
-{
-    if (lhs.type() != typeid(AnyVector) || rhs.type() != typeid(AnyVector))
+    bool accepts_json_text(char const* json, size_t length) override
     {
-        return false;
+        // only take text formatted the same way (pretty or compact)
+        return (_pretty_indent > 0) == (memchr(json, '\n', length) != nullptr);
     }
 
-    AnyVector const& lv = std::any_cast<AnyVector const&>(lhs);
-    AnyVector const& rv = std::any_cast<AnyVector const&>(rhs);
-
-    if (lv.size() != rv.size())
+    void write_json_text(char const* json, size_t length) override
     {
-        return false;
+        if (_pretty_indent <= 0)
+        {
+            _writer.RawValue(json, length, OTIO_rapidjson::kObjectType);
+            return;
+        }
+
+        /*
+         * Pretty printed text is re-indented: its last line (the closing
+         * bracket) gives the depth it was read at, and its first line break
+         * the indentation it was written with.
+         */
+        auto leading_spaces = [json, length](size_t i) {
+            size_t n = 0;
+            while (i + n < length && json[i + n] == ' ')
+            {
+                n++;
+            }
+            return n;
+        };
+
+        size_t last_line = length;
+        while (last_line > 0 && json[last_line - 1] != '\n')
+        {
+            last_line--;
+        }
+        size_t const old_base = leading_spaces(last_line);
+        size_t const first_line =
+            size_t(static_cast<char const*>(memchr(json, '\n', length)) - json)
+            + 1;
+        size_t const first_indent = leading_spaces(first_line);
+        size_t const old_step =
+            first_indent > old_base ? first_indent - old_base : 1;
+
+        size_t const base = size_t(_depth * _pretty_indent);
+        std::string  shifted;
+        shifted.reserve(length + length / 8);
+        for (size_t i = 0; i < length; ++i)
+        {
+            shifted.push_back(json[i]);
+            if (json[i] == '\n')
+            {
+                size_t const spaces = leading_spaces(i + 1);
+                size_t const levels =
+                    spaces > old_base ? (spaces - old_base) / old_step : 0;
+                shifted.append(base + levels * size_t(_pretty_indent), ' ');
+                i += spaces;
+            }
+        }
+        _writer.RawValue(
+            shifted.c_str(),
+            shifted.size(),
+            OTIO_rapidjson::kObjectType);
     }
 
-    for (size_t i = 0; i < lv.size(); i++)
+private:
+    void _write_double(double value)
     {
-        if (!_any_equals(lv[i], rv[i]))
+        char         buffer[32];
+        size_t const length = _format_json_double(value, buffer);
+        if (length > 0)
         {
-            return false;
+            _writer.RawValue(buffer, length, OTIO_rapidjson::kNumberType);
+        }
+        else
+        {
+            _writer.Double(value);
         }
     }
 
-    return true;
-}
+    RapidJSONWriterType& _writer;
+    int                  _pretty_indent;
+    int                  _depth = 0;
+};
 
-bool
-SerializableObject::Writer::_any_equals(
-    std::any const& lhs,
-    std::any const& rhs)
-{
-    auto e = _equality_dispatch_table.find(&lhs.type());
-    return (e != _equality_dispatch_table.end()) && e->second(lhs, rhs);
-}
-
-bool
-SerializableObject::Writer::write_root(
-    std::any const&           value,
-    Encoder&                  encoder,
-    const schema_version_map* schema_version_targets,
-    ErrorStatus*              error_status)
+/**
+ * A JSONEncoder that writes into its own string buffer; used for encoding
+ * subtrees.
+ */
+template <typename RapidJSONWriterType>
+class JSONSubtreeEncoder : public JSONEncoder<RapidJSONWriterType>
 {
-    Writer w(encoder, schema_version_targets);
-    w.write(w._no_key, value);
-    return !encoder.has_errored(error_status);
-}
+public:
+    JSONSubtreeEncoder(int pretty_indent)
+        : JSONEncoder<RapidJSONWriterType>(_json_writer, pretty_indent)
+        , _json_writer(_buffer)
+    {}
 
-void
-SerializableObject::Writer::_encoder_write_key(std::string const& key)
-{
-    if (&key != &_no_key)
+    void take_subtree(std::string* result) override
     {
-        _encoder.write_key(key);
+        result->assign(_buffer.GetString(), _buffer.GetSize());
+        _buffer.Clear();
+        _json_writer.Reset(_buffer);
     }
-}
 
-void
-SerializableObject::Writer::write(std::string const& key, bool value)
-{
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+private:
+    template <typename>
+    friend class JSONEncoder;
 
-void
-SerializableObject::Writer::write(std::string const& key, int64_t value)
-{
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+    OTIO_rapidjson::StringBuffer _buffer;
+    RapidJSONWriterType          _json_writer;
+};
 
-void
-SerializableObject::Writer::write(std::string const& key, double value)
+template <typename RapidJSONWriterType>
+Encoder*
+JSONEncoder<RapidJSONWriterType>::make_subtree_encoder()
 {
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+    if (_pretty_indent < 0)
+    {
+        return new JSONSubtreeEncoder<JSONStringWriter>(_pretty_indent);
+    }
 
-void
-SerializableObject::Writer::write(
-    std::string const& key,
-    std::string const& value)
-{
-    _encoder_write_key(key);
-    _encoder.write_value(value);
+    auto encoder = new JSONSubtreeEncoder<JSONStringPrettyWriter>(
+        _pretty_indent);
+    encoder->_json_writer.SetIndent(' ', unsigned(_pretty_indent));
+    return encoder;
 }
 
-void
-SerializableObject::Writer::write(std::string const& key, RationalTime value)
+/**
+ * This encoder writes the binary format described in binaryFormat.h.
+ *
+ * Object and array records are written with a placeholder length which is
+ * patched in end_object()/end_array(); keys and schema names go into the
+ * string table, which is appended (with the trailer) by finish().
+ *
+ * While writing, the encoder also records the offset of every object that
+ * can be reached by a subtree path (see binaryFormat.h): the root, a
+ * timeline's "tracks", and the elements of "children" arrays of objects
+ * that are themselves reachable.
+ */
+class BinaryEncoder : public Encoder
 {
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+public:
+    BinaryEncoder()
+    {
+        _buffer.append(binary_format::magic, sizeof(binary_format::magic));
+        binary_format::put_u32(_buffer, binary_format::version);
+    }
 
-void
-SerializableObject::Writer::write(std::string const& key, TimeRange value)
-{
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+    virtual ~BinaryEncoder() {}
 
-void
-SerializableObject::Writer::write(
-    std::string const&          key,
-    std::optional<RationalTime> value)
-{
-    _encoder_write_key(key);
-    value ? _encoder.write_value(*value) : _encoder.write_null_value();
-}
+    void write_key(std::string const& key)
+    {
+        binary_format::put_varint(_buffer, _string_index(key));
+        _schema_key = (key == "OTIO_SCHEMA");
 
-void
-SerializableObject::Writer::write(
-    std::string const&       key,
-    std::optional<TimeRange> value)
-{
-    _encoder_write_key(key);
-    value ? _encoder.write_value(*value) : _encoder.write_null_value();
-}
+        if (!_records.empty())
+        {
+            _records.back().key = key == "children" ? _Record::children_key
+                                  : key == "tracks" ? _Record::tracks_key
+                                                    : _Record::other_key;
+        }
+    }
 
-void
-SerializableObject::Writer::write(
-    std::string const&                    key,
-    std::optional<IMATH_NAMESPACE::Box2d> value)
-{
-    _encoder_write_key(key);
-    value ? _encoder.write_value(*value) : _encoder.write_null_value();
-}
+    void write_null_value() { _tag(binary_format::null_tag); }
 
-void
-SerializableObject::Writer::write(std::string const& key, TimeTransform value)
-{
-    _encoder_write_key(key);
-    _encoder.write_value(value);
-}
+    void write_value(bool value)
+    {
+        _tag(value ? binary_format::true_tag : binary_format::false_tag);
+    }
 
-void
-SerializableObject::Writer::write(
-    std::string const&       key,
-    std::optional<Color> value)
-{
-    _encoder_write_key(key);
-    value ? _encoder.write_value(*value) : _encoder.write_null_value();
-}
+    void write_value(int value) { write_value(int64_t(value)); }
 
-void
-SerializableObject::Writer::write(
-    std::string const&        key,
-    SerializableObject const* value)
-{
-    _encoder_write_key(key);
-    if (!value)
+    void write_value(int64_t value)
     {
-        _encoder.write_null_value();
-        return;
+        _tag(binary_format::int64_tag);
+        binary_format::put_zigzag(_buffer, value);
     }
 
-    auto e = _id_for_object.find(value);
-    if (e != _id_for_object.end())
+    void write_value(uint64_t value)
     {
-#ifdef OTIO_INSTANCING_SUPPORT
-        /*
-         * We've already written this value.
-         */
-        _encoder.write_value(SerializableObject::ReferenceId{ e->second });
-#else
-        /*
-         * We're encountering the same object while it is still
-         * in the map, meaning we're in the middle of writing it out.
-         * That's a cycle, as opposed to mere instancing, which we
-         * allow so as not to break old allowed behavior.
-         */
-        std::string s = string_printf(
-            "cyclically encountered object has schema %s",
-            value->schema_name().c_str());
-        _encoder._error(ErrorStatus(ErrorStatus::OBJECT_CYCLE, s));
-#endif
-        return;
+        _tag(binary_format::uint64_tag);
+        binary_format::put_varint(_buffer, value);
     }
 
-    std::string const& schema_type_name = value->_schema_name_for_reference();
-    if (_next_id_for_type.find(schema_type_name) == _next_id_for_type.end())
+    void write_value(double value)
     {
-        _next_id_for_type[schema_type_name] = 0;
+        _tag(binary_format::double_tag);
+        binary_format::put_double(_buffer, value);
     }
 
-    std::string next_id =
-        schema_type_name + "-"
-        + std::to_string(++_next_id_for_type[schema_type_name]);
-    _id_for_object[value] = next_id;
-
-    // detect if downgrading needs to happen
-    const std::string& schema_name    = value->schema_name();
-    int                schema_version = value->schema_version();
+    void write_value(std::string const& value)
+    {
+        if (_schema_key)
+        {
+            _tag(binary_format::string_ref_tag);
+            binary_format::put_varint(_buffer, _string_index(value));
+            return;
+        }
 
-    std::any downgraded = {};
+        _tag(binary_format::string_tag);
+        binary_format::put_bytes(_buffer, value);
+    }
 
-    // if there is a manifest & the encoder is not converting to AnyDictionary
-    if ((_downgrade_version_manifest != nullptr)
-        && (!_downgrade_version_manifest->empty())
-        && (!_encoder.encoding_to_anydict()))
+    void write_value(RationalTime const& value)
     {
-        const auto& target_version_it =
-            _downgrade_version_manifest->find(schema_name);
-
-        // ...and if that downgrade manifest specifies a target version for
-        // this schema
-        if (target_version_it != _downgrade_version_manifest->end())
-        {
-            const int target_version =
-                static_cast<int>(target_version_it->second);
+        _tag(binary_format::rational_time_tag);
+        binary_format::put_double(_buffer, value.value());
+        binary_format::put_double(_buffer, value.rate());
+    }
 
-            // and the current_version is greater than the target version
-            if (schema_version > target_version)
-            {
-                if (_child_writer == nullptr)
-                {
-                    _child_cloning_encoder = new CloningEncoder(
-                        CloningEncoder::ResultObjectPolicy::OnlyAnyDictionary,
-                        _downgrade_version_manifest);
-                    _child_writer = new Writer(*_child_cloning_encoder, {});
-                }
-                else
-                {
-                    _child_cloning_encoder->_stack.clear();
-                }
+    void write_value(TimeRange const& value)
+    {
+        _tag(binary_format::time_range_tag);
+        binary_format::put_double(_buffer, value.start_time().value());
+        binary_format::put_double(_buffer, value.start_time().rate());
+        binary_format::put_double(_buffer, value.duration().value());
+        binary_format::put_double(_buffer, value.duration().rate());
+    }
 
-                _child_writer->write(_child_writer->_no_key, value);
+    void write_value(TimeTransform const& value)
+    {
+        _tag(binary_format::time_transform_tag);
+        binary_format::put_double(_buffer, value.offset().value());
+        binary_format::put_double(_buffer, value.offset().rate());
+        binary_format::put_double(_buffer, value.scale());
+        binary_format::put_double(_buffer, value.rate());
+    }
 
-                if (_child_cloning_encoder->has_errored(
-                        &_encoder._error_status))
-                {
-                    return;
-                }
+    void write_value(Color const& value)
+    {
+        _tag(binary_format::color_tag);
+        binary_format::put_double(_buffer, value.r());
+        binary_format::put_double(_buffer, value.g());
+        binary_format::put_double(_buffer, value.b());
+        binary_format::put_double(_buffer, value.a());
+        binary_format::put_bytes(_buffer, value.name());
+    }
 
-                downgraded.swap(_child_cloning_encoder->_root);
-                schema_version = target_version;
-            }
-        }
+    void write_value(SerializableObject::ReferenceId value)
+    {
+        _tag(binary_format::reference_tag);
+        binary_format::put_bytes(_buffer, value.id);
     }
 
-    std::string schema_str = "";
+    void write_value(IMATH_NAMESPACE::V2d const& value)
+    {
+        _tag(binary_format::v2d_tag);
+        binary_format::put_double(_buffer, value.x);
+        binary_format::put_double(_buffer, value.y);
+    }
 
-    // if its an unknown schema, the schema name is computed from the
-    // _original_schema_name and _original_schema_version attributes
-    if (UnknownSchema const* us = dynamic_cast<UnknownSchema const*>(value))
+    void write_value(IMATH_NAMESPACE::Box2d const& value)
     {
-        schema_str =
-            (us->_original_schema_name + "."
-             + std::to_string(us->_original_schema_version));
+        _tag(binary_format::box2d_tag);
+        binary_format::put_double(_buffer, value.min.x);
+        binary_format::put_double(_buffer, value.min.y);
+        binary_format::put_double(_buffer, value.max.x);
+        binary_format::put_double(_buffer, value.max.y);
     }
-    else
+
+    void start_array(size_t size)
     {
-        // otherwise, use the schema_name and schema_version attributes
-        schema_str = schema_name + "." + std::to_string(schema_version);
+        _start_record(binary_format::array_tag);
+        binary_format::put_varint(_buffer, size);
     }
 
-    _encoder.start_object();
+    void start_object() { _start_record(binary_format::object_tag); }
 
-#ifdef OTIO_INSTANCING_SUPPORT
-    _encoder.write_key("OTIO_REF_ID");
-    _encoder.write_value(next_id);
-#endif
+    void end_array() { _end_record(); }
 
-    // write the contents of the object to the encoder, either the downgraded
-    // anydictionary or the SerializableObject
-    if (downgraded.has_value())
+    void end_object() { _end_record(); }
+
+    /// Append the string table, index and trailer, and hand out the result.
+    void finish(std::string* result)
     {
-        for (const auto& kv: std::any_cast<AnyDictionary>(downgraded))
+        const uint64_t strings_offset = _buffer.size();
+        binary_format::put_varint(_buffer, _strings.size());
+        for (auto const* s: _strings)
         {
-            this->write(kv.first, kv.second);
+            binary_format::put_bytes(_buffer, *s);
+        }
+
+        // the index is ordered by path, after the positions of its entries
+        std::sort(_index.begin(), _index.end());
+        const uint64_t index_offset = _buffer.size();
+        binary_format::put_varint(_buffer, _index.size());
+        const size_t positions = _buffer.size();
+        _buffer.append(_index.size() * 8, '\0');
+        for (size_t i = 0; i < _index.size(); ++i)
+        {
+            binary_format::patch_u64(
+                _buffer,
+                positions + 8 * i,
+                _buffer.size() - index_offset);
+            binary_format::put_bytes(_buffer, _index[i].first);
+            binary_format::put_u64(_buffer, _index[i].second);
         }
+
+        binary_format::put_u64(_buffer, strings_offset);
+        binary_format::put_u64(_buffer, index_offset);
+        _buffer.append(binary_format::magic, sizeof(binary_format::magic));
+        result->swap(_buffer);
     }
-    else
+
+private:
+    struct _Record
     {
-        _encoder.write_key("OTIO_SCHEMA");
-        _encoder.write_value(schema_str);
-        value->write_to(*this);
-    }
+        enum Key
+        {
+            other_key,
+            children_key,
+            tracks_key
+        };
 
-    _encoder.end_object();
+        size_t      start;
+        bool        is_array;
+        bool        reachable;
+        std::string path;
+        Key         key   = other_key;
+        size_t      index = 0;
+    };
 
-#ifndef OTIO_INSTANCING_SUPPORT
-    auto valueEntry = _id_for_object.find(value);
-    if (valueEntry != _id_for_object.end())
+    void _tag(binary_format::Tag tag)
     {
-        _id_for_object.erase(valueEntry);
+        /*
+         * Work out whether the value can be reached by a subtree path before
+         * writing it; elements of arrays are counted here too.
+         */
+        _value_reachable = _records.empty();
+        _value_path.clear();
+        if (!_records.empty())
+        {
+            auto& top = _records.back();
+            if (top.reachable && top.is_array)
+            {
+                _value_reachable = true;
+                _value_path =
+                    _join_path(top.path, std::to_string(top.index));
+            }
+            else if (top.reachable && top.key == _Record::tracks_key)
+            {
+                _value_reachable = true;
+                _value_path      = _join_path(top.path, "tracks");
+            }
+            if (top.is_array)
+            {
+                top.index++;
+            }
+        }
+
+        if (_value_reachable && tag == binary_format::object_tag)
+        {
+            _index.emplace_back(_value_path, _buffer.size());
+        }
+
+        _buffer.push_back(char(tag));
+        _schema_key = false;
     }
-#endif
+
+    void _start_record(binary_format::Tag tag)
+    {
+        const bool is_array = (tag == binary_format::array_tag);
+        _tag(tag);
+
+        // a "children" array of a reachable object holds reachable objects
+        bool        reachable = _value_reachable;
+        std::string path      = _value_path;
+        if (is_array)
+        {
+            reachable = !_records.empty() && _records.back().reachable
+                        && _records.back().key == _Record::children_key;
+            path = _records.empty() ? std::string() : _records.back().path;
+        }
+
+        _records.push_back(
+            _Record{ _buffer.size(), is_array, reachable, std::move(path) });
+        binary_format::put_u32(_buffer, 0);
+    }
+
+    static std::string
+    _join_path(std::string const& path, std::string const& component)
+    {
+        return path.empty() ? component : path + "/" + component;
+    }
+
+    void _end_record()
+    {
+        const size_t start = _records.back().start;
+        _records.pop_back();
+
+        const size_t length = _buffer.size() - start - 4;
+        if (length > UINT32_MAX)
+        {
+            _error(ErrorStatus(
+                ErrorStatus::INTERNAL_ERROR,
+                "record too large for the binary format"));
+        }
+        binary_format::patch_u32(_buffer, start, uint32_t(length));
+    }
+
+    size_t _string_index(std::string const& s)
+    {
+        auto e = _string_indices.find(s);
+        if (e != _string_indices.end())
+        {
+            return e->second;
+        }
+
+        auto inserted = _string_indices.emplace(s, _strings.size()).first;
+        _strings.push_back(&inserted->first);
+        return inserted->second;
+    }
+
+    std::string                                   _buffer;
+    std::vector<_Record>                          _records;
+    std::unordered_map<std::string, size_t>       _string_indices;
+    std::vector<std::string const*>               _strings;
+    std::vector<std::pair<std::string, uint64_t>> _index;
+    bool                                          _schema_key      = false;
+    bool                                          _value_reachable = false;
+    std::string                                   _value_path;
+};
+
+/*
+ * MurmurHash3 (x64, 128-bit variant) of a buffer.  The hash only depends
+ * on the bytes, so it is the same on every platform.
+ */
+static uint64_t
+_fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
 }
 
-void
-SerializableObject::Writer::write(
-    std::string const&   key,
-    IMATH_NAMESPACE::V2d value)
+static uint64_t
+_rotl64(uint64_t x, int r)
 {
-    _encoder_write_key(key);
-    _encoder.write_value(value);
+    return (x << r) | (x >> (64 - r));
 }
 
-void
-SerializableObject::Writer::write(
-    std::string const&     key,
-    IMATH_NAMESPACE::Box2d value)
+static SerializableObject::ContentHash
+_murmur_hash_128(std::string const& data)
 {
-    _encoder_write_key(key);
-    _encoder.write_value(value);
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    auto const*  bytes  = reinterpret_cast<unsigned char const*>(data.data());
+    const size_t length = data.size();
+    const size_t blocks = length / 16;
+
+    auto load = [bytes](size_t offset, size_t count) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            value |= uint64_t(bytes[offset + i]) << (8 * i);
+        }
+        return value;
+    };
+
+    uint64_t h1 = 0, h2 = 0;
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        uint64_t k1 = load(i * 16, 8);
+        uint64_t k2 = load(i * 16 + 8, 8);
+
+        k1 *= c1;
+        k1 = _rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = _rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = _rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = _rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const size_t tail = length & 15;
+    if (tail > 8)
+    {
+        uint64_t k2 = load(blocks * 16 + 8, tail - 8);
+        k2 *= c2;
+        k2 = _rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    if (tail > 0)
+    {
+        uint64_t k1 = load(blocks * 16, tail < 8 ? tail : 8);
+        k1 *= c1;
+        k1 = _rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = _fmix64(h1);
+    h2 = _fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    SerializableObject::ContentHash hash;
+    hash.high = h1;
+    hash.low  = h2;
+    return hash;
+}
+
+/**
+ * This encoder computes the content hashes of an object and of the objects
+ * it holds.  Each object's fields are written into a buffer of its own in
+ * the binary format's encoding (without a string table); an object held by
+ * another is written into its holder's buffer as its content hash.  Objects
+ * whose cached hash is current aren't written out at all.
+ */
+class HashingEncoder : public Encoder
+{
+public:
+    // The objects of a revalidated root may use their cached hashes even
+    // while they are exposed.
+    HashingEncoder(bool revalidated = false)
+        : _revalidated(revalidated)
+    {}
+
+    virtual ~HashingEncoder() {}
+
+    SerializableObject::ContentHash root_hash() const { return _root_hash; }
+
+    // The hash of the values written outside of any object.
+    SerializableObject::ContentHash top_level_hash() const
+    {
+        return _murmur_hash_128(_top_level);
+    }
+
+    bool write_object(SerializableObject const* value)
+    {
+        SerializableObject::ContentHash hash;
+        if (value->_cached_content_hash(&hash, _revalidated))
+        {
+            _put_hash(hash);
+            return true;
+        }
+
+        // the object is finished by the end_object() matching its start;
+        // one modified while we work is left with a stale revision
+        _objects.push_back(
+            { value, value->revision(), _depth, std::string() });
+        return false;
+    }
+
+    void write_key(std::string const& key)
+    {
+        _buffer().push_back(char(key_tag));
+        binary_format::put_bytes(_buffer(), key);
+    }
+
+    void write_null_value() { _tag(binary_format::null_tag); }
+
+    void write_value(bool value)
+    {
+        _tag(value ? binary_format::true_tag : binary_format::false_tag);
+    }
+
+    void write_value(int value) { write_value(int64_t(value)); }
+
+    void write_value(int64_t value)
+    {
+        _tag(binary_format::int64_tag);
+        binary_format::put_zigzag(_buffer(), value);
+    }
+
+    void write_value(uint64_t value)
+    {
+        _tag(binary_format::uint64_tag);
+        binary_format::put_varint(_buffer(), value);
+    }
+
+    void write_value(double value)
+    {
+        _tag(binary_format::double_tag);
+        binary_format::put_double(_buffer(), value);
+    }
+
+    void write_value(std::string const& value)
+    {
+        _tag(binary_format::string_tag);
+        binary_format::put_bytes(_buffer(), value);
+    }
+
+    void write_value(RationalTime const& value)
+    {
+        _tag(binary_format::rational_time_tag);
+        binary_format::put_double(_buffer(), value.value());
+        binary_format::put_double(_buffer(), value.rate());
+    }
+
+    void write_value(TimeRange const& value)
+    {
+        _tag(binary_format::time_range_tag);
+        binary_format::put_double(_buffer(), value.start_time().value());
+        binary_format::put_double(_buffer(), value.start_time().rate());
+        binary_format::put_double(_buffer(), value.duration().value());
+        binary_format::put_double(_buffer(), value.duration().rate());
+    }
+
+    void write_value(TimeTransform const& value)
+    {
+        _tag(binary_format::time_transform_tag);
+        binary_format::put_double(_buffer(), value.offset().value());
+        binary_format::put_double(_buffer(), value.offset().rate());
+        binary_format::put_double(_buffer(), value.scale());
+        binary_format::put_double(_buffer(), value.rate());
+    }
+
+    void write_value(Color const& value)
+    {
+        _tag(binary_format::color_tag);
+        binary_format::put_double(_buffer(), value.r());
+        binary_format::put_double(_buffer(), value.g());
+        binary_format::put_double(_buffer(), value.b());
+        binary_format::put_double(_buffer(), value.a());
+        binary_format::put_bytes(_buffer(), value.name());
+    }
+
+    void write_value(SerializableObject::ReferenceId value)
+    {
+        _tag(binary_format::reference_tag);
+        binary_format::put_bytes(_buffer(), value.id);
+    }
+
+    void write_value(IMATH_NAMESPACE::V2d const& value)
+    {
+        _tag(binary_format::v2d_tag);
+        binary_format::put_double(_buffer(), value.x);
+        binary_format::put_double(_buffer(), value.y);
+    }
+
+    void write_value(IMATH_NAMESPACE::Box2d const& value)
+    {
+        _tag(binary_format::box2d_tag);
+        binary_format::put_double(_buffer(), value.min.x);
+        binary_format::put_double(_buffer(), value.min.y);
+        binary_format::put_double(_buffer(), value.max.x);
+        binary_format::put_double(_buffer(), value.max.y);
+    }
+
+    void start_array(size_t size)
+    {
+        ++_depth;
+        _tag(binary_format::array_tag);
+        binary_format::put_varint(_buffer(), size);
+    }
+
+    void start_object()
+    {
+        ++_depth;
+        _tag(binary_format::object_tag);
+    }
+
+    void end_array()
+    {
+        --_depth;
+        _buffer().push_back(char(end_tag));
+    }
+
+    void end_object()
+    {
+        --_depth;
+        _buffer().push_back(char(end_tag));
+        if (_objects.empty() || _objects.back().depth != _depth)
+        {
+            return;
+        }
+
+        auto hash = _murmur_hash_128(_objects.back().buffer);
+        if (!has_errored())
+        {
+            _objects.back().object->_store_content_hash(
+                hash,
+                _objects.back().revision);
+        }
+        _objects.pop_back();
+        if (_objects.empty())
+        {
+            _root_hash = hash;
+        }
+        else
+        {
+            _put_hash(hash);
+        }
+    }
+
+private:
+    // tags beyond those of the binary format
+    enum : uint8_t
+    {
+        key_tag = 0x80,
+        end_tag,
+        object_hash_tag
+    };
+
+    struct PendingObject
+    {
+        SerializableObject const* object;
+        uint64_t                  revision;
+        int                       depth;
+        std::string               buffer;
+    };
+
+    std::string& _buffer()
+    {
+        return _objects.empty() ? _top_level : _objects.back().buffer;
+    }
+
+    void _tag(binary_format::Tag tag) { _buffer().push_back(char(tag)); }
+
+    void _put_hash(SerializableObject::ContentHash hash)
+    {
+        _buffer().push_back(char(object_hash_tag));
+        binary_format::put_u64(_buffer(), hash.high);
+        binary_format::put_u64(_buffer(), hash.low);
+    }
+
+    bool                            _revalidated;
+    int                             _depth = 0;
+    std::vector<PendingObject>      _objects;
+    std::string                     _top_level;
+    SerializableObject::ContentHash _root_hash;
+};
+
+template <typename T>
+bool
+_simple_any_comparison(std::any const& lhs, std::any const& rhs)
+{
+    return lhs.type() == typeid(T) && rhs.type() == typeid(T)
+           && std::any_cast<T const&>(lhs) == std::any_cast<T const&>(rhs);
+}
+
+template <>
+bool
+_simple_any_comparison<void>(std::any const& lhs, std::any const& rhs)
+{
+    return lhs.type() == typeid(void) && rhs.type() == typeid(void);
+}
+
+template <>
+bool
+_simple_any_comparison<char const*>(std::any const& lhs, std::any const& rhs)
+{
+    return lhs.type() == typeid(char const*)
+           && rhs.type() == typeid(char const*)
+           && !strcmp(
+               std::any_cast<char const*>(lhs),
+               std::any_cast<char const*>(rhs));
 }
 
 void
-SerializableObject::Writer::write(
-    std::string const&   key,
-    AnyDictionary const& value)
+SerializableObject::Writer::_build_dispatch_tables()
 {
-    _encoder_write_key(key);
+    /*
+     * These are basically atomic writes to the encoder:
+     */
 
-    _encoder.start_object();
+    auto& wt          = _write_dispatch_table;
+    wt[&typeid(void)] = [this](std::any const&) {
+        _encoder.write_null_value();
+    };
+    wt[&typeid(bool)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<bool>(value));
+    };
+    wt[&typeid(int64_t)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<int64_t>(value));
+    };
+    wt[&typeid(double)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<double>(value));
+    };
+    wt[&typeid(std::string)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<std::string const&>(value));
+    };
+    wt[&typeid(char const*)] = [this](std::any const& value) {
+        _encoder.write_value(std::string(std::any_cast<char const*>(value)));
+    };
+    wt[&typeid(RationalTime)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<RationalTime const&>(value));
+    };
+    wt[&typeid(TimeRange)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<TimeRange const&>(value));
+    };
+    wt[&typeid(TimeTransform)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<TimeTransform const&>(value));
+    };
+    wt[&typeid(Color)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<Color const&>(value));
+    };
+    wt[&typeid(IMATH_NAMESPACE::V2d)] = [this](std::any const& value) {
+        _encoder.write_value(std::any_cast<IMATH_NAMESPACE::V2d const&>(value));
+    };
+    wt[&typeid(IMATH_NAMESPACE::Box2d)] = [this](std::any const& value) {
+        _encoder.write_value(
+            std::any_cast<IMATH_NAMESPACE::Box2d const&>(value));
+    };
+
+    /*
+     * These next recurse back through the Writer itself:
+     */
+    wt[&typeid(SerializableObject::Retainer<>)] =
+        [this](std::any const& value) {
+            this->write(
+                _no_key,
+                std::any_cast<SerializableObject::Retainer<>>(value));
+        };
+
+    wt[&typeid(AnyDictionary)] = [this](std::any const& value) {
+        this->write(_no_key, std::any_cast<AnyDictionary const&>(value));
+    };
+
+    wt[&typeid(AnyVector)] = [this](std::any const& value) {
+        this->write(_no_key, std::any_cast<AnyVector const&>(value));
+    };
+
+    /*
+     * Install a backup table, using the actual type name as a key.
+     * This is to deal with type aliasing across compilation units.
+     */
+    for (const auto& e: wt)
+    {
+        _write_dispatch_table_by_name[e.first->name()] = e.second;
+    }
+
+    auto& et                   = _equality_dispatch_table;
+    et[&typeid(void)]          = &_simple_any_comparison<void>;
+    et[&typeid(bool)]          = &_simple_any_comparison<bool>;
+    et[&typeid(int64_t)]       = &_simple_any_comparison<int64_t>;
+    et[&typeid(double)]        = &_simple_any_comparison<double>;
+    et[&typeid(std::string)]   = &_simple_any_comparison<std::string>;
+    et[&typeid(char const*)]   = &_simple_any_comparison<char const*>;
+    et[&typeid(RationalTime)]  = &_simple_any_comparison<RationalTime>;
+    et[&typeid(TimeRange)]     = &_simple_any_comparison<TimeRange>;
+    et[&typeid(TimeTransform)] = &_simple_any_comparison<TimeTransform>;
+    et[&typeid(Color)]         = &_simple_any_comparison<Color>;
+    et[&typeid(SerializableObject::ReferenceId)] =
+        &_simple_any_comparison<SerializableObject::ReferenceId>;
+    et[&typeid(IMATH_NAMESPACE::V2d)] =
+        &_simple_any_comparison<IMATH_NAMESPACE::V2d>;
+    et[&typeid(IMATH_NAMESPACE::Box2d)] =
+        &_simple_any_comparison<IMATH_NAMESPACE::Box2d>;
+
+    /*
+     * These next recurse back through the Writer itself:
+     */
+    et[&typeid(AnyDictionary)] =
+        [this](std::any const& lhs, std::any const& rhs) {
+            return _any_dict_equals(lhs, rhs);
+        };
+    et[&typeid(AnyVector)] = [this](std::any const& lhs, std::any const& rhs) {
+        return _any_array_equals(lhs, rhs);
+    };
+}
+
+bool
+SerializableObject::Writer::_any_dict_equals(
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    if (lhs.type() != typeid(AnyDictionary)
+        || rhs.type() != typeid(AnyDictionary))
+    {
+        return false;
+    }
+
+    AnyDictionary const& ld = std::any_cast<AnyDictionary const&>(lhs);
+    AnyDictionary const& rd = std::any_cast<AnyDictionary const&>(rhs);
+
+    auto r_it = rd.begin();
+
+    for (const auto& l_it: ld)
+    {
+        if (r_it == rd.end())
+        {
+            return false;
+        }
+
+        if (l_it.first != r_it->first
+            || !_any_equals(l_it.second, r_it->second))
+        {
+            return false;
+        }
+        ++r_it;
+    }
+    return r_it == rd.end();
+}
+
+bool
+SerializableObject::Writer::_any_array_equals(
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    if (lhs.type() != typeid(AnyVector) || rhs.type() != typeid(AnyVector))
+    {
+        return false;
+    }
+
+    AnyVector const& lv = std::any_cast<AnyVector const&>(lhs);
+    AnyVector const& rv = std::any_cast<AnyVector const&>(rhs);
+
+    if (lv.size() != rv.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < lv.size(); i++)
+    {
+        if (!_any_equals(lv[i], rv[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+SerializableObject::Writer::_any_equals(
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    auto e = _equality_dispatch_table.find(&lhs.type());
+    return (e != _equality_dispatch_table.end()) && e->second(lhs, rhs);
+}
+
+bool
+SerializableObject::Writer::write_root(
+    std::any const&           value,
+    Encoder&                  encoder,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status,
+    int                       max_threads)
+{
+    Writer w(encoder, schema_version_targets);
+    w._max_threads = max_threads;
+    w.write(w._no_key, value);
+    return !encoder.has_errored(error_status);
+}
+
+bool
+SerializableObject::Writer::write_json_text(
+    std::string const& key,
+    char const*        json,
+    size_t             length)
+{
+    if (!_encoder.accepts_json_text(json, length))
+    {
+        return false;
+    }
+
+    _encoder_write_key(key);
+    _encoder.write_json_text(json, length);
+    return true;
+}
+
+void
+SerializableObject::Writer::_encoder_write_key(std::string const& key)
+{
+    if (&key != &_no_key)
+    {
+        _encoder.write_key(key);
+    }
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, bool value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, int64_t value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, double value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const& key,
+    std::string const& value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, RationalTime value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, TimeRange value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&          key,
+    std::optional<RationalTime> value)
+{
+    _encoder_write_key(key);
+    value ? _encoder.write_value(*value) : _encoder.write_null_value();
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&       key,
+    std::optional<TimeRange> value)
+{
+    _encoder_write_key(key);
+    value ? _encoder.write_value(*value) : _encoder.write_null_value();
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&                    key,
+    std::optional<IMATH_NAMESPACE::Box2d> value)
+{
+    _encoder_write_key(key);
+    value ? _encoder.write_value(*value) : _encoder.write_null_value();
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, TimeTransform value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&       key,
+    std::optional<Color> value)
+{
+    _encoder_write_key(key);
+    value ? _encoder.write_value(*value) : _encoder.write_null_value();
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&        key,
+    SerializableObject const* value)
+{
+    _encoder_write_key(key);
+    if (!value)
+    {
+        _encoder.write_null_value();
+        return;
+    }
+
+    if (_encoder.write_object(value))
+    {
+        return;
+    }
+
+    auto e = _id_for_object.find(value);
+    if (e != _id_for_object.end())
+    {
+#ifdef OTIO_INSTANCING_SUPPORT
+        /*
+         * We've already written this value.
+         */
+        _encoder.write_value(SerializableObject::ReferenceId{ e->second });
+#else
+        /*
+         * We're encountering the same object while it is still
+         * in the map, meaning we're in the middle of writing it out.
+         * That's a cycle, as opposed to mere instancing, which we
+         * allow so as not to break old allowed behavior.
+         */
+        std::string s = string_printf(
+            "cyclically encountered object has schema %s",
+            value->schema_name().c_str());
+        _encoder._error(ErrorStatus(ErrorStatus::OBJECT_CYCLE, s));
+#endif
+        return;
+    }
+
+    std::string const& schema_type_name = value->_schema_name_for_reference();
+    if (_next_id_for_type.find(schema_type_name) == _next_id_for_type.end())
+    {
+        _next_id_for_type[schema_type_name] = 0;
+    }
+
+    std::string next_id =
+        schema_type_name + "-"
+        + std::to_string(++_next_id_for_type[schema_type_name]);
+    _id_for_object[value] = next_id;
+
+    // detect if downgrading needs to happen
+    const std::string& schema_name    = value->schema_name();
+    int                schema_version = value->schema_version();
+
+    std::any downgraded        = {};
+    bool     direct_downgrade = false;
+
+    // if there is a manifest & the encoder is not converting to AnyDictionary
+    if ((_downgrade_version_manifest != nullptr)
+        && (!_downgrade_version_manifest->empty())
+        && (!_encoder.encoding_to_anydict()))
+    {
+        const auto& target_version_it =
+            _downgrade_version_manifest->find(schema_name);
+
+        // ...and if that downgrade manifest specifies a target version for
+        // this schema
+        if (target_version_it != _downgrade_version_manifest->end())
+        {
+            const int target_version =
+                static_cast<int>(target_version_it->second);
+
+            // and the current_version is greater than the target version
+            if (schema_version > target_version
+                && value->_writes_downgraded(target_version))
+            {
+                // the object writes the older layout itself
+                direct_downgrade = true;
+                schema_version   = target_version;
+            }
+            else if (schema_version > target_version)
+            {
+                if (_child_writer == nullptr)
+                {
+                    _child_cloning_encoder = new CloningEncoder(
+                        CloningEncoder::ResultObjectPolicy::OnlyAnyDictionary,
+                        _downgrade_version_manifest);
+                    _child_writer = new Writer(*_child_cloning_encoder, {});
+                }
+                else
+                {
+                    _child_cloning_encoder->_stack.clear();
+                }
+
+                _child_writer->write(_child_writer->_no_key, value);
+
+                if (_child_cloning_encoder->has_errored(
+                        &_encoder._error_status))
+                {
+                    return;
+                }
+
+                downgraded.swap(_child_cloning_encoder->_root);
+                schema_version = target_version;
+            }
+        }
+    }
+
+    std::string schema_str = "";
+
+    // if its an unknown schema, the schema name is computed from the
+    // _original_schema_name and _original_schema_version attributes
+    if (UnknownSchema const* us = dynamic_cast<UnknownSchema const*>(value))
+    {
+        schema_str =
+            (us->_original_schema_name + "."
+             + std::to_string(us->_original_schema_version));
+    }
+    else
+    {
+        // otherwise, use the schema_name and schema_version attributes
+        schema_str = schema_name + "." + std::to_string(schema_version);
+    }
+
+    _encoder.start_object();
+
+#ifdef OTIO_INSTANCING_SUPPORT
+    _encoder.write_key("OTIO_REF_ID");
+    _encoder.write_value(next_id);
+#endif
+
+    // write the contents of the object to the encoder, either the downgraded
+    // anydictionary or the SerializableObject
+    if (downgraded.has_value())
+    {
+        for (const auto& kv: std::any_cast<AnyDictionary>(downgraded))
+        {
+            this->write(kv.first, kv.second);
+        }
+    }
+    else
+    {
+        _encoder.write_key("OTIO_SCHEMA");
+        _encoder.write_value(schema_str);
+        if (direct_downgrade)
+        {
+            value->_write_downgraded_to(*this, schema_version);
+        }
+        else
+        {
+            value->write_to(*this);
+        }
+    }
+
+    _encoder.end_object();
+
+#ifndef OTIO_INSTANCING_SUPPORT
+    auto valueEntry = _id_for_object.find(value);
+    if (valueEntry != _id_for_object.end())
+    {
+        _id_for_object.erase(valueEntry);
+    }
+#endif
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&   key,
+    IMATH_NAMESPACE::V2d value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&     key,
+    IMATH_NAMESPACE::Box2d value)
+{
+    _encoder_write_key(key);
+    _encoder.write_value(value);
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const&   key,
+    AnyDictionary const& value)
+{
+    _encoder_write_key(key);
+
+    _encoder.start_object();
+
+    for (const auto& e: value)
+    {
+        write(e.first, e.second);
+    }
+
+    _encoder.end_object();
+}
+
+void
+SerializableObject::Writer::write(
+    std::string const& key,
+    AnyVector const&   value)
+{
+    _encoder_write_key(key);
+
+    if (_can_write_subtrees(value))
+    {
+        _write_subtrees(value);
+        return;
+    }
+
+    _encoder.start_array(value.size());
+
+    for (const auto& e: value)
+    {
+        write(_no_key, e);
+    }
+
+    _encoder.end_array();
+}
+
+bool
+SerializableObject::Writer::_can_write_subtrees(AnyVector const& value) const
+{
+#ifdef OTIO_INSTANCING_SUPPORT
+    /*
+     * Reference ids are handed out in the order objects are encountered,
+     * and instances may be shared across subtrees, so the subtrees can't be
+     * written independently.
+     */
+    return false;
+#else
+    if (_max_threads < 2 || value.size() < 2)
+    {
+        return false;
+    }
+
+    for (const auto& e: value)
+    {
+        if (e.type() != typeid(SerializableObject::Retainer<>))
+        {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+void
+SerializableObject::Writer::_write_subtrees(AnyVector const& value)
+{
+    const size_t count = value.size();
+    const size_t thread_count =
+        std::min(count, static_cast<size_t>(_max_threads));
+
+    std::vector<std::unique_ptr<Encoder>> encoders;
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        encoders.emplace_back(_encoder.make_subtree_encoder());
+        if (!encoders.back())
+        {
+            // the encoder can't write subtrees, write them in order here
+            _encoder.start_array(count);
+            for (const auto& e: value)
+            {
+                write(_no_key, e);
+            }
+            _encoder.end_array();
+            return;
+        }
+    }
+
+    /*
+     * Each worker writes with its own Writer (subtree writers never spawn
+     * threads of their own), picking up the next unclaimed element until
+     * the array is exhausted.
+     */
+    std::vector<std::string> subtrees(count);
+    std::vector<ErrorStatus> errors(count);
+    std::atomic<size_t>      next_index{ 0 };
+
+    auto worker = [&](Encoder* encoder) {
+        Writer w(*encoder, _downgrade_version_manifest);
+        for (size_t i = next_index++; i < count; i = next_index++)
+        {
+            w.write(w._no_key, value[i]);
+            encoder->has_errored(&errors[i]);
+            encoder->take_subtree(&subtrees[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(worker, encoders[i].get());
+    }
+    worker(encoders[0].get());
+    for (auto& t: threads)
+    {
+        t.join();
+    }
+
+    _encoder.start_array(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (is_error(errors[i]) && !_encoder.has_errored())
+        {
+            _encoder._error(errors[i]);
+        }
+        _encoder.write_subtree(subtrees[i]);
+    }
+    _encoder.end_array();
+}
+
+void
+SerializableObject::Writer::write(std::string const& key, std::any const& value)
+{
+    std::type_info const& type = value.type();
+
+    _encoder_write_key(key);
+
+    auto e = _write_dispatch_table.find(&type);
+    if (e == _write_dispatch_table.end())
+    {
+        /*
+         * Using the address of a type_info suffers from aliasing across
+         * compilation units. If we fail on a lookup, we fallback on the
+         * by_name table, but that's slow because we have to keep making a
+         * string each time.
+         *
+         * So when we fail, we insert the address of the type_info that failed
+         * to be found, so that we'll catch it the next time.  This ensures we
+         * fail exactly once per alias per type while using this writer.
+         */
+        const auto& backup_e = _write_dispatch_table_by_name.find(type.name());
+        if (backup_e != _write_dispatch_table_by_name.end())
+        {
+            e = _write_dispatch_table.insert({ &type, backup_e->second }).first;
+        }
+    }
+
+    if (e != _write_dispatch_table.end())
+    {
+        e->second(value);
+    }
+    else
+    {
+        std::string s;
+        std::string bad_type_name =
+            (type == typeid(UnknownType))
+                ? type_name_for_error_message(
+                      std::any_cast<UnknownType>(value).type_name)
+                : type_name_for_error_message(type);
+
+        if (&key != &_no_key)
+        {
+            s = string_printf(
+                "Encountered object of unknown type '%s' under key '%s'",
+                bad_type_name.c_str(),
+                key.c_str());
+        }
+        else
+        {
+            s = string_printf(
+                "Encountered object of unknown type '%s'",
+                bad_type_name.c_str());
+        }
+
+        _encoder._error(ErrorStatus(ErrorStatus::TYPE_MISMATCH, s));
+        _encoder.write_null_value();
+    }
+}
+
+bool
+SerializableObject::is_equivalent_to(
+    SerializableObject const& other,
+    std::string*              difference_path) const
+{
+    if (difference_path)
+    {
+        difference_path->clear();
+    }
+
+    Comparer comparer(difference_path);
+    return comparer._equivalent(this, &other);
+}
+
+bool
+SerializableObject::_equivalent_via_serialization(
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    const auto policy = (CloningEncoder::ResultObjectPolicy::
+                             MathTypesConcreteAnyDictionaryResult);
+
+    CloningEncoder             e1(policy), e2(policy);
+    SerializableObject::Writer w1(e1, {});
+    SerializableObject::Writer w2(e2, {});
+
+    w1.write(w1._no_key, lhs);
+    w2.write(w2._no_key, rhs);
+
+    return (
+        !e1.has_errored() && !e2.has_errored()
+        && w1._any_equals(e1._root, e2._root));
+}
+
+bool
+SerializableObject::Comparer::equivalent(
+    char const*     key,
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    return _equivalent(lhs, rhs) || _difference_at(key);
+}
+
+bool
+SerializableObject::Comparer::equivalent(
+    char const*          key,
+    AnyDictionary const& lhs,
+    AnyDictionary const& rhs)
+{
+    return equivalent_entries(lhs, rhs) || _difference_at(key);
+}
+
+bool
+SerializableObject::Comparer::equivalent(
+    char const*      key,
+    AnyVector const& lhs,
+    AnyVector const& rhs)
+{
+    return _equivalent(lhs, rhs) || _difference_at(key);
+}
+
+bool
+SerializableObject::Comparer::equivalent(
+    char const*               key,
+    SerializableObject const* lhs,
+    SerializableObject const* rhs)
+{
+    return _equivalent(lhs, rhs) || _difference_at(key);
+}
+
+bool
+SerializableObject::Comparer::equivalent_entries(
+    AnyDictionary const& lhs,
+    AnyDictionary const& rhs)
+{
+    auto r_it = rhs.begin();
+    for (const auto& l_it: lhs)
+    {
+        if (r_it == rhs.end())
+        {
+            return _difference_at(l_it.first.c_str());
+        }
+        if (l_it.first != r_it->first)
+        {
+            // report the key that only one side has
+            return _difference_at(
+                std::min(l_it.first, r_it->first).c_str());
+        }
+        if (!_equivalent(l_it.second, r_it->second))
+        {
+            return _difference_at(l_it.first.c_str());
+        }
+        ++r_it;
+    }
+    return r_it == rhs.end() || _difference_at(r_it->first.c_str());
+}
+
+template <typename T, typename... Rest>
+static bool
+_simple_any_equals(std::any const& lhs, std::any const& rhs, bool* result)
+{
+    if (lhs.type() == typeid(T))
+    {
+        *result = std::any_cast<T const&>(lhs) == std::any_cast<T const&>(rhs);
+        return true;
+    }
+    if constexpr (sizeof...(Rest) > 0)
+    {
+        return _simple_any_equals<Rest...>(lhs, rhs, result);
+    }
+    return false;
+}
+
+bool
+SerializableObject::Comparer::_equivalent(
+    std::any const& lhs,
+    std::any const& rhs)
+{
+    std::type_info const& type = lhs.type();
+    if (type == rhs.type())
+    {
+        if (type == typeid(void))
+        {
+            return true;
+        }
+        if (type == typeid(SerializableObject::Retainer<>))
+        {
+            return _equivalent(
+                std::any_cast<SerializableObject::Retainer<> const&>(lhs)
+                    .value,
+                std::any_cast<SerializableObject::Retainer<> const&>(rhs)
+                    .value);
+        }
+        if (type == typeid(AnyDictionary))
+        {
+            return equivalent_entries(
+                std::any_cast<AnyDictionary const&>(lhs),
+                std::any_cast<AnyDictionary const&>(rhs));
+        }
+        if (type == typeid(AnyVector))
+        {
+            return _equivalent(
+                std::any_cast<AnyVector const&>(lhs),
+                std::any_cast<AnyVector const&>(rhs));
+        }
+
+        bool result;
+        if (_simple_any_equals<
+                bool,
+                int64_t,
+                double,
+                std::string,
+                RationalTime,
+                TimeRange,
+                TimeTransform,
+                Color,
+                IMATH_NAMESPACE::V2d,
+                IMATH_NAMESPACE::Box2d>(lhs, rhs, &result))
+        {
+            return result;
+        }
+    }
+
+    // anything else compares the way it serializes
+    return _equivalent_via_serialization(lhs, rhs);
+}
+
+bool
+SerializableObject::Comparer::_equivalent(
+    AnyVector const& lhs,
+    AnyVector const& rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (!_equivalent(lhs[i], rhs[i]))
+        {
+            return _difference_at(i);
+        }
+    }
+    return true;
+}
+
+bool
+SerializableObject::Comparer::_equivalent(
+    SerializableObject const* lhs,
+    SerializableObject const* rhs)
+{
+    if (lhs == rhs)
+    {
+        return true;
+    }
+    if (!lhs || !rhs || lhs->_type_record() != rhs->_type_record())
+    {
+        return false;
+    }
+
+    // equal hashes mean identical content; unequal ones don't mean much,
+    // since equal times needn't have the same rate
+    ContentHash lhs_hash, rhs_hash;
+    if (lhs->_cached_content_hash(&lhs_hash)
+        && rhs->_cached_content_hash(&rhs_hash) && lhs_hash == rhs_hash)
+    {
+        return true;
+    }
+
+    if (typeid(*lhs) != typeid(*rhs) || !lhs->_has_native_fields())
+    {
+        return _equivalent_via_serialization(
+            std::any(Retainer<>(lhs)),
+            std::any(Retainer<>(rhs)));
+    }
+
+    // an object reached again through a cycle must be paired up with the
+    // same object as the first time round
+    auto e = _in_progress.find(lhs);
+    if (e != _in_progress.end())
+    {
+        return e->second == rhs;
+    }
+
+    _in_progress[lhs] = rhs;
+    bool result       = lhs->_fields_equivalent_to(*rhs, *this);
+    _in_progress.erase(lhs);
+    return result;
+}
+
+bool
+SerializableObject::Comparer::_difference_at(char const* key)
+{
+    if (_difference_path)
+    {
+        *_difference_path = _difference_path->empty()
+                                ? std::string(key)
+                                : std::string(key) + "/" + *_difference_path;
+    }
+    return false;
+}
+
+bool
+SerializableObject::Comparer::_difference_at(size_t index)
+{
+    return _difference_at(std::to_string(index).c_str());
+}
+
+SerializableObject::ContentHash
+SerializableObject::content_hash(ErrorStatus* error_status) const
+{
+    // an exposed object keeps the hashes it cached while nothing was
+    // modified through the references it handed out
+    const bool  revalidated = is_exposed() && revalidate();
+    ContentHash hash;
+    if (_cached_content_hash(&hash, revalidated))
+    {
+        return hash;
+    }
+
+    HashingEncoder e(revalidated);
+    Writer         w(e, {});
+    w.write(w._no_key, std::any(Retainer<>(this)));
+    if (e.has_errored(error_status))
+    {
+        return ContentHash();
+    }
+    return e.root_hash();
+}
+
+SerializableObject::ContentHash
+SerializableObject::_dictionaries_hash() const
+{
+    std::vector<AnyDictionary const*> dictionaries;
+    _dictionaries(dictionaries);
+
+    HashingEncoder e;
+    Writer         w(e, {});
+    for (auto dictionary: dictionaries)
+    {
+        w.write(w._no_key, *dictionary);
+    }
+    return e.top_level_hash();
+}
+
+std::string
+SerializableObject::ContentHash::to_string() const
+{
+    return string_printf(
+        "%016llx%016llx",
+        (unsigned long long) high,
+        (unsigned long long) low);
+}
+
+SerializableObject*
+SerializableObject::clone_via_serialization(ErrorStatus* error_status) const
+{
+    CloningEncoder e(
+        CloningEncoder::ResultObjectPolicy::CloneBackToSerializableObject);
+    SerializableObject::Writer w(e, {});
+
+    w.write(w._no_key, std::any(Retainer<>(this)));
+    if (e.has_errored(error_status))
+    {
+        return nullptr;
+    }
+
+    std::function<void(ErrorStatus const&)> error_function =
+        [error_status](ErrorStatus const& status) {
+            if (error_status)
+            {
+                *error_status = status;
+            }
+        };
+
+    e._resolver.finalize(error_function);
+    e._resolver.clear();
+
+    return e._root.type() == typeid(SerializableObject::Retainer<>)
+               ? std::any_cast<SerializableObject::Retainer<>&>(e._root)
+                     .take_value()
+               : nullptr;
+}
+
+// to json_string
+std::string
+serialize_json_to_string_pretty(
+    const std::any&           value,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status,
+    int                       indent,
+    int                       max_threads)
+{
+    OTIO_rapidjson::StringBuffer output_string_buffer;
+
+    JSONStringPrettyWriter json_writer(output_string_buffer);
+
+    json_writer.SetIndent(' ', indent);
+
+    JSONEncoder<decltype(json_writer)> json_encoder(json_writer, indent);
+
+    if (!SerializableObject::Writer::write_root(
+            value,
+            json_encoder,
+            schema_version_targets,
+            error_status,
+            max_threads))
+    {
+        return std::string();
+    }
+
+    return std::string(output_string_buffer.GetString());
+}
+
+// to json_string
+std::string
+serialize_json_to_string_compact(
+    const std::any&           value,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status,
+    int                       max_threads)
+{
+    OTIO_rapidjson::StringBuffer output_string_buffer;
+
+    JSONStringWriter json_writer(output_string_buffer);
+
+    JSONEncoder<decltype(json_writer)> json_encoder(json_writer);
+
+    if (!SerializableObject::Writer::write_root(
+            value,
+            json_encoder,
+            schema_version_targets,
+            error_status,
+            max_threads))
+    {
+        return std::string();
+    }
+
+    return std::string(output_string_buffer.GetString());
+}
+
+// to json_string
+std::string
+serialize_json_to_string(
+    const std::any&           value,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status,
+    int                       indent,
+    int                       max_threads)
+{
+    if (indent > 0)
+    {
+        return serialize_json_to_string_pretty(
+            value,
+            schema_version_targets,
+            error_status,
+            indent,
+            max_threads);
+    }
+    return serialize_json_to_string_compact(
+        value,
+        schema_version_targets,
+        error_status,
+        max_threads);
+}
+
+static void
+_open_output_file(
+    std::ofstream&          os,
+    std::string const&      file_name,
+    std::ios_base::openmode mode = std::ios::out)
+{
+#if defined(_WINDOWS)
+    const int wlen =
+        MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, NULL, 0);
+    std::vector<wchar_t> wchars(wlen);
+    MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, wchars.data(), wlen);
+    os.open(wchars.data(), mode);
+#else  // _WINDOWS
+    os.open(file_name, mode);
+#endif // _WINDOWS
+}
+
+/**
+ * A rapidjson output stream writing to a file descriptor through a large
+ * buffer, bypassing iostreams (and their per-character overhead).
+ */
+class FileOutputStream
+{
+public:
+    typedef char Ch;
+
+    explicit FileOutputStream(std::string const& file_name)
+        : _buffer(new char[default_capacity])
+    {
+#if defined(_WINDOWS)
+        const int wlen =
+            MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, NULL, 0);
+        std::vector<wchar_t> wchars(wlen);
+        MultiByteToWideChar(
+            CP_UTF8,
+            0,
+            file_name.c_str(),
+            -1,
+            wchars.data(),
+            wlen);
+        _fd = _wopen(
+            wchars.data(),
+            _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+            _S_IREAD | _S_IWRITE);
+#else  // _WINDOWS
+        _fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif // _WINDOWS
+    }
+
+    ~FileOutputStream() { close(false); }
+
+    bool is_open() const { return _fd >= 0; }
+
+    void Put(char c)
+    {
+        if (_size == _capacity)
+        {
+            _flush_buffer();
+        }
+        _buffer[_size++] = c;
+    }
+
+    void Flush() { _flush_buffer(); }
+
+    // Flush the buffer, optionally sync the file to disk, and close it.
+    // Returns false if anything failed to be written.
+    bool close(bool sync)
+    {
+        if (_fd < 0)
+        {
+            return !_failed;
+        }
+
+        _flush_buffer();
+#if defined(_WINDOWS)
+        if (sync && _commit(_fd) != 0)
+        {
+            _failed = true;
+        }
+        if (_close(_fd) != 0)
+        {
+            _failed = true;
+        }
+#else  // _WINDOWS
+        if (sync && ::fsync(_fd) != 0)
+        {
+            _failed = true;
+        }
+        if (::close(_fd) != 0)
+        {
+            _failed = true;
+        }
+#endif // _WINDOWS
+        _fd = -1;
+        return !_failed;
+    }
+
+    // rapidjson reserves room before writing runs of characters (a string
+    // or a JSON text of any length); the characters are then written
+    // without checking the buffer size, so the buffer grows to fit them.
+    friend void PutReserve(FileOutputStream& stream, size_t count)
+    {
+        if (stream._size + count > stream._capacity)
+        {
+            stream._flush_buffer();
+            if (count > stream._capacity)
+            {
+                stream._buffer.reset(new char[count]);
+                stream._capacity = count;
+            }
+        }
+    }
+
+    friend void PutUnsafe(FileOutputStream& stream, char c)
+    {
+        stream._buffer[stream._size++] = c;
+    }
+
+private:
+    static constexpr size_t default_capacity = 1 << 20;
+
+    void _flush_buffer()
+    {
+        char const* data = _buffer.get();
+        while (_size > 0 && !_failed)
+        {
+#if defined(_WINDOWS)
+            const int written = _write(_fd, data, unsigned(_size));
+#else  // _WINDOWS
+            const ssize_t written = ::write(_fd, data, _size);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+#endif // _WINDOWS
+            if (written <= 0)
+            {
+                _failed = true;
+                break;
+            }
+            data += written;
+            _size -= size_t(written);
+        }
+        _size = 0;
+    }
+
+    std::unique_ptr<char[]> _buffer;
+    size_t                  _capacity = default_capacity;
+    size_t                  _size     = 0;
+    int                     _fd       = -1;
+    bool                    _failed   = false;
+};
+
+using JSONFileWriter = OTIO_rapidjson::Writer<
+    FileOutputStream,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+using JSONFilePrettyWriter = OTIO_rapidjson::PrettyWriter<
+    FileOutputStream,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+bool
+serialize_json_to_file(
+    std::any const&           value,
+    std::string const&        file_name,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status,
+    int                       indent,
+    int                       max_threads,
+    bool                      sync)
+{
+    FileOutputStream output(file_name);
+    if (!output.is_open())
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_WRITE_FAILED, file_name);
+        }
+        return false;
+    }
+
+    bool status;
+    if (indent > 0)
+    {
+        JSONFilePrettyWriter json_writer(output);
+        json_writer.SetIndent(' ', unsigned(indent));
+        JSONEncoder<JSONFilePrettyWriter> json_encoder(json_writer, indent);
+        status = SerializableObject::Writer::write_root(
+            value,
+            json_encoder,
+            schema_version_targets,
+            error_status,
+            max_threads);
+    }
+    else
+    {
+        JSONFileWriter              json_writer(output);
+        JSONEncoder<JSONFileWriter> json_encoder(json_writer);
+        status = SerializableObject::Writer::write_root(
+            value,
+            json_encoder,
+            schema_version_targets,
+            error_status,
+            max_threads);
+    }
+
+    if (!output.close(sync) && status)
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_WRITE_FAILED, file_name);
+        }
+        return false;
+    }
+
+    return status;
+}
+
+std::string
+serialize_binary_to_string(
+    const std::any&           value,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status)
+{
+    BinaryEncoder binary_encoder;
+
+    if (!SerializableObject::Writer::write_root(
+            value,
+            binary_encoder,
+            schema_version_targets,
+            error_status))
+    {
+        return std::string();
+    }
+
+    std::string result;
+    binary_encoder.finish(&result);
+    return result;
+}
+
+bool
+serialize_binary_to_file(
+    const std::any&           value,
+    std::string const&        file_name,
+    const schema_version_map* schema_version_targets,
+    ErrorStatus*              error_status)
+{
+    std::string const result =
+        serialize_binary_to_string(value, schema_version_targets, error_status);
+    if (result.empty())
+    {
+        return false;
+    }
+
+    std::ofstream os;
+    _open_output_file(os, file_name, std::ios::out | std::ios::binary);
+    if (!os.is_open()
+        || !os.write(result.data(), std::streamsize(result.size())))
+    {
+        if (error_status)
+        {
+            *error_status =
+                ErrorStatus(ErrorStatus::FILE_WRITE_FAILED, file_name);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+using JSONStreamWriter = OTIO_rapidjson::Writer<
+    OTIO_rapidjson::OStreamWrapper,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+using JSONStreamPrettyWriter = OTIO_rapidjson::PrettyWriter<
+    OTIO_rapidjson::OStreamWrapper,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::UTF8<>,
+    OTIO_rapidjson::CrtAllocator,
+    OTIO_rapidjson::kWriteNanAndInfFlag>;
+
+/**
+ * An encoder that records the calls made on it, so that they can be played
+ * back on another encoder in two parts: up to and including the start of
+ * the "children" array at the given path of keys, and the rest after it.
+ */
+class RecordingEncoder : public Encoder
+{
+public:
+    using Event = std::function<void(Encoder&)>;
+
+    RecordingEncoder(Encoder& target, std::vector<std::string> children_path)
+        : _target(target)
+        , _children_path(std::move(children_path))
+    {}
+
+    void start_object() override
+    {
+        _record([](Encoder& e) { e.start_object(); });
+        _keys.emplace_back();
+    }
+
+    void end_object() override
+    {
+        _record([](Encoder& e) { e.end_object(); });
+        _keys.pop_back();
+    }
+
+    void start_array(size_t size) override
+    {
+        _record([size](Encoder& e) { e.start_array(size); });
+        _keys.emplace_back();
+    }
+
+    void end_array() override
+    {
+        _record([](Encoder& e) { e.end_array(); });
+        _keys.pop_back();
+    }
+
+    void write_key(std::string const& key) override
+    {
+        _record([key](Encoder& e) { e.write_key(key); });
+        if (!_keys.empty())
+        {
+            _keys.back() = key;
+            if (_keys == _children_path)
+            {
+                // the start of the (empty) array comes next
+                _split = _events.size();
+            }
+        }
+    }
+
+    void write_null_value() override
+    {
+        _record([](Encoder& e) { e.write_null_value(); });
+    }
+
+    void write_value(bool value) override { _record_value(value); }
+    void write_value(int value) override { _record_value(value); }
+    void write_value(int64_t value) override { _record_value(value); }
+    void write_value(uint64_t value) override { _record_value(value); }
+    void write_value(double value) override { _record_value(value); }
+    void write_value(std::string const& value) override
+    {
+        _record_value(value);
+    }
+    void write_value(RationalTime const& value) override
+    {
+        _record_value(value);
+    }
+    void write_value(TimeRange const& value) override { _record_value(value); }
+    void write_value(TimeTransform const& value) override
+    {
+        _record_value(value);
+    }
+    void write_value(Color const& value) override { _record_value(value); }
+    void write_value(SerializableObject::ReferenceId value) override
+    {
+        _record_value(value);
+    }
+    void write_value(IMATH_NAMESPACE::Box2d const& value) override
+    {
+        _record_value(value);
+    }
+    void write_value(IMATH_NAMESPACE::V2d const& value) override
+    {
+        _record_value(value);
+    }
+
+    bool accepts_json_text(char const* json, size_t length) override
+    {
+        return _target.accepts_json_text(json, length);
+    }
+
+    void write_json_text(char const* json, size_t length) override
+    {
+        _record([text = std::string(json, length)](Encoder& e) {
+            e.write_json_text(text.data(), text.size());
+        });
+    }
+
+    /*
+     * Play back the calls up to the start of the children array, and
+     * return the calls after its end.
+     */
+    std::vector<Event> play_head()
+    {
+        std::vector<Event> tail;
+        if (_split == 0 || _split + 1 >= _events.size())
+        {
+            _error(ErrorStatus(
+                ErrorStatus::INTERNAL_ERROR,
+                "no children array to stream into"));
+            return tail;
+        }
+
+        for (size_t i = 0; i <= _split; ++i)
+        {
+            _events[i](_target);
+        }
+        tail.assign(
+            std::make_move_iterator(_events.begin() + _split + 2),
+            std::make_move_iterator(_events.end()));
+        return tail;
+    }
 
-    for (const auto& e: value)
+private:
+    template <typename T>
+    void _record_value(T const& value)
     {
-        write(e.first, e.second);
+        _record([value](Encoder& e) { e.write_value(value); });
     }
 
-    _encoder.end_object();
-}
-
-void
-SerializableObject::Writer::write(
-    std::string const& key,
-    AnyVector const&   value)
-{
-    _encoder_write_key(key);
+    void _record(Event event) { _events.push_back(std::move(event)); }
 
-    _encoder.start_array(value.size());
+    Encoder&                 _target;
+    std::vector<std::string> _children_path;
+    std::vector<std::string> _keys;
+    std::vector<Event>       _events;
+    size_t                   _split = 0;
+};
 
-    for (const auto& e: value)
+/**
+ * The stream writer writes the timeline (with an empty stack) and each
+ * track (without children) through a regular Writer, so that their fields
+ * come from their write_to() methods and are downgraded like any other
+ * object.  The calls are recorded, and played back up to the "children"
+ * array, which is left open for the appended items; the rest is played
+ * back when the track or the timeline ends.
+ */
+class TimelineStreamWriter::Impl
+{
+public:
+    Impl(
+        std::unique_ptr<std::ofstream> file,
+        std::ostream&                  output,
+        int                            indent,
+        const schema_version_map*      schema_version_targets)
+        : _file(std::move(file))
+        , _output(output)
+        , _stream_wrapper(output)
+        , _schema_version_targets(schema_version_targets)
     {
-        write(_no_key, e);
+        if (indent > 0)
+        {
+            _pretty_json_writer.reset(
+                new JSONStreamPrettyWriter(_stream_wrapper));
+            _pretty_json_writer->SetIndent(' ', indent);
+            _encoder.reset(new JSONEncoder<JSONStreamPrettyWriter>(
+                *_pretty_json_writer,
+                indent));
+        }
+        else
+        {
+            _json_writer.reset(new JSONStreamWriter(_stream_wrapper));
+            _encoder.reset(
+                new JSONEncoder<JSONStreamWriter>(*_json_writer));
+        }
+        _writer = new SerializableObject::Writer(
+            *_encoder,
+            schema_version_targets);
     }
 
-    _encoder.end_array();
-}
-
-void
-SerializableObject::Writer::write(std::string const& key, std::any const& value)
-{
-    std::type_info const& type = value.type();
-
-    _encoder_write_key(key);
+    ~Impl() { delete _writer; }
 
-    auto e = _write_dispatch_table.find(&type);
-    if (e == _write_dispatch_table.end())
+    bool check(ErrorStatus* error_status)
     {
-        /*
-         * Using the address of a type_info suffers from aliasing across
-         * compilation units. If we fail on a lookup, we fallback on the
-         * by_name table, but that's slow because we have to keep making a
-         * string each time.
-         *
-         * So when we fail, we insert the address of the type_info that failed
-         * to be found, so that we'll catch it the next time.  This ensures we
-         * fail exactly once per alias per type while using this writer.
-         */
-        const auto& backup_e = _write_dispatch_table_by_name.find(type.name());
-        if (backup_e != _write_dispatch_table_by_name.end())
+        if (is_error(_header_error_status))
         {
-            e = _write_dispatch_table.insert({ &type, backup_e->second }).first;
+            if (error_status)
+            {
+                *error_status = _header_error_status;
+            }
+            return false;
+        }
+        if (_encoder->has_errored(error_status))
+        {
+            return false;
         }
+        if (!_output.good())
+        {
+            if (error_status)
+            {
+                *error_status = ErrorStatus(ErrorStatus::FILE_WRITE_FAILED);
+            }
+            return false;
+        }
+        return true;
     }
 
-    if (e != _write_dispatch_table.end())
+    void begin_timeline(
+        std::string const&                 name,
+        std::optional<RationalTime> const& global_start_time,
+        AnyDictionary const&               metadata)
     {
-        e->second(value);
+        SerializableObject::Retainer<Timeline> timeline(
+            new Timeline(name, global_start_time, metadata));
+        _timeline_tail = _write_head(timeline, { "tracks", "children" });
     }
-    else
-    {
-        std::string s;
-        std::string bad_type_name =
-            (type == typeid(UnknownType))
-                ? type_name_for_error_message(
-                      std::any_cast<UnknownType>(value).type_name)
-                : type_name_for_error_message(type);
 
-        if (&key != &_no_key)
+    void begin_track(Track const* track)
+    {
+        SerializableObject::Retainer<Track> empty_track(track);
+        if (!track->children().empty())
         {
-            s = string_printf(
-                "Encountered object of unknown type '%s' under key '%s'",
-                bad_type_name.c_str(),
-                key.c_str());
+            empty_track = dynamic_cast<Track*>(track->clone());
+            if (empty_track)
+            {
+                empty_track.value->clear_children();
+            }
         }
-        else
+        if (!empty_track)
         {
-            s = string_printf(
-                "Encountered object of unknown type '%s'",
-                bad_type_name.c_str());
+            _header_error_status = ErrorStatus(
+                ErrorStatus::INTERNAL_ERROR,
+                "cannot copy the track to stream into");
+            return;
         }
 
-        _encoder._error(ErrorStatus(ErrorStatus::TYPE_MISMATCH, s));
-        _encoder.write_null_value();
+        _track_tail = _write_head(empty_track, { "children" });
+        _in_track   = true;
     }
-}
 
-bool
-SerializableObject::is_equivalent_to(SerializableObject const& other) const
-{
-    if (_type_record() != other._type_record())
+    void append(Composable const* child)
     {
-        return false;
+        _writer->write(
+            _writer->_no_key,
+            static_cast<SerializableObject const*>(child));
+        _forget_written_objects();
     }
 
-    const auto policy = (CloningEncoder::ResultObjectPolicy::
-                             MathTypesConcreteAnyDictionaryResult);
+    void end_track()
+    {
+        _encoder->end_array();
+        _play(_track_tail);
+        _in_track = false;
+    }
 
-    CloningEncoder             e1(policy), e2(policy);
-    SerializableObject::Writer w1(e1, {});
-    SerializableObject::Writer w2(e2, {});
+    void end_timeline()
+    {
+        _encoder->end_array();
+        _play(_timeline_tail);
+        _output.flush();
+        if (_file)
+        {
+            _file->close();
+        }
+        _closed = true;
+    }
 
-    w1.write(w1._no_key, std::any(Retainer<>(this)));
-    w2.write(w2._no_key, std::any(Retainer<>(&other)));
+    bool in_track() const { return _in_track; }
 
-    return (
-        !e1.has_errored() && !e2.has_errored()
-        && w1._any_equals(e1._root, e2._root));
-}
+    bool closed() const { return _closed; }
 
-SerializableObject*
-SerializableObject::clone(ErrorStatus* error_status) const
-{
-    CloningEncoder e(
-        CloningEncoder::ResultObjectPolicy::CloneBackToSerializableObject);
-    SerializableObject::Writer w(e, {});
+private:
+    /*
+     * Write the object up to the start of the children array at the given
+     * path, and return the calls that finish it.
+     */
+    std::vector<RecordingEncoder::Event> _write_head(
+        SerializableObject const*       object,
+        std::vector<std::string> const& children_path)
+    {
+        RecordingEncoder          recorder(*_encoder, children_path);
+        SerializableObject::Writer writer(recorder, _schema_version_targets);
 
-    w.write(w._no_key, std::any(Retainer<>(this)));
-    if (e.has_errored(error_status))
+        // the ids of the objects written so far carry on
+        writer._next_id_for_type = _writer->_next_id_for_type;
+        writer.write(writer._no_key, object);
+        _writer->_next_id_for_type = writer._next_id_for_type;
+
+        std::vector<RecordingEncoder::Event> tail;
+        if (!recorder.has_errored(&_header_error_status))
+        {
+            tail = recorder.play_head();
+            recorder.has_errored(&_header_error_status);
+        }
+        _forget_written_objects();
+        return tail;
+    }
+
+    void _play(std::vector<RecordingEncoder::Event> const& events)
     {
-        return nullptr;
+        for (const auto& event: events)
+        {
+            event(*_encoder);
+        }
     }
 
-    std::function<void(ErrorStatus const&)> error_function =
-        [error_status](ErrorStatus const& status) {
-            if (error_status)
-            {
-                *error_status = status;
-            }
-        };
+    void _forget_written_objects()
+    {
+        /*
+         * Written objects may be deleted right away, and their addresses
+         * reused by objects appended later, so the writer must not
+         * remember them.
+         */
+        _writer->_id_for_object.clear();
+    }
 
-    e._resolver.finalize(error_function);
+    std::unique_ptr<std::ofstream>          _file;
+    std::ostream&                           _output;
+    OTIO_rapidjson::OStreamWrapper          _stream_wrapper;
+    std::unique_ptr<JSONStreamWriter>       _json_writer;
+    std::unique_ptr<JSONStreamPrettyWriter> _pretty_json_writer;
+    std::unique_ptr<Encoder>                _encoder;
+    SerializableObject::Writer*             _writer = nullptr;
+    const schema_version_map*               _schema_version_targets;
+    std::vector<RecordingEncoder::Event>    _timeline_tail;
+    std::vector<RecordingEncoder::Event>    _track_tail;
+    ErrorStatus                             _header_error_status;
+    bool                                    _in_track = false;
+    bool                                    _closed   = false;
+};
 
-    return e._root.type() == typeid(SerializableObject::Retainer<>)
-               ? std::any_cast<SerializableObject::Retainer<>&>(e._root)
-                     .take_value()
-               : nullptr;
+TimelineStreamWriter::TimelineStreamWriter(
+    std::string const&          file_name,
+    std::string const&          name,
+    std::optional<RationalTime> global_start_time,
+    AnyDictionary const&        metadata,
+    int                         indent,
+    const schema_version_map*   schema_version_targets)
+{
+    std::unique_ptr<std::ofstream> file(new std::ofstream);
+    _open_output_file(*file, file_name);
+    if (!file->is_open())
+    {
+        return;
+    }
+
+    std::ostream& output = *file;
+    _impl.reset(
+        new Impl(std::move(file), output, indent, schema_version_targets));
+    _impl->begin_timeline(name, global_start_time, metadata);
 }
 
-// to json_string
-std::string
-serialize_json_to_string_pretty(
-    const std::any&           value,
-    const schema_version_map* schema_version_targets,
-    ErrorStatus*              error_status,
-    int                       indent)
+TimelineStreamWriter::TimelineStreamWriter(
+    std::ostream&               output,
+    std::string const&          name,
+    std::optional<RationalTime> global_start_time,
+    AnyDictionary const&        metadata,
+    int                         indent,
+    const schema_version_map*   schema_version_targets)
+    : _impl(new Impl(nullptr, output, indent, schema_version_targets))
 {
-    OTIO_rapidjson::StringBuffer output_string_buffer;
-
-    OTIO_rapidjson::PrettyWriter<
-        decltype(output_string_buffer),
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::CrtAllocator,
-        OTIO_rapidjson::kWriteNanAndInfFlag>
-        json_writer(output_string_buffer);
+    _impl->begin_timeline(name, global_start_time, metadata);
+}
 
-    json_writer.SetIndent(' ', indent);
+TimelineStreamWriter::~TimelineStreamWriter()
+{
+    close();
+}
 
-    JSONEncoder<decltype(json_writer)> json_encoder(json_writer);
+bool
+TimelineStreamWriter::is_open() const noexcept
+{
+    return _impl && !_impl->closed();
+}
 
-    if (!SerializableObject::Writer::write_root(
-            value,
-            json_encoder,
-            schema_version_targets,
-            error_status))
+bool
+TimelineStreamWriter::_check_open(ErrorStatus* error_status) const
+{
+    if (!is_open())
     {
-        return std::string();
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::FILE_WRITE_FAILED,
+                "stream writer is not open");
+        }
+        return false;
     }
-
-    return std::string(output_string_buffer.GetString());
+    return true;
 }
 
-// to json_string
-std::string
-serialize_json_to_string_compact(
-    const std::any&           value,
-    const schema_version_map* schema_version_targets,
-    ErrorStatus*              error_status)
+bool
+TimelineStreamWriter::begin_track(
+    std::string const&   name,
+    std::string const&   kind,
+    AnyDictionary const& metadata,
+    ErrorStatus*         error_status)
 {
-    OTIO_rapidjson::StringBuffer output_string_buffer;
-
-    OTIO_rapidjson::Writer<
-        decltype(output_string_buffer),
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::CrtAllocator,
-        OTIO_rapidjson::kWriteNanAndInfFlag>
-        json_writer(output_string_buffer);
+    SerializableObject::Retainer<Track> track(
+        new Track(name, std::nullopt, kind, metadata));
+    return begin_track(track, error_status);
+}
 
-    JSONEncoder<decltype(json_writer)> json_encoder(json_writer);
+bool
+TimelineStreamWriter::begin_track(Track const* track, ErrorStatus* error_status)
+{
+    if (!_check_open(error_status))
+    {
+        return false;
+    }
 
-    if (!SerializableObject::Writer::write_root(
-            value,
-            json_encoder,
-            schema_version_targets,
-            error_status))
+    if (_impl->in_track() && !end_track(error_status))
     {
-        return std::string();
+        return false;
     }
 
-    return std::string(output_string_buffer.GetString());
+    _impl->begin_track(track);
+    return _impl->check(error_status);
 }
 
-// to json_string
-std::string
-serialize_json_to_string(
-    const std::any&           value,
-    const schema_version_map* schema_version_targets,
-    ErrorStatus*              error_status,
-    int                       indent)
+bool
+TimelineStreamWriter::append(Composable* child, ErrorStatus* error_status)
 {
-    if (indent > 0)
+    SerializableObject::Retainer<Composable> retainer(child);
+
+    if (!_check_open(error_status))
     {
-        return serialize_json_to_string_pretty(
-            value,
-            schema_version_targets,
-            error_status,
-            indent);
+        return false;
     }
-    return serialize_json_to_string_compact(
-        value,
-        schema_version_targets,
-        error_status);
+
+    if (!_impl->in_track())
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::INTERNAL_ERROR,
+                "append() called without a current track");
+        }
+        return false;
+    }
+
+    _impl->append(child);
+    return _impl->check(error_status);
 }
 
 bool
-serialize_json_to_file(
-    std::any const&           value,
-    std::string const&        file_name,
-    const schema_version_map* schema_version_targets,
-    ErrorStatus*              error_status,
-    int                       indent)
+TimelineStreamWriter::end_track(ErrorStatus* error_status)
 {
+    if (!_check_open(error_status))
+    {
+        return false;
+    }
 
-#if defined(_WINDOWS)
-    const int wlen =
-        MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, NULL, 0);
-    std::vector<wchar_t> wchars(wlen);
-    MultiByteToWideChar(CP_UTF8, 0, file_name.c_str(), -1, wchars.data(), wlen);
-    std::ofstream os(wchars.data());
-#else  // _WINDOWS
-    std::ofstream os(file_name);
-#endif // _WINDOWS
-
-    if (!os.is_open())
+    if (!_impl->in_track())
     {
         if (error_status)
         {
-            *error_status =
-                ErrorStatus(ErrorStatus::FILE_WRITE_FAILED, file_name);
+            *error_status = ErrorStatus(
+                ErrorStatus::INTERNAL_ERROR,
+                "end_track() called without a current track");
         }
         return false;
     }
 
-    OTIO_rapidjson::OStreamWrapper osw(os);
-    bool                           status;
-
-    OTIO_rapidjson::PrettyWriter<
-        decltype(osw),
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::UTF8<>,
-        OTIO_rapidjson::CrtAllocator,
-        OTIO_rapidjson::kWriteNanAndInfFlag>
-                                       json_writer(osw);
-    JSONEncoder<decltype(json_writer)> json_encoder(json_writer);
+    _impl->end_track();
+    return _impl->check(error_status);
+}
 
-    if (indent >= 0)
+bool
+TimelineStreamWriter::close(ErrorStatus* error_status)
+{
+    if (!_check_open(error_status))
     {
-        json_writer.SetIndent(' ', indent);
+        return false;
     }
 
-    status = SerializableObject::Writer::write_root(
-        value,
-        json_encoder,
-        schema_version_targets,
-        error_status);
+    if (_impl->in_track())
+    {
+        _impl->end_track();
+    }
 
-    return status;
+    _impl->end_timeline();
+    return _impl->check(error_status);
 }
 
 SerializableObject::Writer::~Writer()
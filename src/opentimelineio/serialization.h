@@ -14,18 +14,53 @@
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 /// @brief Serialize JSON data to a string.
+///
+/// When max_threads is greater than one, independent subtrees (such as the
+/// tracks of a stack or the children of a serializable collection) are
+/// encoded concurrently into separate buffers and spliced back in order.
+/// The result is byte-for-byte identical to the single threaded output.
 std::string serialize_json_to_string(
     const std::any&           value,
     const schema_version_map* schema_version_targets = nullptr,
     ErrorStatus*              error_status           = nullptr,
-    int                       indent                 = 4);
+    int                       indent                 = 4,
+    int                       max_threads            = 1);
 
 /// @brief Serialize JSON data to a file.
+///
+/// As with serialize_json_to_string(), the JSON is written without any
+/// whitespace when indent is zero or negative.  See
+/// serialize_json_to_string() for the meaning of max_threads.
+///
+/// When sync is true, the file is flushed to disk (with fsync) before it
+/// is closed, and the function only succeeds once the data is durable.
 bool serialize_json_to_file(
     const std::any&           value,
     std::string const&        file_name,
     const schema_version_map* schema_version_targets = nullptr,
     ErrorStatus*              error_status           = nullptr,
-    int                       indent                 = 4);
+    int                       indent                 = 4,
+    int                       max_threads            = 1,
+    bool                      sync                   = false);
+
+/// @brief Serialize data to a string in the OTIO binary format.
+///
+/// The binary format holds exactly the same data as JSON and round trips
+/// losslessly with it, but is faster to read and write: values are tagged
+/// and length-prefixed, times and ranges are stored as native doubles, and
+/// keys and schema names are stored once in a string table.
+///
+/// Returns an empty string on error.
+std::string serialize_binary_to_string(
+    const std::any&           value,
+    const schema_version_map* schema_version_targets = nullptr,
+    ErrorStatus*              error_status           = nullptr);
+
+/// @brief Serialize data to a file in the OTIO binary format.
+bool serialize_binary_to_file(
+    const std::any&           value,
+    std::string const&        file_name,
+    const schema_version_map* schema_version_targets = nullptr,
+    ErrorStatus*              error_status           = nullptr);
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -165,4 +165,10 @@ Stack::available_image_bounds(ErrorStatus* error_status) const
     return box;
 }
 
+SerializableObject*
+Stack::_clone_instance() const
+{
+    return new Stack;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -15,4 +15,10 @@ TimeEffect::TimeEffect(
 TimeEffect::~TimeEffect()
 {}
 
+SerializableObject*
+TimeEffect::_clone_instance() const
+{
+    return new TimeEffect;
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
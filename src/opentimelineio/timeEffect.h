@@ -33,6 +33,8 @@ public:
 
 protected:
     virtual ~TimeEffect();
+
+    SerializableObject* _clone_instance() const override;
 };
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
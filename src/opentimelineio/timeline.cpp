@@ -3,6 +3,10 @@
 
 #include "opentimelineio/timeline.h"
 #include "opentimelineio/clip.h"
+#include "opentimelineio/linearTimeWarp.h"
+
+#include <algorithm>
+#include <utility>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
@@ -13,22 +17,34 @@ Timeline::Timeline(
     : SerializableObjectWithMetadata(name, metadata)
     , _global_start_time(global_start_time)
     , _tracks(new Stack("tracks"))
-{}
+{
+    _link_held(_tracks);
+}
 
 Timeline::~Timeline()
-{}
+{
+    _unlink_held(_tracks);
+}
 
 void
 Timeline::set_tracks(Stack* stack)
 {
+    mark_modified();
+    _unlink_held(_tracks);
     _tracks = stack ? stack : new Stack("tracks");
+    _link_held(_tracks);
 }
 
 bool
 Timeline::read_from(Reader& reader)
 {
-    return reader.read("tracks", &_tracks)
-           && reader.read_if_present("global_start_time", &_global_start_time)
+    _unlink_held(_tracks);
+    if (!reader.read("tracks", &_tracks))
+    {
+        return false;
+    }
+    _link_held(_tracks);
+    return reader.read_if_present("global_start_time", &_global_start_time)
            && Parent::read_from(reader);
 }
 
@@ -86,4 +102,589 @@ Timeline::find_clips(
         shallow_search);
 }
 
+namespace {
+
+// The trimmed start time of each item from the root down, and its start
+// time in its parent, so that times are moved up to the root in the same
+// steps as Item::transformed_time().
+using TimePath = std::vector<std::pair<RationalTime, RationalTime>>;
+
+RationalTime
+to_root_time(RationalTime time, TimePath const& path)
+{
+    for (auto i = path.rbegin(); i != path.rend(); ++i)
+    {
+        time -= i->first;
+        time += i->second;
+    }
+    return time;
+}
+
+// Trim the range to the window, and return whether any of it is left. A
+// range without a duration is left if it is inside the window.
+bool
+trim_to_window(TimeRange& range, std::optional<TimeRange> const& window)
+{
+    if (!window)
+    {
+        return true;
+    }
+
+    const RationalTime start =
+        std::max(range.start_time(), window->start_time());
+    const RationalTime end =
+        std::min(range.end_time_exclusive(), window->end_time_exclusive());
+    if (!(start < end || (range.duration().value() == 0 && start == end)))
+    {
+        return false;
+    }
+    if (start != range.start_time() || end != range.end_time_exclusive())
+    {
+        range = TimeRange::range_from_start_end_time(start, end);
+    }
+    return true;
+}
+
+// Return the transform from the time of the item's parent to the time of
+// the item, given the item's range in its parent, or nothing if the item
+// has a time effect that isn't linear. A linear time warp (or a freeze
+// frame, which is one with a scalar of zero) scales the time from the
+// start of the range.
+std::optional<TimeTransform>
+child_time_transform(Item const* item, TimeRange const& range_in_parent)
+{
+    double scale = 1;
+    for (const auto& effect: item->effects())
+    {
+        if (auto warp = dynamic_cast<LinearTimeWarp const*>(effect.value))
+        {
+            scale *= warp->time_scalar();
+        }
+        else if (dynamic_cast<TimeEffect const*>(effect.value))
+        {
+            return std::nullopt;
+        }
+    }
+
+    const RationalTime start = range_in_parent.start_time();
+    return TimeTransform(
+        -RationalTime(start.value() * scale, start.rate()),
+        scale);
+}
+
+// Return the transform from the time of the root to the time of the item,
+// given the transform to the time of its parent, the transform from there
+// to the item, and the item's trimmed start time.
+TimeTransform
+composed_time_transform(
+    TimeTransform const& to_parent,
+    TimeTransform const& to_child,
+    RationalTime         trimmed_start)
+{
+    // t * a + b, then (t * a + b) * c + d = t * (a * c) + (b * c + d)
+    const RationalTime offset = to_parent.offset();
+    return TimeTransform(
+        RationalTime(offset.value() * to_child.scale(), offset.rate())
+            + to_child.offset() + trimmed_start,
+        to_parent.scale() * to_child.scale(),
+        trimmed_start.rate());
+}
+
+// Call visitor.add_marker(marker, item, range) for the markers of the item
+// and of the items below it, and visitor.add_item(item, range, visible,
+// transform) for the items below it. The path ends with the item, the
+// window is the visible part of the item, and the range of each item is in
+// the time of the root. The transform maps the time of the root to the
+// time of the item, and is nothing below a time effect that isn't linear.
+template <typename Visitor>
+void walk_items(
+    Item*                               item,
+    TimePath&                           path,
+    std::optional<TimeRange> const&     window,
+    bool                                visible,
+    std::optional<TimeTransform> const& transform,
+    Visitor&                            visitor,
+    ErrorStatus*                        error_status);
+
+// Call visitor.add_item() for a child of the item at the end of the path,
+// given the child's range in the item, then walk the items below the child
+// (see walk_items()). The window, visibility and transform are the item's.
+template <typename Visitor>
+void
+walk_child(
+    Item*                               child,
+    TimeRange const&                    range_in_parent,
+    TimePath&                           path,
+    std::optional<TimeRange> const&     window,
+    bool                                visible,
+    std::optional<TimeTransform> const& transform,
+    Visitor&                            visitor,
+    ErrorStatus*                        error_status)
+{
+    const TimeRange trimmed_range = child->trimmed_range(error_status);
+    if (is_error(error_status))
+    {
+        return;
+    }
+
+    TimeRange range(
+        to_root_time(range_in_parent.start_time(), path),
+        range_in_parent.duration());
+    const bool child_visible = visible && trim_to_window(range, window);
+
+    std::optional<TimeTransform> child_transform;
+    if (transform)
+    {
+        if (auto to_child = child_time_transform(child, range_in_parent))
+        {
+            child_transform = composed_time_transform(
+                *transform,
+                *to_child,
+                trimmed_range.start_time());
+        }
+    }
+    visitor.add_item(child, range, child_visible, child_transform);
+
+    path.emplace_back(trimmed_range.start_time(), range_in_parent.start_time());
+    walk_items(
+        child,
+        path,
+        range,
+        child_visible,
+        child_transform,
+        visitor,
+        error_status);
+    path.pop_back();
+}
+
+template <typename Visitor>
+void
+walk_items(
+    Item*                               item,
+    TimePath&                           path,
+    std::optional<TimeRange> const&     window,
+    bool                                visible,
+    std::optional<TimeTransform> const& transform,
+    Visitor&                            visitor,
+    ErrorStatus*                        error_status)
+{
+    // the const markers(), which doesn't count as a modification
+    for (const auto& marker: std::as_const(*item).markers())
+    {
+        const TimeRange marked_range = marker->marked_range();
+        visitor.add_marker(
+            marker.value,
+            item,
+            TimeRange(
+                to_root_time(marked_range.start_time(), path),
+                marked_range.duration()));
+    }
+
+    auto composition = dynamic_cast<Composition*>(item);
+    if (!composition || composition->children().empty())
+    {
+        return;
+    }
+
+    const auto ranges = composition->range_of_all_children(error_status);
+    if (is_error(error_status))
+    {
+        return;
+    }
+    for (const auto& child: composition->children())
+    {
+        // without an error status, a failed range_of_all_children() still
+        // returns, with no ranges
+        auto child_item  = dynamic_cast<Item*>(child.value);
+        auto child_range = ranges.find(child.value);
+        if (!child_item || child_range == ranges.end())
+        {
+            continue;
+        }
+
+        walk_child(
+            child_item,
+            child_range->second,
+            path,
+            window,
+            visible,
+            transform,
+            visitor,
+            error_status);
+        if (is_error(error_status))
+        {
+            return;
+        }
+    }
+}
+
+// Return whether two windows are the same, exactly, since anything trimmed
+// to them would change with them.
+bool
+same_window(
+    std::optional<TimeRange> const& a,
+    std::optional<TimeRange> const& b)
+{
+    if (!a || !b)
+    {
+        return !a && !b;
+    }
+    return a->start_time().value() == b->start_time().value()
+           && a->start_time().rate() == b->start_time().rate()
+           && a->duration().value() == b->duration().value()
+           && a->duration().rate() == b->duration().rate();
+}
+
+} // namespace
+
+std::shared_ptr<Timeline::_Index const>
+Timeline::_current_index(ErrorStatus* error_status) const
+{
+    // what the index depends on leaves out the dictionaries; the tracks
+    // are revalidated first, so that what was modified through the
+    // references they handed out has a new revision
+    const bool     valid    = _tracks->revalidate(false);
+    const uint64_t revision = _tracks->revision();
+    std::shared_ptr<_Index const> previous;
+    {
+        std::lock_guard<std::mutex> lock(_index_mutex);
+        if (_index && _index_revision == revision && valid)
+        {
+            return _index;
+        }
+        previous = _index;
+    }
+
+    auto index    = std::make_shared<_Index>();
+    index->window = _tracks->source_range();
+    if (previous && !same_window(previous->window, index->window))
+    {
+        previous = nullptr;
+    }
+
+    // the markers of the tracks themselves, which are in the time of the
+    // tracks, and the parts for their children
+    std::vector<_IndexedMarker> own_markers;
+    for (const auto& marker: std::as_const(*_tracks).markers())
+    {
+        own_markers.push_back(
+            { marker.value, _tracks.value, marker->marked_range() });
+    }
+    const IntervalTree<_IndexedMarker> own_markers_tree(
+        std::move(own_markers),
+        [](_IndexedMarker const& marker) { return marker.range; });
+    std::vector<IntervalTree<_IndexedMarker> const*> markers = {
+        &own_markers_tree
+    };
+    std::vector<IntervalTree<_IndexedItem> const*> items;
+
+    auto const& children = _tracks->children();
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        auto child = dynamic_cast<Item*>(children[i].value);
+        if (!child)
+        {
+            continue;
+        }
+
+        std::shared_ptr<_IndexPart const> part;
+        if (previous && (valid || child->revalidate(false)))
+        {
+            const auto kept = previous->parts.find(child);
+            if (kept != previous->parts.end()
+                && kept->second->revision == child->revision())
+            {
+                part = kept->second;
+            }
+        }
+        if (!part)
+        {
+            part = _index_part(child, i, index->window, error_status);
+            if (!part)
+            {
+                return nullptr;
+            }
+        }
+        markers.push_back(&part->markers);
+        items.push_back(&part->items);
+        index->parts.emplace(child, std::move(part));
+    }
+    index->markers = IntervalTree<_IndexedMarker>::merged(markers);
+    index->items   = IntervalTree<_IndexedItem>::merged(items);
+
+    std::lock_guard<std::mutex> lock(_index_mutex);
+    _index          = index;
+    _index_revision = revision;
+    return index;
+}
+
+std::shared_ptr<Timeline::_IndexPart const>
+Timeline::_index_part(
+    Item*                           child,
+    size_t                          index,
+    std::optional<TimeRange> const& window,
+    ErrorStatus*                    error_status) const
+{
+    // the revision is taken first, so that a part is never newer than it
+    // claims to be
+    const uint64_t revision = child->revision();
+
+    struct Visitor
+    {
+        std::vector<_IndexedMarker> markers;
+        std::vector<_IndexedItem>   items;
+        TimeTransforms              time_transforms;
+
+        void add_marker(Marker* marker, Item* item, TimeRange range)
+        {
+            markers.push_back({ marker, item, range });
+        }
+
+        void add_item(
+            Item*                               item,
+            TimeRange                           range,
+            bool                                visible,
+            std::optional<TimeTransform> const& transform)
+        {
+            if (visible)
+            {
+                items.push_back({ item, range });
+            }
+            time_transforms.emplace(item, transform);
+        }
+    } visitor;
+
+    // the time of the tracks is the time of the root; a child without a
+    // range is an error even if the caller doesn't ask for the status, as
+    // the part would be kept
+    ErrorStatus     status;
+    const TimeRange range_in_parent =
+        _tracks->range_of_child_at_index(int(index), &status);
+    if (is_error(status))
+    {
+        if (error_status)
+        {
+            *error_status = status;
+        }
+        return nullptr;
+    }
+    TimePath path;
+    walk_child(
+        child,
+        range_in_parent,
+        path,
+        window,
+        true,
+        TimeTransform(),
+        visitor,
+        error_status);
+    if (is_error(error_status))
+    {
+        return nullptr;
+    }
+
+    return std::make_shared<_IndexPart const>(_IndexPart{
+        revision,
+        IntervalTree<_IndexedMarker>(
+            std::move(visitor.markers),
+            [](_IndexedMarker const& marker) { return marker.range; }),
+        IntervalTree<_IndexedItem>(
+            std::move(visitor.items),
+            [](_IndexedItem const& item) { return item.range; }),
+        std::move(visitor.time_transforms) });
+}
+
+std::vector<Timeline::FoundMarker>
+Timeline::find_markers(
+    ErrorStatus*                    error_status,
+    std::optional<TimeRange> const& search_range) const
+{
+    std::vector<FoundMarker> result;
+    const auto               index = _current_index(error_status);
+    if (!index)
+    {
+        return result;
+    }
+
+    auto add = [&result](_IndexedMarker const& marker) {
+        result.push_back({ marker.marker, marker.item, marker.range });
+    };
+    if (search_range)
+    {
+        index->markers.for_each_intersecting(*search_range, add);
+    }
+    else
+    {
+        result.reserve(index->markers.size());
+        for (const auto& marker: index->markers.values())
+        {
+            add(marker);
+        }
+    }
+    return result;
+}
+
+std::vector<Timeline::FoundItem>
+Timeline::find_items(
+    ErrorStatus*                    error_status,
+    std::optional<TimeRange> const& search_range) const
+{
+    std::vector<FoundItem> result;
+    const auto             index = _current_index(error_status);
+    if (!index)
+    {
+        return result;
+    }
+
+    auto add = [&result](_IndexedItem const& item) {
+        result.push_back({ item.item, item.range });
+    };
+    if (search_range)
+    {
+        index->items.for_each_intersecting(*search_range, add);
+    }
+    else
+    {
+        result.reserve(index->items.size());
+        for (const auto& item: index->items.values())
+        {
+            add(item);
+        }
+    }
+    return result;
+}
+
+std::vector<Timeline::FoundItem>
+Timeline::items_at_time(RationalTime const& time, ErrorStatus* error_status)
+    const
+{
+    std::vector<FoundItem> result;
+    if (const auto index = _current_index(error_status))
+    {
+        index->items.for_each_containing(
+            time,
+            [&result](_IndexedItem const& item) {
+                result.push_back({ item.item, item.range });
+            });
+    }
+    return result;
+}
+
+std::vector<Timeline::FoundItem>
+Timeline::nearest_items(
+    RationalTime const& time,
+    size_t              count,
+    ErrorStatus*        error_status) const
+{
+    std::vector<FoundItem> result;
+    if (const auto index = _current_index(error_status))
+    {
+        index->items.for_each_nearest(
+            time,
+            count,
+            [&result](_IndexedItem const& item) {
+                result.push_back({ item.item, item.range });
+            });
+    }
+    return result;
+}
+
+TimeTransform
+Timeline::media_time_transform(Item const* item, ErrorStatus* error_status)
+    const
+{
+    const auto index = _current_index(error_status);
+    if (!index)
+    {
+        return TimeTransform();
+    }
+
+    // the time of the tracks is the time of the root, and any other item
+    // is in the part of the child of the tracks above it
+    if (item == _tracks.value)
+    {
+        return TimeTransform();
+    }
+    Composable const* child = item;
+    while (child->parent() && child->parent() != _tracks.value)
+    {
+        child = child->parent();
+    }
+    std::optional<TimeTransform> const* transform = nullptr;
+    const auto                          part = index->parts.find(child);
+    if (part != index->parts.end())
+    {
+        const auto i = part->second->time_transforms.find(item);
+        if (i != part->second->time_transforms.end())
+        {
+            transform = &i->second;
+        }
+    }
+    if (!transform)
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::NOT_DESCENDED_FROM,
+                "Item is not in the timeline",
+                item);
+        }
+        return TimeTransform();
+    }
+    if (!*transform)
+    {
+        if (error_status)
+        {
+            *error_status = ErrorStatus(
+                ErrorStatus::NOT_IMPLEMENTED,
+                "Item, or an item above it, has a time effect that isn't "
+                "linear",
+                item);
+        }
+        return TimeTransform();
+    }
+    return **transform;
+}
+
+void
+Timeline::_held_objects(std::vector<SerializableObject*>& held) const
+{
+    Parent::_held_objects(held);
+    held.push_back(_tracks.value);
+}
+
+SerializableObject*
+Timeline::_clone_instance() const
+{
+    return new Timeline;
+}
+
+bool
+Timeline::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& timeline = static_cast<Timeline const&>(source);
+    _global_start_time   = timeline._global_start_time;
+    _unlink_held(_tracks);
+    if (!cloner.clone(timeline._tracks, &_tracks))
+    {
+        return false;
+    }
+    _link_held(_tracks);
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Timeline::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& timeline = static_cast<Timeline const&>(other);
+    return comparer.equivalent(
+               "global_start_time",
+               _global_start_time,
+               timeline._global_start_time)
+           && Parent::_fields_equivalent_to(other, comparer)
+           && comparer.equivalent("tracks", _tracks, timeline._tracks);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -3,11 +3,17 @@
 
 #pragma once
 
+#include "opentimelineio/intervalTree.h"
+#include "opentimelineio/marker.h"
 #include "opentimelineio/serializableObjectWithMetadata.h"
 #include "opentimelineio/stack.h"
 #include "opentimelineio/track.h"
 #include "opentimelineio/version.h"
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 class Clip;
@@ -102,6 +108,115 @@ public:
         std::optional<TimeRange> search_range   = std::nullopt,
         bool                     shallow_search = false) const;
 
+    /// @brief A marker found in the timeline, see find_markers().
+    struct FoundMarker
+    {
+        /// @brief The marker.
+        Retainer<Marker> marker;
+
+        /// @brief The item that holds the marker.
+        Retainer<Item> item;
+
+        /// @brief The marked range, in the time of the timeline's tracks.
+        TimeRange range;
+    };
+
+    /// @brief Find the markers of every item in the timeline.
+    ///
+    /// Each marked range is transformed from the time of its item to the
+    /// time of the tracks, as Item::transformed_time_range() does, and the
+    /// markers are returned in order of their transformed start times.
+    ///
+    /// The markers are indexed by their transformed ranges in an interval
+    /// tree, so a search only visits the markers that intersect the search
+    /// range. The index is kept while the tracks keep their revision once
+    /// they are revalidated (see SerializableObject::revalidate()), and
+    /// otherwise only the parts for the children of the tracks that changed,
+    /// or are exposed for good, are built again. Dictionaries don't count
+    /// (see SerializableObject::is_exposed()).
+    ///
+    /// @param error_status The return status.
+    /// @param search_range An optional range to limit the search to the
+    /// markers that intersect it (see TimeRange::intersects()).
+    std::vector<FoundMarker> find_markers(
+        ErrorStatus*                    error_status = nullptr,
+        std::optional<TimeRange> const& search_range = std::nullopt) const;
+
+    /// @brief An item found in the timeline, see find_items().
+    struct FoundItem
+    {
+        /// @brief The item.
+        Retainer<Item> item;
+
+        /// @brief The visible part of the item's range in its parent, in
+        /// the time of the timeline's tracks.
+        TimeRange range;
+    };
+
+    /// @brief Find the items at every depth of the timeline.
+    ///
+    /// The range of each item in its parent is transformed to the time of
+    /// the tracks, in the same steps as Item::transformed_time(), and
+    /// trimmed to the parts of its ancestors that are visible (see
+    /// Composition::trimmed_range_of_child()). Items that are trimmed away
+    /// entirely are left out, and the rest are returned in order of their
+    /// start times.
+    ///
+    /// The items are indexed in an interval tree, along with the markers
+    /// (see find_markers()), so a search only visits the items that
+    /// intersect the search range.
+    ///
+    /// @param error_status The return status.
+    /// @param search_range An optional range to limit the search to the
+    /// items that intersect it (see TimeRange::intersects()).
+    std::vector<FoundItem> find_items(
+        ErrorStatus*                    error_status = nullptr,
+        std::optional<TimeRange> const& search_range = std::nullopt) const;
+
+    /// @brief Return the items at every depth of the timeline that contain
+    /// the given time (see TimeRange::contains()), e.g. the items under the
+    /// playhead, in order of their start times.
+    ///
+    /// @param time The time, in the time of the timeline's tracks.
+    /// @param error_status The return status.
+    std::vector<FoundItem> items_at_time(
+        RationalTime const& time,
+        ErrorStatus*        error_status = nullptr) const;
+
+    /// @brief Return the items at every depth of the timeline that are
+    /// nearest to the given time, nearest first.
+    ///
+    /// The items that contain the time come first, and the others follow in
+    /// order of the distance from the time to their start or end.
+    ///
+    /// @param time The time, in the time of the timeline's tracks.
+    /// @param count The maximum number of items.
+    /// @param error_status The return status.
+    std::vector<FoundItem> nearest_items(
+        RationalTime const& time,
+        size_t              count,
+        ErrorStatus*        error_status = nullptr) const;
+
+    /// @brief Return the transform from the time of the timeline's tracks
+    /// to the time of the given item, e.g. from the playhead to the media
+    /// time of a clip.
+    ///
+    /// The transform composes the steps of Item::transformed_time() from the
+    /// tracks down to the item, with the time scalars of the linear time
+    /// warps and freeze frames of the item and of its ancestors, which scale
+    /// the time from the start of each item in its parent. It is computed
+    /// for every item when the timeline is indexed (see find_items()), so
+    /// mapping a time is a single multiply and add (see
+    /// TimeTransform::applied_to()).
+    ///
+    /// @param item The item.
+    /// @param error_status The return status, which is NOT_DESCENDED_FROM if
+    /// the item is not in the timeline, and NOT_IMPLEMENTED if the item or
+    /// one of its ancestors has a time effect that isn't linear.
+    TimeTransform media_time_transform(
+        Item const*  item,
+        ErrorStatus* error_status = nullptr) const;
+
     /// @brief Return the spatial bounds of the timeline.
     std::optional<IMATH_NAMESPACE::Box2d>
     available_image_bounds(ErrorStatus* error_status) const
@@ -115,9 +230,72 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
+    void _held_objects(std::vector<SerializableObject*>&) const override;
+
 private:
+    // The indices hold plain pointers; any change that could remove an
+    // object from the timeline also changes the revision of the tracks, or
+    // happens through a reference that revalidating them turns into one.
+    struct _IndexedMarker
+    {
+        Marker*   marker;
+        Item*     item;
+        TimeRange range;
+    };
+
+    struct _IndexedItem
+    {
+        Item*     item;
+        TimeRange range;
+    };
+
+    // The transform of each item, or nothing if the item or one of its
+    // ancestors has a time effect that isn't linear, see
+    // media_time_transform().
+    using TimeTransforms =
+        std::unordered_map<Item const*, std::optional<TimeTransform>>;
+
+    // The index of a child of the tracks and of the items below it, in the
+    // time of the tracks, as of the given revision of the child.
+    struct _IndexPart
+    {
+        uint64_t                     revision;
+        IntervalTree<_IndexedMarker> markers;
+        IntervalTree<_IndexedItem>   items;
+        TimeTransforms               time_transforms;
+    };
+
+    // The parts are kept for the next index while their children keep
+    // their revisions once revalidated, and the tracks keep the window.
+    struct _Index
+    {
+        std::optional<TimeRange>     window;
+        IntervalTree<_IndexedMarker> markers;
+        IntervalTree<_IndexedItem>   items;
+        std::unordered_map<Composable const*, std::shared_ptr<_IndexPart const>>
+            parts;
+    };
+
+    std::shared_ptr<_Index const>
+    _current_index(ErrorStatus* error_status) const;
+
+    std::shared_ptr<_IndexPart const> _index_part(
+        Item*                           child,
+        size_t                          index,
+        std::optional<TimeRange> const& window,
+        ErrorStatus*                    error_status) const;
+
     std::optional<RationalTime> _global_start_time;
     Retainer<Stack>             _tracks;
+
+    mutable std::mutex                    _index_mutex;
+    mutable std::shared_ptr<_Index const> _index;
+    mutable uint64_t                      _index_revision = 0;
 };
 
 template <typename T>
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#pragma once
+
+#include "opentimelineio/composable.h"
+#include "opentimelineio/track.h"
+#include "opentimelineio/version.h"
+
+#include <iosfwd>
+#include <memory>
+
+namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
+
+/// @brief Write a timeline to a JSON file incrementally.
+///
+/// Each appended item is serialized as soon as it is appended and then
+/// released, so peak memory is bounded by the largest single item rather
+/// than by the whole timeline:
+///
+/// @code
+/// TimelineStreamWriter w("out.otio", "conform");
+/// w.begin_track("V1");
+/// w.append(new Clip("shot_010", media_reference, source_range));
+/// w.end_track();
+/// w.close();
+/// @endcode
+///
+/// The output is identical to serializing the equivalent Timeline with
+/// serialize_json_to_file().
+class TimelineStreamWriter
+{
+public:
+    /// @brief Create a new stream writer and start writing the timeline.
+    ///
+    /// @param file_name The file name.
+    /// @param name The timeline name.
+    /// @param global_start_time The global start time of the timeline.
+    /// @param metadata The metadata for the timeline.
+    /// @param indent The number of spaces to use for indentation, a value
+    /// less than one writes compact JSON.
+    /// @param schema_version_targets Schema versions to downgrade the
+    /// timeline, its tracks and the appended items to.
+    TimelineStreamWriter(
+        std::string const&          file_name,
+        std::string const&          name              = std::string(),
+        std::optional<RationalTime> global_start_time = std::nullopt,
+        AnyDictionary const&        metadata          = AnyDictionary(),
+        int                         indent            = 4,
+        const schema_version_map*   schema_version_targets = nullptr);
+
+    /// @brief Create a new stream writer that writes to the given stream.
+    ///
+    /// The stream must outlive the writer.
+    TimelineStreamWriter(
+        std::ostream&               output,
+        std::string const&          name              = std::string(),
+        std::optional<RationalTime> global_start_time = std::nullopt,
+        AnyDictionary const&        metadata          = AnyDictionary(),
+        int                         indent            = 4,
+        const schema_version_map*   schema_version_targets = nullptr);
+
+    /// @brief Close the writer, if it has not already been closed.
+    ~TimelineStreamWriter();
+
+    TimelineStreamWriter(TimelineStreamWriter const&)            = delete;
+    TimelineStreamWriter& operator=(TimelineStreamWriter const&) = delete;
+
+    /// @brief Return whether the output was opened and has not been closed
+    /// yet.
+    bool is_open() const noexcept;
+
+    /// @brief Start a new track in the timeline's stack.
+    bool begin_track(
+        std::string const&   name         = std::string(),
+        std::string const&   kind         = Track::Kind::video,
+        AnyDictionary const& metadata     = AnyDictionary(),
+        ErrorStatus*         error_status = nullptr);
+
+    /// @brief Start a new track, taking everything but the children from
+    /// the given track.
+    bool begin_track(Track const* track, ErrorStatus* error_status = nullptr);
+
+    /// @brief Append a child to the current track.
+    ///
+    /// The child is serialized immediately.  If nothing else retains it
+    /// (e.g. it was just created with new), it is deleted afterwards.
+    bool append(Composable* child, ErrorStatus* error_status = nullptr);
+
+    /// @brief Finish the current track.
+    bool end_track(ErrorStatus* error_status = nullptr);
+
+    /// @brief Finish the timeline and close the output.
+    ///
+    /// A track that is still open is finished first.
+    bool close(ErrorStatus* error_status = nullptr);
+
+private:
+    bool _check_open(ErrorStatus* error_status) const;
+
+    class Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+}} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -6,6 +6,9 @@
 #include "opentimelineio/gap.h"
 #include "opentimelineio/transition.h"
 #include "opentimelineio/vectorIndexing.h"
+#include "exactSum.h"
+
+#include <type_traits>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
@@ -63,13 +66,16 @@ Track::range_of_child_at_index(int index, ErrorStatus* error_status) const
     }
 
     RationalTime start_time(0, child_duration.rate());
+    ExactSum     exact_start_time;
 
     for (int i = 0; i < index; i++)
     {
         Composable* child2 = children()[i];
         if (!child2->overlapping())
         {
-            start_time += children()[i]->duration(error_status);
+            const RationalTime duration = child2->duration(error_status);
+            start_time += duration;
+            exact_start_time.add(duration);
         }
         if (is_error(error_status))
         {
@@ -80,9 +86,10 @@ Track::range_of_child_at_index(int index, ErrorStatus* error_status) const
     if (auto transition = dynamic_cast<Transition*>(child))
     {
         start_time -= transition->in_offset();
+        exact_start_time.subtract(transition->in_offset());
     }
 
-    return TimeRange(start_time, child_duration);
+    return TimeRange(exact_start_time.exact(start_time), child_duration);
 }
 
 TimeRange
@@ -112,15 +119,18 @@ TimeRange
 Track::available_range(ErrorStatus* error_status) const
 {
     RationalTime duration;
+    ExactSum     exact_duration;
     for (const auto& child: children())
     {
         if (auto item = dynamic_retainer_cast<Item>(child))
         {
-            duration += item->duration(error_status);
+            const RationalTime item_duration = item->duration(error_status);
             if (is_error(error_status))
             {
                 return TimeRange();
             }
+            duration += item_duration;
+            exact_duration.add(item_duration);
         }
     }
 
@@ -130,14 +140,17 @@ Track::available_range(ErrorStatus* error_status) const
                 dynamic_retainer_cast<Transition>(children().front()))
         {
             duration += transition->in_offset();
+            exact_duration.add(transition->in_offset());
         }
         if (auto transition =
                 dynamic_retainer_cast<Transition>(children().back()))
         {
             duration += transition->out_offset();
+            exact_duration.add(transition->out_offset());
         }
     }
 
+    duration = exact_duration.exact(duration);
     return TimeRange(RationalTime(0, duration.rate()), duration);
 }
 
@@ -238,21 +251,28 @@ Track::range_of_all_children(ErrorStatus* error_status) const
     }
 
     RationalTime last_end_time(0, rate);
+    ExactSum     exact_end_time;
     for (const auto& child: children())
     {
         if (auto transition = dynamic_retainer_cast<Transition>(child))
         {
+            ExactSum exact_start_time = exact_end_time;
+            exact_start_time.subtract(transition->in_offset());
             result[child] = TimeRange(
-                last_end_time - transition->in_offset(),
+                exact_start_time.exact(
+                    last_end_time - transition->in_offset()),
                 transition->out_offset() + transition->in_offset());
         }
         else if (auto item = dynamic_retainer_cast<Item>(child))
         {
+            const RationalTime duration =
+                item->trimmed_range(error_status).duration();
             auto last_range = TimeRange(
-                last_end_time,
-                item->trimmed_range(error_status).duration());
+                exact_end_time.exact(last_end_time),
+                duration);
             result[child] = last_range;
             last_end_time = last_range.end_time_exclusive();
+            exact_end_time.add(duration);
         }
 
         if (is_error(error_status))
@@ -264,6 +284,105 @@ Track::range_of_all_children(ErrorStatus* error_status) const
     return result;
 }
 
+std::vector<Track::CutEvent>
+Track::cut_list(ErrorStatus* error_status) const
+{
+    static_assert(
+        std::is_trivially_copyable<CutEvent>::value,
+        "cut events are copied as plain data");
+
+    std::vector<CutEvent> result;
+    if (children().empty())
+    {
+        return result;
+    }
+
+    // the same rate and running sum as range_of_all_children()
+    auto   first_child = children().front();
+    double rate        = 1;
+    if (auto transition = dynamic_retainer_cast<Transition>(first_child))
+    {
+        rate = transition->in_offset().rate();
+    }
+    else if (auto item = dynamic_retainer_cast<Item>(first_child))
+    {
+        rate = item->trimmed_range(error_status).duration().rate();
+        if (is_error(error_status))
+        {
+            return result;
+        }
+    }
+
+    result.reserve(children().size());
+    RationalTime      last_end_time(0, rate);
+    ExactSum          exact_end_time;
+    Transition const* transition_in = nullptr;
+    bool              has_event     = false;
+    for (size_t i = 0; i < children().size(); ++i)
+    {
+        Composable const* child = children()[i];
+        if (auto transition = dynamic_cast<Transition const*>(child))
+        {
+            if (has_event)
+            {
+                CutEvent& event      = result.back();
+                event.transition_out = transition;
+                event.record_out += transition->out_offset();
+                event.source_out += transition->out_offset();
+            }
+            transition_in = transition;
+            has_event     = false;
+            continue;
+        }
+
+        auto item = dynamic_cast<Item const*>(child);
+        if (!item)
+        {
+            transition_in = nullptr;
+            has_event     = false;
+            continue;
+        }
+
+        const TimeRange trimmed_range = item->trimmed_range(error_status);
+        if (is_error(error_status))
+        {
+            return result;
+        }
+        const TimeRange range(
+            exact_end_time.exact(last_end_time),
+            trimmed_range.duration());
+        last_end_time = range.end_time_exclusive();
+        exact_end_time.add(trimmed_range.duration());
+
+        has_event = item->visible();
+        if (has_event)
+        {
+            CutEvent event{ int(i),
+                            item,
+                            nullptr,
+                            nullptr,
+                            nullptr,
+                            range.start_time(),
+                            range.end_time_exclusive(),
+                            trimmed_range.start_time(),
+                            trimmed_range.end_time_exclusive() };
+            if (auto clip = dynamic_cast<Clip const*>(item))
+            {
+                event.media_reference = clip->media_reference();
+            }
+            if (transition_in)
+            {
+                event.transition_in = transition_in;
+                event.record_in -= transition_in->in_offset();
+                event.source_in -= transition_in->in_offset();
+            }
+            result.push_back(event);
+        }
+        transition_in = nullptr;
+    }
+    return result;
+}
+
 std::optional<IMATH_NAMESPACE::Box2d>
 Track::available_image_bounds(ErrorStatus* error_status) const
 {
@@ -297,4 +416,29 @@ Track::available_image_bounds(ErrorStatus* error_status) const
     return box;
 }
 
+SerializableObject*
+Track::_clone_instance() const
+{
+    return new Track;
+}
+
+bool
+Track::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    _kind = static_cast<Track const&>(source)._kind;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Track::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    return comparer.equivalent(
+               "kind",
+               _kind,
+               static_cast<Track const&>(other)._kind)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -9,6 +9,8 @@
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
 class Clip;
+class MediaReference;
+class Transition;
 
 /// @brief A track is a composition of a certain kind, like video or audio.
 class Track : public Composition
@@ -54,7 +56,11 @@ public:
     std::string kind() const noexcept { return _kind; }
 
     /// @brief Set this kind of track.
-    void set_kind(std::string const& kind) { _kind = kind; }
+    void set_kind(std::string const& kind)
+    {
+        mark_modified();
+        _kind = kind;
+    }
 
     TimeRange range_of_child_at_index(
         int          index,
@@ -79,6 +85,46 @@ public:
     std::map<Composable*, TimeRange>
     range_of_all_children(ErrorStatus* error_status = nullptr) const override;
 
+    /// @brief An event of a cut list, see cut_list().
+    ///
+    /// The event holds plain pointers and times, so a cut list is a compact
+    /// array; the pointers are valid as long as the track holds the objects.
+    struct CutEvent
+    {
+        /// @brief The index of the item in the track's children.
+        int index;
+
+        /// @brief The item, which is a clip or a composition.
+        Item const* item;
+
+        /// @brief The active media reference of a clip, or null.
+        MediaReference const* media_reference;
+
+        /// @brief The transitions into and out of the item, or null.
+        Transition const* transition_in;
+        Transition const* transition_out;
+
+        /// @brief The range of the item in the track, extended by its
+        /// transitions, with an exclusive end.
+        RationalTime record_in;
+        RationalTime record_out;
+
+        /// @brief The visible range of the item (see Item::visible_range()),
+        /// with an exclusive end.
+        RationalTime source_in;
+        RationalTime source_out;
+    };
+
+    /// @brief Return the cut list of the track: an event for each visible
+    /// item, in order. Gaps and items that are not enabled have no event.
+    ///
+    /// The record times are the ranges of range_of_all_children(), and each
+    /// event is extended by the in offset of the transition before it and
+    /// the out offset of the transition after it, as Item::visible_range()
+    /// is. The children are walked once, so this takes linear time, rather
+    /// than the quadratic time of calling range_in_parent() for each item.
+    std::vector<CutEvent> cut_list(ErrorStatus* error_status = nullptr) const;
+
     std::optional<IMATH_NAMESPACE::Box2d>
     available_image_bounds(ErrorStatus* error_status) const override;
 
@@ -90,6 +136,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string _kind;
 };
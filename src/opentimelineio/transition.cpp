@@ -85,4 +85,41 @@ Transition::trimmed_range_in_parent(ErrorStatus* error_status) const
     return parent()->trimmed_range_of_child(this, error_status);
 }
 
+SerializableObject*
+Transition::_clone_instance() const
+{
+    return new Transition;
+}
+
+bool
+Transition::_clone_fields_from(SerializableObject const& source, Cloner& cloner)
+{
+    auto const& transition = static_cast<Transition const&>(source);
+    _transition_type       = transition._transition_type;
+    _in_offset             = transition._in_offset;
+    _out_offset            = transition._out_offset;
+    return Parent::_clone_fields_from(source, cloner);
+}
+
+bool
+Transition::_fields_equivalent_to(
+    SerializableObject const& other,
+    Comparer&                 comparer) const
+{
+    auto const& transition = static_cast<Transition const&>(other);
+    return comparer.equivalent(
+               "transition_type",
+               _transition_type,
+               transition._transition_type)
+           && comparer.equivalent(
+               "in_offset",
+               _in_offset,
+               transition._in_offset)
+           && comparer.equivalent(
+               "out_offset",
+               _out_offset,
+               transition._out_offset)
+           && Parent::_fields_equivalent_to(other, comparer);
+}
+
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
@@ -51,6 +51,7 @@ public:
     /// @brief Set the transition type.
     void set_transition_type(std::string const& transition_type)
     {
+        mark_modified();
         _transition_type = transition_type;
     }
 
@@ -60,6 +61,7 @@ public:
     /// @brief Set the transition in time offset.
     void set_in_offset(RationalTime const& in_offset) noexcept
     {
+        mark_modified();
         _in_offset = in_offset;
     }
 
@@ -69,6 +71,7 @@ public:
     /// @brief Set the transition out time offset.
     void set_out_offset(RationalTime const& out_offset) noexcept
     {
+        mark_modified();
         _out_offset = out_offset;
     }
 
@@ -88,6 +91,11 @@ protected:
     bool read_from(Reader&) override;
     void write_to(Writer&) const override;
 
+    SerializableObject* _clone_instance() const override;
+    bool _clone_fields_from(SerializableObject const&, Cloner&) override;
+    bool _fields_equivalent_to(SerializableObject const&, Comparer&)
+        const override;
+
 private:
     std::string  _transition_type;
     RationalTime _in_offset, _out_offset;
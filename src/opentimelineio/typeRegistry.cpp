@@ -30,6 +30,7 @@
 #include "stringUtils.h"
 
 #include <assert.h>
+#include <set>
 #include <vector>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
@@ -91,10 +92,7 @@ TypeRegistry::TypeRegistry()
     /*
      * Upgrade functions:
      */
-    register_upgrade_function(Marker::Schema::name, 2, [](AnyDictionary* d) {
-        (*d)["marked_range"] = (*d)["range"];
-        d->erase("range");
-    });
+    register_upgrade_rename(Marker::Schema::name, 2, "range", "marked_range");
 
     register_upgrade_function(Clip::Schema::name, 2, [](AnyDictionary* d) {
         auto media_ref = (*d)["media_reference"];
@@ -233,6 +231,28 @@ TypeRegistry::register_upgrade_function(
     {
         auto result = r->upgrade_functions.insert(
             { version_to_upgrade_to, upgrade_function });
+        std::lock_guard<std::mutex> plan_lock(r->plan_mutex);
+        r->upgrade_plans.clear();
+        return result.second;
+    }
+
+    return false;
+}
+
+bool
+TypeRegistry::register_upgrade_rename(
+    std::string const& schema_name,
+    int                version_to_upgrade_to,
+    std::string const& old_key,
+    std::string const& new_key)
+{
+    std::lock_guard<std::mutex> lock(_registry_mutex);
+    if (auto r = _find_type_record(schema_name))
+    {
+        auto result = r->upgrade_renames[version_to_upgrade_to].insert(
+            { old_key, new_key });
+        std::lock_guard<std::mutex> plan_lock(r->plan_mutex);
+        r->upgrade_plans.clear();
         return result.second;
     }
 
@@ -308,13 +328,9 @@ TypeRegistry::_instance_from_schema(
     }
     else if (schema_version < type_record->schema_version)
     {
-        for (const auto& e: type_record->upgrade_functions)
+        if (auto plan = type_record->upgrade_plan(schema_version))
         {
-            if (schema_version <= e.first
-                && e.first <= type_record->schema_version)
-            {
-                e.second(&dict);
-            }
+            plan->apply(&dict);
         }
     }
 
@@ -352,6 +368,100 @@ TypeRegistry::_lookup_type_record(std::type_info const& type)
     return e != _type_records_by_type_name.end() ? e->second : nullptr;
 }
 
+std::shared_ptr<TypeRegistry::_UpgradePlan const>
+TypeRegistry::_TypeRecord::upgrade_plan(int from_version) const
+{
+    std::lock_guard<std::mutex> lock(plan_mutex);
+    auto                        e = upgrade_plans.find(from_version);
+    if (e != upgrade_plans.end())
+    {
+        return e->second;
+    }
+
+    std::set<int> versions;
+    for (auto const& u: upgrade_functions)
+    {
+        versions.insert(u.first);
+    }
+    for (auto const& u: upgrade_renames)
+    {
+        versions.insert(u.first);
+    }
+
+    auto plan = std::make_shared<_UpgradePlan>();
+    for (const int version: versions)
+    {
+        if (version < from_version || version > schema_version)
+        {
+            continue;
+        }
+
+        auto renames = upgrade_renames.find(version);
+        if (renames != upgrade_renames.end() && !renames->second.empty())
+        {
+            if (plan->steps.empty() || plan->steps.back().function)
+            {
+                plan->steps.emplace_back();
+            }
+
+            // fields renamed before are renamed on to their newest name
+            auto& merged = plan->steps.back().renames;
+            for (auto& m: merged)
+            {
+                auto again = renames->second.find(m.second);
+                if (again != renames->second.end())
+                {
+                    m.second = again->second;
+                }
+            }
+            for (auto const& r: renames->second)
+            {
+                merged.insert(r);
+            }
+        }
+
+        auto function = upgrade_functions.find(version);
+        if (function != upgrade_functions.end())
+        {
+            if (plan->steps.empty() || plan->steps.back().function)
+            {
+                plan->steps.emplace_back();
+            }
+            plan->steps.back().function = function->second;
+        }
+    }
+
+    std::shared_ptr<_UpgradePlan const> result;
+    if (!plan->steps.empty())
+    {
+        result = plan;
+    }
+    upgrade_plans[from_version] = result;
+    return result;
+}
+
+void
+TypeRegistry::_UpgradePlan::apply(AnyDictionary* dict) const
+{
+    for (auto const& step: steps)
+    {
+        for (auto const& r: step.renames)
+        {
+            auto e = dict->find(r.first);
+            if (e != dict->end())
+            {
+                std::any value = std::move(e->second);
+                dict->erase(e);
+                (*dict)[r.second] = std::move(value);
+            }
+        }
+        if (step.function)
+        {
+            step.function(dict);
+        }
+    }
+}
+
 SerializableObject*
 TypeRegistry::_TypeRecord::create_object() const
 {
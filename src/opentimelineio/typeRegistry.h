@@ -7,11 +7,14 @@
 #include "opentimelineio/version.h"
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace opentimelineio { namespace OPENTIMELINEIO_VERSION {
 
@@ -117,6 +120,22 @@ public:
             upgrade_function);
     }
 
+    /// @brief Register an upgrade to version_to_upgrade_to that renames a
+    /// field from old_key to new_key.
+    ///
+    /// Renames are applied before the upgrade function registered for the
+    /// same version, if any.  Unlike upgrade functions, they can be merged
+    /// into a single lookup table across versions, and applied by the JSON
+    /// reader to keys as it reads them.
+    ///
+    /// Returns false if schema_name has not been registered, or if old_key
+    /// is already renamed by this version.
+    bool register_upgrade_rename(
+        std::string const& schema_name,
+        int                version_to_upgrade_to,
+        std::string const& old_key,
+        std::string const& new_key);
+
     /// @brief Downgrade function from version_to_downgrade_from to
     /// version_to_downgrade_from - 1
     bool register_downgrade_function(
@@ -168,6 +187,34 @@ private:
     TypeRegistry(TypeRegistry const&)            = delete;
     TypeRegistry& operator=(TypeRegistry const&) = delete;
 
+    // The upgrades of a schema from an older version, as a list of steps:
+    // each renames fields (merging the renames of consecutive versions),
+    // then runs an upgrade function.
+    struct _UpgradePlan
+    {
+        using Renames = std::unordered_map<std::string, std::string>;
+
+        struct Step
+        {
+            Renames                             renames;
+            std::function<void(AnyDictionary*)> function;
+        };
+
+        std::vector<Step> steps;
+
+        // The renames the plan starts with, which a reader may apply to keys
+        // as it reads them (applying the plan afterwards is then harmless),
+        // or null.
+        Renames const* leading_renames() const
+        {
+            return !steps.empty() && !steps.front().renames.empty()
+                       ? &steps.front().renames
+                       : nullptr;
+        }
+
+        void apply(AnyDictionary* dict) const;
+    };
+
     class _TypeRecord
     {
         std::string                          schema_name;
@@ -178,6 +225,23 @@ private:
         std::map<int, std::function<void(AnyDictionary*)>> upgrade_functions;
         std::map<int, std::function<void(AnyDictionary*)>> downgrade_functions;
 
+        // fields renamed by upgrades, by the version upgraded to
+        std::map<int, std::map<std::string, std::string>> upgrade_renames;
+
+        // compiled upgrade plans, by the version upgraded from
+        mutable std::mutex plan_mutex;
+        mutable std::map<int, std::shared_ptr<_UpgradePlan const>>
+            upgrade_plans;
+
+        // Return the plan upgrading objects of the given version, or null
+        // if there is nothing to upgrade.
+        std::shared_ptr<_UpgradePlan const>
+        upgrade_plan(int from_version) const;
+
+        // whether objects of this type have native fields (see
+        // SerializableObject::_has_native_fields()); -1 until checked
+        mutable std::atomic<int> native_fields{ -1 };
+
         _TypeRecord(
             std::string                          _schema_name,
             int                                  _schema_version,
@@ -195,6 +259,7 @@ private:
         friend class TypeRegistry;
         friend class SerializableObject;
         friend class CloningEncoder;
+        friend class JSONDecoder;
     };
 
     // helper functions for lookup
@@ -222,6 +287,7 @@ private:
 
     friend class SerializableObject;
     friend class CloningEncoder;
+    friend class JSONDecoder;
 };
 
 }} // namespace opentimelineio::OPENTIMELINEIO_VERSION
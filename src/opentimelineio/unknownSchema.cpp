@@ -20,6 +20,10 @@ UnknownSchema::read_from(Reader& reader)
 {
     _data.swap(reader._dict);
     _data.erase("OTIO_SCHEMA");
+    if (_holds_objects(_data))
+    {
+        _expose_dictionary();
+    }
     return true;
 }
 
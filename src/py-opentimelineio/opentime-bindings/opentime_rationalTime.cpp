@@ -2,6 +2,7 @@
 // Copyright Contributors to the OpenTimelineIO project
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/stl.h>
 
@@ -38,6 +39,22 @@ IsDropFrameRate df_enum_converter(std::optional<bool>& df) {
         return IsDropFrameRate::ForceNo;
     }
 }
+
+// The strings are formatted on the stack, and the Python strings are
+// created directly from the buffers.
+py::str to_timecode_str(RationalTime rt, double rate, IsDropFrameRate drop_frame) {
+    char buffer[RationalTime::timecode_length];
+    size_t const length = rt.to_timecode(
+            rate, drop_frame, buffer, sizeof(buffer), ErrorStatusConverter());
+    return py::str(buffer, length);
+}
+
+py::str to_nearest_timecode_str(RationalTime rt, double rate, IsDropFrameRate drop_frame) {
+    char buffer[RationalTime::timecode_length];
+    size_t const length = rt.to_nearest_timecode(
+            rate, drop_frame, buffer, sizeof(buffer), ErrorStatusConverter());
+    return py::str(buffer, length);
+}
 }
 
 std::string opentime_python_str(RationalTime rt) {
@@ -124,46 +141,78 @@ For example, the duration of a clip from frame 10 to frame 15 is 6 frames. Resul
             "Returns the frame number based on the given rate.")
         .def("to_seconds", &RationalTime::to_seconds)
         .def("to_timecode", [](RationalTime rt, double rate, std::optional<bool> drop_frame) {
-                return rt.to_timecode(
-                        rate,
-                        df_enum_converter(drop_frame),
-                        ErrorStatusConverter()
-                );
+                return to_timecode_str(rt, rate, df_enum_converter(drop_frame));
         }, "rate"_a, "drop_frame"_a, "Convert to timecode (``HH:MM:SS;FRAME``)")
         .def("to_timecode", [](RationalTime rt, double rate) {
-                return rt.to_timecode(
-                        rate,
-                        IsDropFrameRate::InferFromRate,
-                        ErrorStatusConverter()
-                );
+                return to_timecode_str(rt, rate, IsDropFrameRate::InferFromRate);
         }, "rate"_a)
         .def("to_timecode", [](RationalTime rt) {
-                return rt.to_timecode(
-                        rt.rate(),
-                        IsDropFrameRate::InferFromRate,
-                        ErrorStatusConverter());
+                return to_timecode_str(rt, rt.rate(), IsDropFrameRate::InferFromRate);
                 })
         .def("to_nearest_timecode", [](RationalTime rt, double rate, std::optional<bool> drop_frame) {
-                return rt.to_nearest_timecode(
+                return to_nearest_timecode_str(rt, rate, df_enum_converter(drop_frame));
+        }, "rate"_a, "drop_frame"_a, "Convert to nearest timecode (``HH:MM:SS;FRAME``)")
+        .def("to_nearest_timecode", [](RationalTime rt, double rate) {
+                return to_nearest_timecode_str(rt, rate, IsDropFrameRate::InferFromRate);
+        }, "rate"_a)
+        .def("to_nearest_timecode", [](RationalTime rt) {
+                return to_nearest_timecode_str(rt, rt.rate(), IsDropFrameRate::InferFromRate);
+                })
+        .def_static("to_timecodes", [](py::array_t<double, py::array::c_style | py::array::forcecast> frames,
+                                       double rate, std::optional<bool> drop_frame) {
+                size_t const count = size_t(frames.size());
+                std::string timecodes(count * RationalTime::timecode_length, ' ');
+                RationalTime::to_timecodes(
+                        frames.data(),
+                        count,
                         rate,
                         df_enum_converter(drop_frame),
+                        &timecodes[0],
                         ErrorStatusConverter()
                 );
-        }, "rate"_a, "drop_frame"_a, "Convert to nearest timecode (``HH:MM:SS;FRAME``)")
-        .def("to_nearest_timecode", [](RationalTime rt, double rate) {
-                return rt.to_nearest_timecode(
+
+                // a NumPy array of fixed width unicode strings
+                py::array result(
+                        py::dtype::from_args(py::str("U" + std::to_string(RationalTime::timecode_length))),
+                        std::vector<py::ssize_t>{ py::ssize_t(count) });
+                auto characters = static_cast<uint32_t*>(result.mutable_data());
+                for (size_t i = 0; i < timecodes.size(); ++i) {
+                    characters[i] = static_cast<unsigned char>(timecodes[i]);
+                }
+                return result;
+            }, "frames"_a, "rate"_a, "drop_frame"_a = py::none(), R"docstring(
+Convert an array of frame numbers at the given rate into a NumPy array of timecodes (``HH:MM:SS;FRAME``).
+
+The rate and drop frame constants are resolved once for all the frames.
+)docstring")
+        .def("to_time_string", [](RationalTime rt) {
+                char buffer[RationalTime::max_time_string_length];
+                size_t const length = rt.to_time_string(buffer, sizeof(buffer));
+                return py::str(buffer, length);
+                })
+        .def_static("from_timecodes", [](py::iterable timecodes, double rate) {
+                std::string buffer;
+                for (auto timecode: timecodes) {
+                    auto const s = timecode.cast<std::string>();
+                    if (s.size() != RationalTime::timecode_length) {
+                        throw py::value_error(string_printf("Input timecode '%s' is an invalid timecode", s.c_str()));
+                    }
+                    buffer += s;
+                }
+
+                size_t const count = buffer.size() / RationalTime::timecode_length;
+                py::array_t<double> frames(count);
+                RationalTime::from_timecodes(
+                        buffer.data(),
+                        count,
                         rate,
-                        IsDropFrameRate::InferFromRate,
+                        frames.mutable_data(),
                         ErrorStatusConverter()
                 );
-        }, "rate"_a)
-        .def("to_nearest_timecode", [](RationalTime rt) {
-                return rt.to_nearest_timecode(
-                        rt.rate(),
-                        IsDropFrameRate::InferFromRate,
-                        ErrorStatusConverter());
-                })
-        .def("to_time_string", &RationalTime::to_time_string)
+                return frames;
+            }, "timecodes"_a, "rate"_a, R"docstring(
+Convert timecode strings (``HH:MM:SS;FRAME``) into a NumPy array of frame numbers at the given rate.
+)docstring")
         .def_static("from_timecode", [](std::string s, double rate) {
                 return RationalTime::from_timecode(s, rate, ErrorStatusConverter());
             }, "timecode"_a, "rate"_a, "Convert a timecode string (``HH:MM:SS;FRAME``) into a :class:`~RationalTime`.")
@@ -207,20 +207,24 @@ PYBIND11_MODULE(_otio, m) {
               PyAny* pyAny,
               std::string filename,
               const schema_version_map& schema_version_targets,
-              int indent
+              int indent,
+              bool sync
           ) {
               return serialize_json_to_file(
                       pyAny->a,
                       filename,
                       &schema_version_targets,
                       ErrorStatusHandler(),
-                      indent
+                      indent,
+                      1,
+                      sync
               );
           },
           "value"_a,
           "filename"_a,
           "schema_version_targets"_a,
-          "indent"_a)
+          "indent"_a,
+          "sync"_a = false)
      .def("deserialize_json_from_string",
           [](std::string input) {
               std::any result;
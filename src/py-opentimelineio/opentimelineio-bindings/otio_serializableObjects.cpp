@@ -161,16 +161,21 @@ static void define_bases1(py::module m) {
         .def_property_readonly("_dynamic_fields", [](SerializableObject* s) {
                 auto ptr = s->dynamic_fields().get_or_create_mutation_stamp();
                 return (AnyDictionaryProxy*)(ptr); }, py::return_value_policy::take_ownership)
-        .def("is_equivalent_to", &SerializableObject::is_equivalent_to, "other"_a.none(false))
+        .def("is_equivalent_to", [](SerializableObject* so, SerializableObject* other) {
+                return so->is_equivalent_to(*other); }, "other"_a.none(false))
+        .def("content_hash", [](SerializableObject* so) {
+                return so->content_hash(ErrorStatusHandler()).to_string(); },
+            "Return a 32-digit hexadecimal hash of the object's serialized content.")
         .def("clone", [](SerializableObject* so) {
                 return so->clone(ErrorStatusHandler()); })
         .def("to_json_string", [](SerializableObject* so, int indent) {
                 return so->to_json_string(ErrorStatusHandler(), {}, indent); },
             "indent"_a = 4)
-        .def("to_json_file", [](SerializableObject* so, std::string file_name, int indent) {
-                return so->to_json_file(file_name, ErrorStatusHandler(), {}, indent); },
+        .def("to_json_file", [](SerializableObject* so, std::string file_name, int indent, bool sync) {
+                return so->to_json_file(file_name, ErrorStatusHandler(), {}, indent, 1, sync); },
             "file_name"_a,
-            "indent"_a = 4)
+            "indent"_a = 4,
+            "sync"_a = false)
         .def_static("from_json_file", [](std::string file_name) {
                 return SerializableObject::from_json_file(file_name, ErrorStatusHandler()); },
             "file_name"_a)
@@ -369,6 +374,8 @@ An object that can be composed within a :class:`~Composition` (such as :class:`~
         .def("trimmed_range", [](Item* item) {
             return item->trimmed_range(ErrorStatusHandler());
         })
+        // the proxies modify the vectors without telling the item, which
+        // markers() and effects() allow for by exposing it
         .def_property_readonly("markers", [](Item* item) {
             return ((MarkerVectorProxy*) &item->markers());
             })
@@ -103,7 +103,8 @@ def serialize_json_to_file(
         root,
         filename,
         schema_version_targets=None,
-        indent=4
+        indent=4,
+        sync=False
 ):
     """Serialize root to a json file.  Optionally downgrade resulting schemas
     to schema_version_targets.
@@ -117,6 +118,8 @@ def serialize_json_to_file(
                                                   OpenTimelineIO.
     :param int indent: number of spaces for each json indentation level. Use -1
                        for no indentation or newlines.
+    :param bool sync: whether to flush the file to disk before closing it, so
+                      that it only succeeds once the data is durable.
 
     :returns: true for success, false for failure
     :rtype: bool
@@ -125,7 +128,8 @@ def serialize_json_to_file(
         _value_to_any(root),
         filename,
         schema_version_targets or {},
-        indent
+        indent,
+        sync
     )
 
 
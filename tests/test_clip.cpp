@@ -313,6 +313,52 @@ main(int argc, char** argv)
         );
     });
 
+    tests.add_test("test_clip_v2_to_v1", [] {
+        using namespace otio;
+
+        SerializableObject::Retainer<Clip> clip(new Clip("downgraded"));
+        Clip::MediaReferences mrs;
+        mrs["proxy"] = new ExternalReference("file:///proxy.mov");
+        mrs["high"]  = new ExternalReference("file:///high.mov");
+        clip->set_media_references(mrs, "high");
+        clip->metadata()["take"] = int64_t(3);
+
+        schema_version_map downgrade_manifest = { { "Clip", 1 } };
+        otio::ErrorStatus  status;
+        const auto         json =
+            clip->to_json_string(&status, &downgrade_manifest);
+        assertFalse(is_error(status));
+        assertTrue(json.find("\"Clip.1\"") != std::string::npos);
+        assertTrue(json.find("media_references") == std::string::npos);
+
+        // reading it back upgrades the active reference to the default one
+        SerializableObject::Retainer<> so =
+            SerializableObject::from_json_string(json, &status);
+        assertFalse(is_error(status));
+        auto upgraded = dynamic_cast<Clip*>(so.value);
+        assertNotNull(upgraded);
+        assertEqual(upgraded->name(), std::string("downgraded"));
+        assertEqual(
+            std::any_cast<int64_t>(upgraded->metadata()["take"]),
+            int64_t(3));
+        auto media_ref =
+            dynamic_cast<ExternalReference*>(upgraded->media_reference());
+        assertNotNull(media_ref);
+        assertEqual(media_ref->target_url(), std::string("file:///high.mov"));
+        assertEqual(upgraded->media_references().size(), size_t(1));
+
+        // a clip without an active reference reads back as missing media
+        Clip::MediaReferences empty_mrs;
+        empty_mrs["empty"] = nullptr;
+        clip->set_media_references(empty_mrs, "empty");
+        so = SerializableObject::from_json_string(
+            clip->to_json_string(&status, &downgrade_manifest),
+            &status);
+        assertFalse(is_error(status));
+        assertNotNull(dynamic_cast<MissingReference*>(
+            dynamic_cast<Clip*>(so.value)->media_reference()));
+    });
+
     tests.run(argc, argv);
     return 0;
 }
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "utils.h"
+
+#include <opentimelineio/algo/diffAlgorithm.h>
+#include <opentimelineio/clip.h>
+#include <opentimelineio/externalReference.h>
+#include <opentimelineio/gap.h>
+#include <opentimelineio/stack.h>
+#include <opentimelineio/timeline.h>
+#include <opentimelineio/track.h>
+
+#include <string>
+#include <vector>
+
+namespace otime = opentime::OPENTIME_VERSION;
+namespace otio  = opentimelineio::OPENTIMELINEIO_VERSION;
+
+using otime::RationalTime;
+using otime::TimeRange;
+using otio::algo::EditOperation;
+
+namespace {
+
+otio::Clip*
+make_clip(std::string const& name, double start, double duration)
+{
+    return new otio::Clip(
+        name,
+        new otio::ExternalReference("file:///" + name + ".mov"),
+        TimeRange(RationalTime(start, 24), RationalTime(duration, 24)));
+}
+
+std::vector<EditOperation::Kind>
+kinds_of(std::vector<EditOperation> const& script)
+{
+    std::vector<EditOperation::Kind> kinds;
+    for (auto const& op: script)
+    {
+        kinds.push_back(op.kind);
+    }
+    return kinds;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Tests tests;
+
+    tests.add_test("test_diff_identical", [] {
+        otio::SerializableObject::Retainer<otio::Track> before =
+            new otio::Track();
+        for (auto name: { "A", "B", "C" })
+        {
+            before->append_child(make_clip(name, 0, 24));
+        }
+        otio::SerializableObject::Retainer<otio::Track> after(
+            dynamic_cast<otio::Track*>(before->clone()));
+
+        otio::ErrorStatus err;
+        auto script = otio::algo::diff_children(before, after, &err);
+        assertFalse(otio::is_error(err));
+        assertTrue(script.empty());
+    });
+
+    tests.add_test("test_diff_track", [] {
+        otio::SerializableObject::Retainer<otio::Track> before =
+            new otio::Track();
+        before->append_child(make_clip("A", 0, 24));
+        before->append_child(make_clip("B", 0, 24));
+        before->append_child(make_clip("C", 0, 24));
+        before->append_child(new otio::Gap(RationalTime(12, 24)));
+        before->append_child(make_clip("D", 0, 24));
+        before->append_child(make_clip("E", 0, 24));
+
+        // B is removed, X inserted, C trimmed, E moved to the front
+        otio::SerializableObject::Retainer<otio::Track> after =
+            new otio::Track();
+        after->append_child(make_clip("E", 0, 24));
+        after->append_child(make_clip("A", 0, 24));
+        after->append_child(make_clip("C", 6, 12));
+        after->append_child(new otio::Gap(RationalTime(12, 24)));
+        after->append_child(make_clip("X", 0, 48));
+        after->append_child(make_clip("D", 0, 24));
+
+        otio::ErrorStatus err;
+        auto script = otio::algo::diff_children(before, after, &err);
+        assertFalse(otio::is_error(err));
+        assertTrue(
+            kinds_of(script)
+            == std::vector<EditOperation::Kind>(
+                { EditOperation::Kind::move,
+                  EditOperation::Kind::remove,
+                  EditOperation::Kind::trim,
+                  EditOperation::Kind::insert }));
+
+        // E moves from the end to the front
+        assertEqual(script[0].index, 5);
+        assertEqual(script[0].time, RationalTime(108, 24));
+        assertEqual(script[0].new_index, 0);
+        assertEqual(script[0].new_time, RationalTime(0, 24));
+
+        // B follows E and A
+        assertEqual(script[1].index, 2);
+        assertEqual(script[1].time, RationalTime(48, 24));
+        assertEqual(script[1].child->name(), std::string("B"));
+
+        assertEqual(script[2].index, 2);
+        assertEqual(script[2].delta_in, RationalTime(6, 24));
+        assertEqual(script[2].delta_out, RationalTime(-6, 24));
+
+        // X goes after the (shortened) C and the gap
+        assertEqual(script[3].index, 4);
+        assertEqual(script[3].time, RationalTime(72, 24));
+
+        assertTrue(otio::algo::apply_edit_script(before, script, &err));
+        assertFalse(otio::is_error(err));
+        assertTrue(before->is_equivalent_to(*after));
+    });
+
+    tests.add_test("test_diff_replaced_child", [] {
+        otio::SerializableObject::Retainer<otio::Track> before =
+            new otio::Track();
+        before->append_child(make_clip("A", 0, 24));
+        before->append_child(make_clip("B", 0, 24));
+        otio::SerializableObject::Retainer<otio::Track> after(
+            dynamic_cast<otio::Track*>(before->clone()));
+        dynamic_cast<otio::Clip*>(after->children()[1].value)
+            ->metadata()["take"] = int64_t(2);
+
+        otio::ErrorStatus err;
+        auto script = otio::algo::diff_children(before, after, &err);
+        assertTrue(
+            kinds_of(script)
+            == std::vector<EditOperation::Kind>(
+                { EditOperation::Kind::remove,
+                  EditOperation::Kind::insert }));
+        assertTrue(otio::algo::apply_edit_script(before, script, &err));
+        assertTrue(before->is_equivalent_to(*after));
+    });
+
+    tests.add_test("test_diff_timelines", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> before =
+            new otio::Timeline();
+        otio::SerializableObject::Retainer<otio::Track> video =
+            new otio::Track("video");
+        for (int i = 0; i < 100; ++i)
+        {
+            video->append_child(make_clip("clip" + std::to_string(i), 0, 24));
+        }
+        before->tracks()->append_child(video);
+        before->tracks()->append_child(new otio::Track("audio"));
+
+        otio::SerializableObject::Retainer<otio::Timeline> after(
+            dynamic_cast<otio::Timeline*>(before->clone()));
+        auto after_video =
+            dynamic_cast<otio::Track*>(after->tracks()->children()[0].value);
+        after_video->remove_child(50);
+        after_video->insert_child(10, make_clip("new", 0, 12));
+        dynamic_cast<otio::Item*>(after_video->children()[90].value)
+            ->set_source_range(
+                TimeRange(RationalTime(0, 24), RationalTime(30, 24)));
+        after->tracks()->remove_child(1);
+
+        otio::ErrorStatus err;
+        auto script = otio::algo::diff_timelines(before, after, &err);
+        assertFalse(otio::is_error(err));
+        assertEqual(script.size(), size_t(4));
+        assertEqual(script.back().track_index, -1);
+
+        assertTrue(otio::algo::apply_edit_script(before, script, &err));
+        assertFalse(otio::is_error(err));
+        assertTrue(before->is_equivalent_to(*after));
+    });
+
+    tests.run(argc, argv);
+    return 0;
+}
@@ -3,9 +3,15 @@
 
 #include "utils.h"
 
+#include <opentime/exactTime.h>
 #include <opentime/rationalTime.h>
+#include <opentime/timeArrays.h>
 #include <opentime/timeRange.h>
 
+#include <limits>
+#include <string>
+#include <vector>
+
 namespace otime = opentime::OPENTIME_VERSION;
 
 int
@@ -139,6 +145,309 @@ main(int argc, char** argv)
         assertTrue(t.almost_equal(time_obj, 0.001));
     });
 
+    tests.add_test("test_timecodes", [] {
+        std::vector<double> frames;
+        for (int i = 0; i < 5000; ++i)
+        {
+            frames.push_back(i * 17.0);
+        }
+        frames.push_back(24 * 60 * 60 * 30 + 1.5);
+
+        for (double rate: { 24.0, 23.976, 25.0, 29.97, 60000 / 1001.0 })
+        {
+            for (auto drop_frame: { otime::IsDropFrameRate::InferFromRate,
+                                    otime::IsDropFrameRate::ForceNo })
+            {
+                std::string       timecodes(
+                    frames.size() * otime::RationalTime::timecode_length,
+                    ' ');
+                otime::ErrorStatus err;
+                assertTrue(otime::RationalTime::to_timecodes(
+                    frames.data(),
+                    frames.size(),
+                    rate,
+                    drop_frame,
+                    &timecodes[0],
+                    &err));
+                assertFalse(otime::is_error(err));
+
+                for (size_t i = 0; i < frames.size(); ++i)
+                {
+                    assertEqual(
+                        timecodes.substr(
+                            i * otime::RationalTime::timecode_length,
+                            otime::RationalTime::timecode_length),
+                        otime::RationalTime(frames[i], rate)
+                            .to_timecode(rate, drop_frame));
+                }
+
+                // timecodes only parse at exact SMPTE rates
+                if (!otime::RationalTime::is_smpte_timecode_rate(rate))
+                {
+                    continue;
+                }
+                std::vector<double> parsed(frames.size());
+                assertTrue(otime::RationalTime::from_timecodes(
+                    timecodes.data(),
+                    frames.size(),
+                    rate,
+                    parsed.data(),
+                    &err));
+                for (size_t i = 0; i < frames.size(); ++i)
+                {
+                    assertEqual(
+                        parsed[i],
+                        otime::RationalTime::from_timecode(
+                            timecodes.substr(
+                                i * otime::RationalTime::timecode_length,
+                                otime::RationalTime::timecode_length),
+                            rate)
+                            .value());
+                }
+            }
+        }
+
+        char               timecodes[2 * otime::RationalTime::timecode_length];
+        double             invalid[] = { 0, -1 };
+        otime::ErrorStatus err;
+        assertFalse(otime::RationalTime::to_timecodes(
+            invalid,
+            2,
+            24,
+            otime::IsDropFrameRate::InferFromRate,
+            timecodes,
+            &err));
+        assertEqual(err.outcome, otime::ErrorStatus::NEGATIVE_VALUE);
+        for (double frame: { std::numeric_limits<double>::infinity(),
+                             std::numeric_limits<double>::quiet_NaN() })
+        {
+            invalid[1] = frame;
+            assertFalse(otime::RationalTime::to_timecodes(
+                invalid,
+                2,
+                24,
+                otime::IsDropFrameRate::InferFromRate,
+                timecodes,
+                &err));
+            assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_RATE);
+        }
+
+        double parsed[2];
+        assertFalse(otime::RationalTime::from_timecodes(
+            "00:00:01:0000:00:01;00",
+            2,
+            24,
+            parsed,
+            &err));
+        assertEqual(
+            err.outcome,
+            otime::ErrorStatus::INVALID_RATE_FOR_DROP_FRAME_TIMECODE);
+        assertFalse(otime::RationalTime::from_timecodes(
+            "00:00:0x:00",
+            1,
+            24,
+            parsed,
+            &err));
+        assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_STRING);
+    });
+
+    tests.add_test("test_timecode_formatter", [] {
+        for (double rate: { 24.0, 23.976, 25.0, 29.97, 47.952, 59.94, 23.5 })
+        {
+            for (auto drop_frame: { otime::IsDropFrameRate::InferFromRate,
+                                    otime::IsDropFrameRate::ForceNo,
+                                    otime::IsDropFrameRate::ForceYes })
+            {
+                otime::ErrorStatus            err;
+                const otime::TimecodeFormatter formatter(rate, drop_frame, &err);
+                otime::ErrorStatus            expected_err;
+                otime::RationalTime(0, rate).to_timecode(
+                    rate,
+                    drop_frame,
+                    &expected_err);
+                assertEqual(err.outcome, expected_err.outcome);
+                assertEqual(formatter.is_valid(), !otime::is_error(err));
+                if (!formatter.is_valid())
+                {
+                    continue;
+                }
+
+                for (double frame: { 0.0, 1799.0, 1800.0, 17982.0, 1e7 })
+                {
+                    const otime::RationalTime time(frame, rate);
+                    assertEqual(
+                        formatter.to_timecode(time),
+                        time.to_timecode(rate, drop_frame));
+                }
+            }
+        }
+
+        const otime::TimecodeFormatter formatter(29.97);
+        assertTrue(formatter.is_valid());
+        assertTrue(formatter.is_drop_frame());
+        assertFalse(
+            otime::TimecodeFormatter(29.97, otime::IsDropFrameRate::ForceNo)
+                .is_drop_frame());
+        char timecode[otime::RationalTime::timecode_length];
+        assertTrue(formatter.to_timecode(1800, timecode));
+        assertEqual(
+            std::string(timecode, sizeof(timecode)),
+            std::string("00:01:00;02"));
+
+        otime::ErrorStatus err;
+        assertFalse(formatter.to_timecode(-1, timecode, &err));
+        assertEqual(err.outcome, otime::ErrorStatus::NEGATIVE_VALUE);
+        for (double frame: { std::numeric_limits<double>::infinity(),
+                             -std::numeric_limits<double>::infinity(),
+                             std::numeric_limits<double>::quiet_NaN() })
+        {
+            assertFalse(formatter.to_timecode(frame, timecode, &err));
+            assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_RATE);
+        }
+        assertFalse(otime::TimecodeFormatter(100, otime::InferFromRate, &err)
+                        .is_valid());
+        assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_RATE);
+        assertFalse(otime::TimecodeFormatter(24, otime::ForceYes, &err)
+                        .is_valid());
+        assertEqual(
+            err.outcome,
+            otime::ErrorStatus::INVALID_RATE_FOR_DROP_FRAME_TIMECODE);
+
+        // the nearest rate is always a SMPTE timecode rate
+        assertEqual(
+            otime::RationalTime::nearest_smpte_timecode_rate(5),
+            24000.0 / 1001.0);
+        assertEqual(
+            otime::RationalTime::nearest_smpte_timecode_rate(42),
+            48000.0 / 1001.0);
+        assertEqual(otime::RationalTime::nearest_smpte_timecode_rate(61), 60.0);
+        assertFalse(otime::RationalTime::is_smpte_timecode_rate(0));
+    });
+
+    tests.add_test("test_time_string_buffers", [] {
+        std::string timecode = "reused";
+        std::string time_string;
+        for (double value: { 0.0, 1.5, 1800.0, 86399.25, -3.0 })
+        {
+            const otime::RationalTime time(value, 29.97);
+
+            char   buffer[otime::RationalTime::timecode_length];
+            size_t length = time.to_timecode(
+                29.97,
+                otime::InferFromRate,
+                buffer,
+                sizeof(buffer));
+            assertEqual(std::string(buffer, length), time.to_timecode());
+            assertEqual(
+                time.to_timecode(29.97, otime::InferFromRate, timecode),
+                length);
+            assertEqual(timecode, time.to_timecode());
+
+            length = time.to_nearest_timecode(
+                30,
+                otime::InferFromRate,
+                buffer,
+                sizeof(buffer));
+            assertEqual(
+                std::string(buffer, length),
+                time.to_nearest_timecode(30, otime::InferFromRate));
+
+            char time_buffer[otime::RationalTime::max_time_string_length];
+            length = time.to_time_string(time_buffer, sizeof(time_buffer));
+            assertEqual(
+                std::string(time_buffer, length),
+                time.to_time_string());
+            assertEqual(time.to_time_string(time_string), length);
+            assertEqual(time_string, time.to_time_string());
+        }
+
+        // the length is returned, but nothing is written, if the buffer is
+        // too small
+        char buffer[4] = { 'a', 'b', 'c', 'd' };
+        assertEqual(
+            otime::RationalTime(1, 24).to_timecode(
+                24,
+                otime::InferFromRate,
+                buffer,
+                sizeof(buffer)),
+            otime::RationalTime::timecode_length);
+        assertEqual(
+            otime::RationalTime(24, 24).to_time_string(buffer, sizeof(buffer)),
+            size_t(10));
+        assertEqual(std::string(buffer, sizeof(buffer)), std::string("abcd"));
+
+        otime::ErrorStatus err;
+        assertEqual(
+            otime::RationalTime(-1, 24).to_timecode(
+                24,
+                otime::InferFromRate,
+                timecode,
+                &err),
+            size_t(0));
+        assertEqual(err.outcome, otime::ErrorStatus::NEGATIVE_VALUE);
+        assertTrue(timecode.empty());
+
+        // times that aren't a finite number of frames, including any time
+        // with a rate of zero
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (const auto& time:
+             { otime::RationalTime(inf, 24),
+               otime::RationalTime(nan, 24),
+               otime::RationalTime(5, 0) })
+        {
+            assertEqual(
+                time.to_timecode(24, otime::InferFromRate, timecode, &err),
+                size_t(0));
+            assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_RATE);
+            assertEqual(
+                time.to_timecode(24, otime::InferFromRate, &err),
+                std::string());
+            assertEqual(err.outcome, otime::ErrorStatus::INVALID_TIMECODE_RATE);
+        }
+    });
+
+    tests.add_test("test_exact_time", [] {
+        assertEqual(otime::ExactTime::ticks_per_sample(24), int64_t(29400000));
+        assertEqual(
+            otime::ExactTime::ticks_per_sample(30000 / 1001.0),
+            int64_t(23543520));
+        assertEqual(
+            otime::ExactTime::ticks_per_sample(48000),
+            int64_t(14700));
+        assertEqual(otime::ExactTime::ticks_per_sample(23.976), int64_t(0));
+        assertEqual(otime::ExactTime::ticks_per_sample(0), int64_t(0));
+
+        // lossless round trips
+        for (double rate: { 24.0, 25.0, 24000 / 1001.0, 60000 / 1001.0 })
+        {
+            for (double value: { 0.0, 1.0, -7.0, 0.5, 86400.0 * 60 })
+            {
+                otime::RationalTime t(value, rate);
+                auto exact = otime::ExactTime::from_rational_time(t);
+                assertTrue(bool(exact));
+                assertTrue(exact->to_rational_time(rate).strictly_equal(t));
+            }
+        }
+        assertFalse(bool(otime::ExactTime::from_rational_time(
+            otime::RationalTime(1, 23.976))));
+        assertFalse(bool(otime::ExactTime::from_rational_time(
+            otime::RationalTime(1e-9, 24))));
+
+        // one frame at 24 and one at 30000/1001 are 1.8008 frames at 24,
+        // and 2251/1001 frames at 30000/1001
+        auto sum = *otime::ExactTime::from_rational_time(
+                       otime::RationalTime(1, 24))
+                   + *otime::ExactTime::from_rational_time(
+                       otime::RationalTime(1, 30000 / 1001.0));
+        assertTrue(sum.to_rational_time(24).strictly_equal(
+            otime::RationalTime(1.8008, 24)));
+        assertTrue(sum.to_rational_time(30000 / 1001.0).strictly_equal(
+            otime::RationalTime(2251 / 1001.0, 30000 / 1001.0)));
+        assertTrue(sum > otime::ExactTime(0));
+        assertEqual(sum.to_seconds(), 1 / 24.0 + 1001 / 30000.0);
+    });
+
     tests.add_test("test_create_range", [] {
         otime::RationalTime start(0.0, 24.0);
         otime::RationalTime duration(24.0, 24.0);
@@ -167,6 +476,88 @@ main(int argc, char** argv)
         assertTrue(r3.is_invalid_range());
     });
 
+    tests.add_test("test_time_arrays", [] {
+        const double rates[] = { 24, 25, 30000.0 / 1001.0, 48000, 1 };
+        std::vector<otime::RationalTime> times;
+        std::vector<otime::TimeRange>    ranges;
+        for (int i = 0; i < 200; ++i)
+        {
+            const double rate          = rates[i % 5];
+            const double duration_rate = rates[(i / 5) % 5];
+            times.emplace_back((i - 50) * 3.25, rate);
+            ranges.emplace_back(
+                otime::RationalTime((i - 100) * 7.5, rate),
+                otime::RationalTime((i % 17) * 11.0, duration_rate));
+        }
+        const auto same = [](otime::RationalTime a, otime::RationalTime b) {
+            return a.strictly_equal(b);
+        };
+
+        const otime::RationalTimeArray time_array(times);
+        assertEqual(time_array.size(), times.size());
+        const auto rescaled = time_array.rescaled_to(30000.0 / 1001.0);
+        for (size_t i = 0; i < times.size(); ++i)
+        {
+            assertTrue(same(time_array[i], times[i]));
+            assertTrue(
+                same(rescaled[i], times[i].rescaled_to(30000.0 / 1001.0)));
+        }
+
+        const otime::TimeTransform transforms[] = {
+            otime::TimeTransform(otime::RationalTime(10, 24), 2.0),
+            otime::TimeTransform(otime::RationalTime(-3, 48000), 0.5, 25),
+        };
+        const otime::TimeRangeArray range_array(ranges);
+        for (const auto& transform: transforms)
+        {
+            const auto transformed_times  = time_array.transformed_by(transform);
+            const auto transformed_ranges = range_array.transformed_by(transform);
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                const auto time  = transform.applied_to(times[i]);
+                const auto range = transform.applied_to(ranges[i]);
+                assertTrue(transformed_times[i].almost_equal(time, 1e-9));
+                assertEqual(transformed_times[i].rate(), time.rate());
+                assertEqual(transformed_ranges[i], range);
+            }
+        }
+
+        const otime::RationalTime time(123, 24);
+        const otime::TimeRange    other(
+            otime::RationalTime(-200, 25),
+            otime::RationalTime(9000, 48000));
+        const auto contains_time  = range_array.contains(time);
+        const auto contains_range = range_array.contains(other);
+        const auto intersects     = range_array.intersects(other);
+        const auto clamped        = range_array.clamped_to(other);
+        const auto extended       = range_array.extended_by(other);
+        size_t     contained = 0, intersected = 0;
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            const auto range = ranges[i];
+            assertTrue(same(range_array[i].start_time(), range.start_time()));
+            assertTrue(same(range_array[i].duration(), range.duration()));
+            assertEqual(bool(contains_time[i]), range.contains(time));
+            assertEqual(bool(contains_range[i]), range.contains(other));
+            assertEqual(bool(intersects[i]), range.intersects(other));
+            assertTrue(same(
+                clamped[i].start_time(),
+                other.clamped(range).start_time()));
+            assertTrue(
+                same(clamped[i].duration(), other.clamped(range).duration()));
+            assertTrue(same(
+                extended[i].start_time(),
+                range.extended_by(other).start_time()));
+            assertTrue(same(
+                extended[i].duration(),
+                range.extended_by(other).duration()));
+            contained += contains_time[i];
+            intersected += intersects[i];
+        }
+        assertTrue(contained > 0 && contained < ranges.size());
+        assertTrue(intersected > 0 && intersected < ranges.size());
+    });
+
     tests.run(argc, argv);
     return 0;
 }
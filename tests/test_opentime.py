@@ -7,6 +7,7 @@ import opentimelineio as otio
 
 import unittest
 import copy
+import importlib.util
 
 
 class TestTime(unittest.TestCase):
@@ -239,6 +240,39 @@ class TestTime(unittest.TestCase):
         with self.assertRaises(ValueError):
             otio.opentime.to_timecode(t, 25)
 
+    @unittest.skipIf(
+        importlib.util.find_spec("numpy") is None,
+        "batch timecode conversions return NumPy arrays"
+    )
+    def test_batch_timecodes(self):
+        frames = [0, 1, 30 * 59 + 30, 107892]
+        for rate in (24, 25, 29.97):
+            timecodes = otio.opentime.RationalTime.to_timecodes(frames, rate)
+            self.assertEqual(
+                list(timecodes),
+                [
+                    otio.opentime.to_timecode(
+                        otio.opentime.RationalTime(f, rate), rate
+                    )
+                    for f in frames
+                ]
+            )
+
+        timecodes = otio.opentime.RationalTime.to_timecodes(
+            frames, 30000 / 1001
+        )
+        self.assertEqual(
+            list(otio.opentime.RationalTime.from_timecodes(
+                timecodes, 30000 / 1001
+            )),
+            frames
+        )
+
+        with self.assertRaises(ValueError):
+            otio.opentime.RationalTime.to_timecodes([0, -1], 24)
+        with self.assertRaises(ValueError):
+            otio.opentime.RationalTime.from_timecodes(["00:00:01"], 24)
+
     def test_dropframe_timecode_2997fps(self):
         """Test drop frame in action. Focused on minute roll overs
 
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the OpenTimelineIO project
+
+#include "utils.h"
+
+#include <opentimelineio/algo/renderList.h>
+#include <opentimelineio/clip.h>
+#include <opentimelineio/externalReference.h>
+#include <opentimelineio/gap.h>
+#include <opentimelineio/linearTimeWarp.h>
+#include <opentimelineio/stack.h>
+#include <opentimelineio/timeline.h>
+#include <opentimelineio/track.h>
+#include <opentimelineio/transition.h>
+
+#include <string>
+#include <vector>
+
+namespace otime = opentime::OPENTIME_VERSION;
+namespace otio  = opentimelineio::OPENTIMELINEIO_VERSION;
+
+using otime::RationalTime;
+using otime::TimeRange;
+using otio::algo::RenderSegment;
+
+namespace {
+
+// The name of the clip of each segment, or "" for the frames without one,
+// and where the segment ends.
+std::vector<std::pair<std::string, int64_t>>
+clips_of(std::vector<RenderSegment> const& segments)
+{
+    std::vector<std::pair<std::string, int64_t>> result;
+    for (auto const& segment: segments)
+    {
+        result.emplace_back(
+            segment.clip ? segment.clip->name() : std::string(),
+            segment.end_frame);
+    }
+    return result;
+}
+
+using Clips = std::vector<std::pair<std::string, int64_t>>;
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Tests tests;
+
+    tests.add_test("test_render_list_layers", [] {
+        // A, a gap, then B below; a gap, C, then D (disabled) on top
+        otio::SerializableObject::Retainer<otio::Timeline> timeline =
+            new otio::Timeline();
+        auto bottom = new otio::Track();
+        auto top    = new otio::Track();
+        timeline->tracks()->append_child(bottom);
+        timeline->tracks()->append_child(top);
+        otio::Clip* a = new otio::Clip(
+            "A",
+            new otio::ExternalReference("file:///A.mov"),
+            TimeRange(RationalTime(100, 24), RationalTime(48, 24)));
+        bottom->append_child(a);
+        bottom->append_child(new otio::Gap(RationalTime(24, 24)));
+        bottom->append_child(new otio::Clip(
+            "B",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(48, 24))));
+        top->append_child(new otio::Gap(RationalTime(12, 24)));
+        otio::Clip* c = new otio::Clip(
+            "C",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(24, 24)));
+        top->append_child(c);
+        otio::Clip* d = new otio::Clip(
+            "D",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(12, 24)));
+        d->set_enabled(false);
+        top->append_child(d);
+
+        otio::ErrorStatus err;
+        auto segments = otio::algo::render_list(timeline, 24, {}, &err);
+        assertFalse(otio::is_error(err));
+        assertEqual(
+            clips_of(segments),
+            Clips({ { "A", 12 },
+                    { "C", 36 },
+                    { "A", 48 },
+                    { "", 72 },
+                    { "B", 120 } }));
+        assertEqual(segments[0].source_start, RationalTime(100, 24));
+        assertEqual(segments[1].source_start, RationalTime(0, 24));
+        assertEqual(segments[2].source_start, RationalTime(136, 24));
+        assertEqual(segments[2].start_frame, int64_t(36));
+        assertEqual(segments[2].time_scale, 1.0);
+        assertEqual(segments[0].media_reference.value, a->media_reference());
+        assertTrue(!segments[3].media_reference);
+
+        // every frame maps to the media time of its clip
+        for (auto const& segment: segments)
+        {
+            for (int64_t f = segment.start_frame; f < segment.end_frame; ++f)
+            {
+                if (segment.clip)
+                {
+                    const RationalTime expected =
+                        timeline->media_time_transform(segment.clip)
+                            .applied_to(RationalTime(double(f), 24));
+                    assertEqual(
+                        segment.source_start
+                            + RationalTime(
+                                (f - segment.start_frame) * segment.time_scale,
+                                24),
+                        expected);
+                }
+            }
+        }
+
+        // at twice the rate
+        segments = otio::algo::render_list(timeline, 48, {}, &err);
+        assertEqual(
+            clips_of(segments),
+            Clips({ { "A", 24 },
+                    { "C", 72 },
+                    { "A", 96 },
+                    { "", 144 },
+                    { "B", 240 } }));
+
+        // part of the timeline
+        segments = otio::algo::render_list(
+            timeline,
+            24,
+            TimeRange(RationalTime(60, 24), RationalTime(24, 24)),
+            &err);
+        assertEqual(clips_of(segments), Clips({ { "", 12 }, { "B", 24 } }));
+        assertEqual(segments[1].source_start, RationalTime(0, 24));
+
+        // the top track, disabled
+        top->set_enabled(false);
+        segments = otio::algo::render_list(timeline, 24, {}, &err);
+        assertEqual(
+            clips_of(segments),
+            Clips({ { "A", 48 }, { "", 72 }, { "B", 120 } }));
+    });
+
+    tests.add_test("test_render_list_transitions_and_warps", [] {
+        // X, a transition, then Y at twice the speed
+        otio::SerializableObject::Retainer<otio::Timeline> timeline =
+            new otio::Timeline();
+        auto track = new otio::Track();
+        timeline->tracks()->append_child(track);
+        track->append_child(new otio::Clip(
+            "X",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(24, 24))));
+        auto transition = new otio::Transition(
+            "dissolve",
+            otio::Transition::Type::SMPTE_Dissolve,
+            RationalTime(6, 24),
+            RationalTime(6, 24));
+        track->append_child(transition);
+        otio::Clip* y = new otio::Clip(
+            "Y",
+            nullptr,
+            TimeRange(RationalTime(50, 24), RationalTime(24, 24)));
+        y->effects().push_back(
+            new otio::LinearTimeWarp("fast", "LinearTimeWarp", 2));
+        track->append_child(y);
+
+        otio::ErrorStatus err;
+        auto segments = otio::algo::render_list(timeline, 24, {}, &err);
+        assertFalse(otio::is_error(err));
+        assertEqual(
+            clips_of(segments),
+            Clips({ { "X", 18 }, { "X", 24 }, { "Y", 30 }, { "Y", 48 } }));
+        assertTrue(!segments[0].transition);
+        assertEqual(segments[1].transition.value, transition);
+        assertEqual(segments[2].transition.value, transition);
+        assertTrue(!segments[3].transition);
+        assertEqual(segments[2].source_start, RationalTime(50, 24));
+        assertEqual(segments[2].time_scale, 2.0);
+        assertEqual(segments[3].source_start, RationalTime(62, 24));
+
+        // a nested stack at half speed, showing the first 12 frames of its
+        // own track
+        auto nested       = new otio::Stack(
+            "nested",
+            TimeRange(RationalTime(0, 24), RationalTime(12, 24)),
+            otio::AnyDictionary(),
+            { new otio::LinearTimeWarp("slow", "LinearTimeWarp", 0.5) });
+        auto nested_track = new otio::Track();
+        nested_track->append_child(new otio::Clip(
+            "P",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(4, 24))));
+        nested_track->append_child(new otio::Clip(
+            "Q",
+            nullptr,
+            TimeRange(RationalTime(10, 24), RationalTime(20, 24))));
+        nested->append_child(nested_track);
+        track->append_child(nested);
+        segments = otio::algo::render_list(timeline, 24, {}, &err);
+        assertEqual(
+            clips_of(segments),
+            Clips({ { "X", 18 },
+                    { "X", 24 },
+                    { "Y", 30 },
+                    { "Y", 48 },
+                    { "P", 56 },
+                    { "Q", 60 } }));
+        assertEqual(segments[5].source_start, RationalTime(10, 24));
+        assertEqual(segments[5].time_scale, 0.5);
+
+        // a time effect that isn't linear can't be rendered
+        y->effects().push_back(new otio::TimeEffect());
+        segments = otio::algo::render_list(timeline, 24, {}, &err);
+        assertEqual(err.outcome, otio::ErrorStatus::NOT_IMPLEMENTED);
+        assertTrue(segments.empty());
+    });
+
+    tests.run(argc, argv);
+    return 0;
+}
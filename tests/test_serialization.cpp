@@ -4,19 +4,65 @@
 #include "utils.h"
 
 #include <opentimelineio/clip.h>
+#include <opentimelineio/deserialization.h>
+#include <opentimelineio/externalReference.h>
+#include <opentimelineio/gap.h>
+#include <opentimelineio/generatorReference.h>
+#include <opentimelineio/linearTimeWarp.h>
+#include <opentimelineio/marker.h>
 #include <opentimelineio/timeline.h>
+#include <opentimelineio/timelineStreamWriter.h>
 #include <opentimelineio/track.h>
+#include <opentimelineio/transition.h>
 #include <opentimelineio/serialization.h>
 #include <opentimelineio/serializableObject.h>
 #include <opentimelineio/serializableObjectWithMetadata.h>
 #include <opentimelineio/safely_typed_any.h>
+#include <opentimelineio/typeRegistry.h>
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 
 namespace otime = opentime::OPENTIME_VERSION;
 namespace otio  = opentimelineio::OPENTIMELINEIO_VERSION;
 
+namespace {
+
+// A schema whose "value" field was called "old" in version 1, then "mid"
+// (and scaled by 10) in version 2.
+class UpgradedThing : public otio::SerializableObject
+{
+public:
+    struct Schema
+    {
+        static auto constexpr name   = "UpgradedThing";
+        static int constexpr version = 3;
+    };
+
+    using Parent = otio::SerializableObject;
+
+    int64_t value = 0;
+
+protected:
+    bool read_from(Reader& reader) override
+    {
+        return reader.read_if_present("value", &value)
+               && Parent::read_from(reader);
+    }
+
+    void write_to(Writer& writer) const override
+    {
+        Parent::write_to(writer);
+        writer.write("value", value);
+    }
+};
+
+} // namespace
+
 int
 main(int argc, char** argv)
 {
@@ -115,6 +161,1194 @@ main(int argc, char** argv)
 })CONTENT");
     });
 
+    tests.add_test(
+        "parallel output matches serial output", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("parallel");
+        for (int t = 0; t < 5; ++t)
+        {
+            otio::SerializableObject::Retainer<otio::Track> tr =
+                new otio::Track("track " + std::to_string(t));
+            for (int c = 0; c < 10; ++c)
+            {
+                otio::SerializableObject::Retainer<otio::Clip> cl =
+                    new otio::Clip(
+                        "clip " + std::to_string(c),
+                        nullptr,
+                        otime::TimeRange(
+                            otime::RationalTime(c, 24),
+                            otime::RationalTime(10 + c, 24)));
+                cl->metadata()["index"] = int64_t(c);
+                tr->append_child(cl);
+            }
+            tl->tracks()->append_child(tr);
+        }
+
+        otio::schema_version_map downgrade_manifest = { { "Clip", 1 } };
+        for (int indent: { 4, 2, 0 })
+        {
+            for (auto manifest: { (otio::schema_version_map*) nullptr,
+                                  &downgrade_manifest })
+            {
+                otio::ErrorStatus err;
+                auto serial = tl.value->to_json_string(&err, manifest, indent);
+                assertFalse(otio::is_error(err));
+                auto parallel =
+                    tl.value->to_json_string(&err, manifest, indent, 4);
+                assertFalse(otio::is_error(err));
+                assertEqual(parallel, serial);
+            }
+        }
+    });
+
+    tests.add_test(
+        "streamed timeline matches serialized timeline", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("streamed", otime::RationalTime(86400, 24));
+        tl->metadata()["show"] = std::string("demo");
+        for (auto kind: { otio::Track::Kind::video, otio::Track::Kind::audio })
+        {
+            otio::SerializableObject::Retainer<otio::Track> tr =
+                new otio::Track(kind);
+            tr->set_kind(kind);
+            tr->append_child(new otio::Clip(
+                "first",
+                nullptr,
+                otime::TimeRange(
+                    otime::RationalTime(0, 24),
+                    otime::RationalTime(48, 24))));
+            tr->append_child(new otio::Gap(otime::RationalTime(12, 24)));
+            tr->append_child(new otio::Clip(
+                "second",
+                nullptr,
+                otime::TimeRange(
+                    otime::RationalTime(100, 24),
+                    otime::RationalTime(24, 24))));
+            tl->tracks()->append_child(tr);
+        }
+
+        for (int indent: { 4, 0 })
+        {
+            std::ostringstream output;
+            {
+                otio::TimelineStreamWriter w(
+                    output,
+                    tl->name(),
+                    tl->global_start_time(),
+                    tl->metadata(),
+                    indent);
+                for (auto track: tl->tracks()->children())
+                {
+                    otio::ErrorStatus err;
+                    assertTrue(w.begin_track(
+                        dynamic_cast<otio::Track*>(track.value),
+                        &err));
+                    for (auto child:
+                         dynamic_cast<otio::Track*>(track.value)->children())
+                    {
+                        assertTrue(w.append(child, &err));
+                    }
+                    assertTrue(w.end_track(&err));
+                }
+                otio::ErrorStatus err;
+                assertTrue(w.close(&err));
+                assertFalse(w.is_open());
+            }
+
+            otio::ErrorStatus err;
+            assertEqual(output.str(), tl->to_json_string(&err, {}, indent));
+        }
+    });
+
+    tests.add_test(
+        "streamed timeline is downgraded like serialized timeline", [] {
+        // a downgrade of the track, so that its header is written from the
+        // downgraded dictionary
+        otio::TypeRegistry::instance().register_downgrade_function(
+            otio::Track::Schema::name,
+            1,
+            [](otio::AnyDictionary* d) {
+                (*d)["track_kind"] = (*d)["kind"];
+                d->erase("kind");
+            });
+        otio::schema_version_map downgrade_manifest = { { "Track", 0 } };
+
+        // the header of the track comes from a copy without its children,
+        // which are appended (and downgraded) one by one
+        otio::SerializableObject::Retainer<otio::Track> tr =
+            new otio::Track("video");
+        tr->metadata()["children"] = std::string("not these");
+        otio::SerializableObject::Retainer<otio::Track> full_tr =
+            dynamic_cast<otio::Track*>(tr->clone());
+        full_tr->append_child(new otio::Gap(otime::RationalTime(12, 24)));
+
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("downgraded");
+        tl->tracks()->append_child(tr);
+
+        std::ostringstream output;
+        {
+            otio::TimelineStreamWriter w(
+                output,
+                tl->name(),
+                tl->global_start_time(),
+                tl->metadata(),
+                4,
+                &downgrade_manifest);
+            otio::ErrorStatus err;
+            assertTrue(w.begin_track(full_tr, &err));
+            assertTrue(w.end_track(&err));
+            assertTrue(w.close(&err));
+        }
+
+        otio::ErrorStatus err;
+        const std::string serialized =
+            tl->to_json_string(&err, &downgrade_manifest, 4);
+        assertFalse(otio::is_error(err));
+        assertEqual(output.str(), serialized);
+        assertTrue(serialized.find("\"Track.0\"") != std::string::npos);
+        assertTrue(serialized.find("\"track_kind\"") != std::string::npos);
+    });
+
+    tests.add_test(
+        "doubles are written in the shortest form", [] {
+        otio::AnyVector values{ 0.0,  -0.0, 24.0,    -48.0, 23.976,
+                                0.1,  1e-6, 1e-7,    0.00125, 1e20,
+                                1e21, 1.5e300, 9007199254740993.0 };
+
+        otio::ErrorStatus err;
+        auto output = otio::serialize_json_to_string(values, {}, &err, -1);
+        assertFalse(otio::is_error(err));
+        assertEqual(
+            output,
+            std::string("[0.0,-0.0,24.0,-48.0,23.976,0.1,0.000001,1e-7,"
+                        "0.00125,100000000000000000000.0,1e21,1.5e300,"
+                        "9007199254740992.0]"));
+
+        std::any result;
+        assertTrue(otio::deserialize_json_from_string(output, &result, &err));
+        auto const& read = std::any_cast<otio::AnyVector const&>(result);
+        assertEqual(read.size(), values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            assertEqual(
+                std::any_cast<double>(read[i]),
+                std::any_cast<double>(values[i]));
+        }
+    });
+
+    tests.add_test(
+        "files are written like strings", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("file test");
+        otio::SerializableObject::Retainer<otio::Track> tr =
+            new otio::Track("video");
+        // more than the 1 MiB file buffer, both for the text of the track
+        // written in parallel and for the reserve of a long string
+        for (int i = 0; i < 4000; ++i)
+        {
+            tr->append_child(new otio::Clip(
+                "clip " + std::to_string(i),
+                new otio::ExternalReference("file:///a.mov"),
+                otime::TimeRange(
+                    otime::RationalTime(i, 24),
+                    otime::RationalTime(24, 24))));
+        }
+        tl->tracks()->append_child(tr);
+        tl->metadata()["long"] = std::string(1 << 20, 'x');
+
+        const std::string file_name =
+            (std::filesystem::temp_directory_path() / "otio_file_test.otio")
+                .string();
+        for (int indent: { 4, 0, -1 })
+        {
+            for (auto [sync, max_threads]:
+                 { std::pair(false, 1), std::pair(true, 1), std::pair(false, 4) })
+            {
+                otio::ErrorStatus err;
+                assertTrue(otio::serialize_json_to_file(
+                    otio::SerializableObject::Retainer<>(tl),
+                    file_name,
+                    nullptr,
+                    &err,
+                    indent,
+                    max_threads,
+                    sync));
+                assertFalse(otio::is_error(err));
+
+                std::ifstream     file(file_name, std::ios::binary);
+                std::stringstream contents;
+                contents << file.rdbuf();
+                assertEqual(
+                    contents.str(),
+                    tl->to_json_string(&err, {}, indent));
+            }
+        }
+
+        otio::ErrorStatus sync_err;
+        assertTrue(tl->to_json_file(file_name, &sync_err, nullptr, 0, 1, true));
+        assertFalse(otio::is_error(sync_err));
+        otio::SerializableObject::Retainer<> synced(
+            otio::SerializableObject::from_json_file(file_name));
+        assertTrue(synced && synced->is_equivalent_to(*tl));
+        std::filesystem::remove(file_name);
+
+        otio::ErrorStatus err;
+        assertFalse(otio::serialize_json_to_file(
+            otio::SerializableObject::Retainer<>(tl),
+            "/nonexistent/directory/file.otio",
+            nullptr,
+            &err));
+        assertEqual(err.outcome, otio::ErrorStatus::FILE_WRITE_FAILED);
+    });
+
+    tests.add_test(
+        "streamed reading reports children and their ranges", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("streamed");
+        otio::SerializableObject::Retainer<otio::Track> video =
+            new otio::Track("V");
+        video->append_child(new otio::Clip(
+            "a",
+            nullptr,
+            otime::TimeRange(
+                otime::RationalTime(0, 24),
+                otime::RationalTime(48, 24))));
+        video->append_child(new otio::Transition(
+            "dissolve",
+            otio::Transition::Type::SMPTE_Dissolve,
+            otime::RationalTime(6, 24),
+            otime::RationalTime(6, 24)));
+        video->append_child(new otio::Clip(
+            "b",
+            nullptr,
+            otime::TimeRange(
+                otime::RationalTime(10, 24),
+                otime::RationalTime(24, 24))));
+        video->append_child(new otio::Gap(otime::RationalTime(12, 24)));
+        otio::SerializableObject::Retainer<otio::Stack> nested =
+            new otio::Stack("nested");
+        otio::SerializableObject::Retainer<otio::Track> inner =
+            new otio::Track("inner");
+        inner->append_child(new otio::Clip(
+            "c",
+            nullptr,
+            otime::TimeRange(
+                otime::RationalTime(0, 24),
+                otime::RationalTime(30, 24))));
+        nested->append_child(inner);
+        video->append_child(nested);
+        tl->tracks()->append_child(video);
+        otio::SerializableObject::Retainer<otio::Track> audio =
+            new otio::Track("A", std::nullopt, otio::Track::Kind::audio);
+        audio->append_child(new otio::Gap(otime::RationalTime(100, 24)));
+        tl->tracks()->append_child(audio);
+
+        std::map<std::string, otio::Composition*> compositions = {
+            { "tracks", tl->tracks() },
+            { "V", video },
+            { "nested", nested },
+            { "inner", inner },
+            { "A", audio }
+        };
+
+        std::vector<std::string> names;
+        otio::ErrorStatus        err;
+        bool                     ok = otio::deserialize_json_stream_from_string(
+            tl->to_json_string(),
+            [&](otio::StreamedComposable const& streamed) {
+                auto parent = compositions[streamed.parent_name];
+                assertEqual(
+                    streamed.range_in_parent,
+                    parent->range_of_child_at_index(streamed.index));
+                assertEqual(
+                    streamed.child->name(),
+                    parent->children()[streamed.index]->name());
+                names.push_back(streamed.child->name());
+                return true;
+            },
+            &err);
+        assertTrue(ok);
+        assertFalse(otio::is_error(err));
+        assertEqual(
+            names,
+            std::vector<std::string>(
+                { "a", "dissolve", "b", "", "c", "inner", "nested", "V", "",
+                  "A" }));
+
+        names.clear();
+        ok = otio::deserialize_json_stream_from_string(
+            tl->to_json_string(),
+            [&](otio::StreamedComposable const& streamed) {
+                names.push_back(streamed.child->name());
+                return names.size() < 2;
+            },
+            &err);
+        assertTrue(ok);
+        assertEqual(names.size(), size_t(2));
+    });
+
+    tests.add_test(
+        "streamed ranges of mixed rate tracks are exact", [] {
+        otio::SerializableObject::Retainer<otio::Stack> stack =
+            new otio::Stack("stack");
+        otio::SerializableObject::Retainer<otio::Track> track =
+            new otio::Track("track");
+        track->append_child(new otio::Transition(
+            "in",
+            otio::Transition::Type::SMPTE_Dissolve,
+            otime::RationalTime(7, 30000.0 / 1001),
+            otime::RationalTime(3, 25)));
+        for (int i = 0; i < 300; ++i)
+        {
+            for (double rate: { 24.0, 25.0, 30000.0 / 1001, 60.0 })
+            {
+                track->append_child(new otio::Clip(
+                    "clip",
+                    nullptr,
+                    otime::TimeRange(
+                        otime::RationalTime(0, rate),
+                        otime::RationalTime(i % 7 + 1, rate))));
+            }
+        }
+        track->append_child(new otio::Transition(
+            "out",
+            otio::Transition::Type::SMPTE_Dissolve,
+            otime::RationalTime(5, 24),
+            otime::RationalTime(11, 30000.0 / 1001)));
+        stack->append_child(track);
+
+        // the times are compared exactly, as ranges and doubles compare
+        // equal within an epsilon
+        auto assertSame = [](otime::TimeRange lhs, otime::TimeRange rhs) {
+            assertTrue(lhs.start_time().value() == rhs.start_time().value());
+            assertTrue(lhs.start_time().rate() == rhs.start_time().rate());
+            assertTrue(lhs.duration().value() == rhs.duration().value());
+            assertTrue(lhs.duration().rate() == rhs.duration().rate());
+        };
+        size_t            streamed = 0;
+        otio::ErrorStatus err;
+        assertTrue(otio::deserialize_json_stream_from_string(
+            stack->to_json_string(),
+            [&](otio::StreamedComposable const& child) {
+                ++streamed;
+                if (child.parent_name == "stack")
+                {
+                    // the range of the track as a child of the stack is its
+                    // available range, summed up while it was streamed
+                    assertSame(
+                        child.range_in_parent,
+                        stack->range_of_child_at_index(child.index));
+                    assertSame(
+                        child.range_in_parent,
+                        track->available_range());
+                }
+                else
+                {
+                    assertSame(
+                        child.range_in_parent,
+                        track->range_of_child_at_index(child.index));
+                }
+                return true;
+            },
+            &err));
+        assertFalse(otio::is_error(err));
+        assertEqual(streamed, track->children().size() + 1);
+    });
+
+    tests.add_test(
+        "binary format round trips with json", [] {
+        std::string const json = R"CONTENT({
+    "OTIO_SCHEMA": "Timeline.1",
+    "metadata": {
+        "int": -42,
+        "big": 9007199254740993,
+        "double": 0.1,
+        "integral_double": 2.0,
+        "flag": true,
+        "nothing": null,
+        "list": [1, "two", [3.5], {}],
+        "range": {
+            "OTIO_SCHEMA": "TimeRange.1",
+            "duration": {"OTIO_SCHEMA": "RationalTime.1", "rate": 24.0, "value": 10.0},
+            "start_time": {"OTIO_SCHEMA": "RationalTime.1", "rate": 24.0, "value": 1.0}
+        },
+        "unknown": {
+            "OTIO_SCHEMA": "MadeUpSchema.3",
+            "answer": 42,
+            "nested": {"OTIO_SCHEMA": "V2d.1", "x": 1.0, "y": 2.0}
+        }
+    },
+    "name": "binary",
+    "global_start_time": {"OTIO_SCHEMA": "RationalTime.1", "rate": 30000.0, "value": 1001.0},
+    "tracks": {
+        "OTIO_SCHEMA": "Stack.1",
+        "metadata": {},
+        "name": "tracks",
+        "source_range": null,
+        "effects": [],
+        "markers": [],
+        "enabled": true,
+        "color": {"OTIO_SCHEMA": "Color.1", "r": 1.0, "g": 0.5, "b": 0.0, "a": 1.0, "name": "orange"},
+        "children": [],
+        "dynamic_field": "kept"
+    }
+})CONTENT";
+
+        otio::ErrorStatus err;
+        std::any          decoded;
+        assertTrue(otio::deserialize_json_from_string(json, &decoded, &err));
+        std::string const expected = otio::serialize_json_to_string(decoded);
+
+        std::string const binary = otio::serialize_binary_to_string(
+            decoded,
+            nullptr,
+            &err);
+        assertFalse(otio::is_error(err));
+        assertTrue(binary.size() < expected.size());
+
+        std::any from_binary;
+        assertTrue(
+            otio::deserialize_binary_from_string(binary, &from_binary, &err));
+        assertEqual(otio::serialize_json_to_string(from_binary), expected);
+
+        std::string truncated = binary.substr(0, binary.size() / 2);
+        assertFalse(
+            otio::deserialize_binary_from_string(truncated, &from_binary, &err));
+        assertEqual(err.outcome, otio::ErrorStatus::JSON_PARSE_ERROR);
+
+        std::string corrupt = binary;
+        corrupt[16] = '\xff';
+        assertFalse(
+            otio::deserialize_binary_from_string(corrupt, &from_binary, &err));
+    });
+
+    tests.add_test(
+        "binary subtrees load by path", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("indexed");
+        for (int t = 0; t < 4; ++t)
+        {
+            otio::SerializableObject::Retainer<otio::Track> tr =
+                new otio::Track("track " + std::to_string(t));
+            for (int c = 0; c < 3; ++c)
+            {
+                tr->append_child(new otio::Clip(
+                    "clip " + std::to_string(t) + "." + std::to_string(c),
+                    nullptr,
+                    otime::TimeRange(
+                        otime::RationalTime(c, 24),
+                        otime::RationalTime(24, 24))));
+            }
+            tl->tracks()->append_child(tr);
+        }
+
+        otio::ErrorStatus err;
+        std::string const binary = otio::serialize_binary_to_string(
+            otio::SerializableObject::Retainer<>(tl),
+            nullptr,
+            &err);
+        assertFalse(otio::is_error(err));
+
+        std::any track;
+        assertTrue(otio::deserialize_binary_subtree_from_string(
+            binary,
+            "tracks/3",
+            &track,
+            &err));
+        auto loaded = dynamic_cast<otio::Track*>(
+            std::any_cast<otio::SerializableObject::Retainer<>>(track).value);
+        assertTrue(loaded != nullptr);
+        assertEqual(loaded->name(), std::string("track 3"));
+        assertEqual(
+            loaded->to_json_string(),
+            tl->tracks()->children()[3]->to_json_string());
+
+        std::any clip;
+        assertTrue(otio::deserialize_binary_subtree_from_string(
+            binary,
+            "tracks/1/2",
+            &clip,
+            &err));
+        auto track_1 =
+            dynamic_cast<otio::Track*>(tl->tracks()->children()[1].value);
+        assertEqual(
+            std::any_cast<otio::SerializableObject::Retainer<>>(clip)
+                .value->to_json_string(),
+            track_1->children()[2]->to_json_string());
+
+        std::any root;
+        assertTrue(otio::deserialize_binary_subtree_from_string(
+            binary,
+            "",
+            &root,
+            &err));
+        assertEqual(
+            std::any_cast<otio::SerializableObject::Retainer<>>(root)
+                .value->to_json_string(),
+            tl->to_json_string());
+
+        // every indexed path is found by the search of the ordered index
+        for (int t = 0; t < 4; ++t)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                std::any any_clip;
+                assertTrue(otio::deserialize_binary_subtree_from_string(
+                    binary,
+                    "tracks/" + std::to_string(t) + "/" + std::to_string(c),
+                    &any_clip,
+                    &err));
+                auto loaded_clip = dynamic_cast<otio::Clip*>(
+                    std::any_cast<otio::SerializableObject::Retainer<>>(
+                        any_clip)
+                        .value);
+                assertTrue(loaded_clip != nullptr);
+                assertEqual(
+                    loaded_clip->name(),
+                    "clip " + std::to_string(t) + "." + std::to_string(c));
+            }
+        }
+
+        for (auto path: { "tracks/4", "tracks/0/3", "a", "tracks/", "z" })
+        {
+            std::any missing;
+            assertFalse(otio::deserialize_binary_subtree_from_string(
+                binary,
+                path,
+                &missing,
+                &err));
+            assertEqual(err.outcome, otio::ErrorStatus::KEY_NOT_FOUND);
+        }
+    });
+
+    tests.add_test(
+        "corrupt binary data fails without reading in dropped objects", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("corrupt");
+        for (int t = 0; t < 2; ++t)
+        {
+            auto tr = new otio::Track("track " + std::to_string(t));
+            tl->tracks()->append_child(tr);
+            for (int c = 0; c < 3; ++c)
+            {
+                tr->append_child(new otio::Clip(
+                    "clip " + std::to_string(c),
+                    new otio::ExternalReference("file:///clip.mov"),
+                    otime::TimeRange(
+                        otime::RationalTime(0, 24),
+                        otime::RationalTime(24, 24)),
+                    otio::AnyDictionary{ { "index", int64_t(c) } },
+                    {},
+                    { new otio::Marker("marker") }));
+            }
+        }
+        std::string const binary = otio::serialize_binary_to_string(
+            otio::SerializableObject::Retainer<>(tl));
+
+        // every byte changed, and every truncation, of the whole file and
+        // of a subtree either loads or fails with an error
+        auto load = [](std::string const& input) {
+            std::any          value;
+            otio::ErrorStatus err;
+            if (!otio::deserialize_binary_from_string(input, &value, &err))
+            {
+                assertTrue(otio::is_error(err));
+            }
+            std::any          subtree;
+            otio::ErrorStatus subtree_err;
+            if (!otio::deserialize_binary_subtree_from_string(
+                    input,
+                    "tracks/1",
+                    &subtree,
+                    &subtree_err))
+            {
+                assertTrue(otio::is_error(subtree_err));
+            }
+        };
+        for (size_t i = 0; i < binary.size(); ++i)
+        {
+            for (char byte: { '\x00', '\x01', '\x7f', '\xff' })
+            {
+                std::string corrupt = binary;
+                if (corrupt[i] != byte)
+                {
+                    corrupt[i] = byte;
+                    load(corrupt);
+                }
+            }
+            load(binary.substr(0, i));
+        }
+
+        // an object dropped by a duplicate key, where the first value is
+        // kept, is still read in safely
+        std::any          value;
+        otio::ErrorStatus err;
+        assertTrue(otio::deserialize_json_from_string(
+            R"({
+                "OTIO_SCHEMA": "Timeline.1",
+                "name": "duplicate",
+                "tracks": {
+                    "OTIO_SCHEMA": "Stack.1",
+                    "name": "first",
+                    "children": []
+                },
+                "tracks": {
+                    "OTIO_SCHEMA": "Stack.1",
+                    "name": "second",
+                    "children": []
+                }
+            })",
+            &value,
+            &err));
+        auto duplicate = dynamic_cast<otio::Timeline*>(
+            std::any_cast<otio::SerializableObject::Retainer<>>(value).value);
+        assertEqual(duplicate->tracks()->name(), std::string("first"));
+    });
+
+    tests.add_test(
+        "lazy metadata is decoded on access and written verbatim", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("lazy");
+        otio::AnyDictionary nested;
+        nested["list"] = otio::AnyVector{ 1.5, std::string("x") };
+        otio::AnyDictionary vendor;
+        vendor["nested"]         = nested;
+        vendor["id"]             = int64_t(7);
+        tl->metadata()["vendor"] = vendor;
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        otio::SerializableObject::Retainer<otio::Clip>  cl =
+            new otio::Clip("clip");
+        cl->metadata()["time"] = otime::RationalTime(1, 24);
+        tr->append_child(cl);
+        tl->tracks()->append_child(tr);
+
+        for (int indent: { 4, 0 })
+        {
+            std::string const json =
+                tl->to_json_string(nullptr, nullptr, indent);
+
+            otio::ErrorStatus err;
+            std::any          decoded;
+            assertTrue(otio::deserialize_json_from_string(
+                json,
+                &decoded,
+                &err,
+                true));
+            otio::SerializableObject::Retainer<otio::Timeline> lazy(
+                dynamic_cast<otio::Timeline*>(
+                    std::any_cast<otio::SerializableObject::Retainer<>>(decoded)
+                        .value));
+            assertTrue(lazy->is_metadata_lazy());
+
+            // metadata holding schema objects is decoded right away
+            auto lazy_clip = dynamic_cast<otio::Clip*>(
+                dynamic_cast<otio::Track*>(
+                    lazy->tracks()->children()[0].value)
+                    ->children()[0]
+                    .value);
+            assertFalse(lazy_clip->is_metadata_lazy());
+
+            assertEqual(lazy->to_json_string(nullptr, nullptr, indent), json);
+            assertEqual(lazy->to_json_string(nullptr, nullptr, 2),
+                        tl->to_json_string(nullptr, nullptr, 2));
+            assertEqual(lazy->to_json_string(nullptr, nullptr, 0),
+                        tl->to_json_string(nullptr, nullptr, 0));
+
+            otio::SerializableObject::Retainer<otio::Timeline> const_lazy =
+                lazy;
+            otio::Timeline const* const_tl = const_lazy;
+            assertEqual(
+                std::any_cast<int64_t>(
+                    std::any_cast<otio::AnyDictionary>(
+                        const_tl->metadata()["vendor"])["id"]),
+                int64_t(7));
+            assertTrue(lazy->is_metadata_lazy());
+
+            lazy->metadata()["added"] = true;
+            assertFalse(lazy->is_metadata_lazy());
+            tl->metadata()["added"] = true;
+            assertEqual(
+                lazy->to_json_string(nullptr, nullptr, indent),
+                tl->to_json_string(nullptr, nullptr, indent));
+            tl->metadata().erase("added");
+        }
+
+        // the objects read from a file (or from a string handed over) keep
+        // the input alive, even once the file is gone
+        std::string const json = tl->to_json_string(nullptr, nullptr, 4);
+        const std::string file_name =
+            (std::filesystem::temp_directory_path() / "otio_lazy_test.otio")
+                .string();
+        {
+            std::ofstream file(file_name, std::ios::binary);
+            file << json;
+        }
+        otio::ErrorStatus err;
+        std::any          from_file;
+        assertTrue(otio::deserialize_json_from_file(
+            file_name,
+            &from_file,
+            &err,
+            true));
+        std::filesystem::remove(file_name);
+        std::any from_string;
+        assertTrue(otio::deserialize_json_from_string(
+            std::string(json),
+            &from_string,
+            &err,
+            true));
+        for (auto const* decoded: { &from_file, &from_string })
+        {
+            otio::SerializableObject::Retainer<otio::Timeline> lazy(
+                dynamic_cast<otio::Timeline*>(
+                    std::any_cast<otio::SerializableObject::Retainer<>>(
+                        *decoded)
+                        .value));
+            assertTrue(lazy->is_metadata_lazy());
+            assertEqual(lazy->to_json_string(nullptr, nullptr, 4), json);
+            assertEqual(
+                lazy->to_json_string(nullptr, nullptr, 0),
+                tl->to_json_string(nullptr, nullptr, 0));
+        }
+    });
+
+    tests.add_test("native clone matches the serialized clone", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("clone");
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        otio::SerializableObject::Retainer<otio::Clip>  cl = new otio::Clip(
+            "clip",
+            new otio::ExternalReference("file:///a.mov"),
+            otio::TimeRange(
+                otio::RationalTime(0, 24),
+                otio::RationalTime(48, 24)));
+        cl->set_media_references(
+            { { "high", new otio::ExternalReference("file:///b.mov") },
+              { otio::Clip::default_media_key,
+                new otio::GeneratorReference("bars", "SMPTEBars") } },
+            otio::Clip::default_media_key);
+        cl->effects().push_back(new otio::LinearTimeWarp("warp", "", 2.0));
+        cl->markers().push_back(new otio::Marker("marker"));
+        tr->append_child(cl);
+        tr->append_child(new otio::Transition("dissolve"));
+        tr->append_child(new otio::Gap(
+            otio::TimeRange(otio::RationalTime(), otio::RationalTime(12, 24))));
+        tl->tracks()->append_child(tr);
+
+        // objects held in metadata, including one of an unknown schema that
+        // can only be cloned through serialization
+        otio::ErrorStatus err;
+        otio::SerializableObject::Retainer<> unknown(
+            otio::SerializableObject::from_json_string(
+                R"({"OTIO_SCHEMA": "Bogus.1", "value": 1})",
+                &err));
+        assertFalse(otio::is_error(err));
+        tl->metadata()["objects"] = otio::AnyVector{
+            otio::SerializableObject::Retainer<>(new otio::Marker("held")),
+            unknown
+        };
+
+        otio::SerializableObject::Retainer<otio::Timeline> native(
+            dynamic_cast<otio::Timeline*>(tl->clone(&err)));
+        assertFalse(otio::is_error(err));
+        otio::SerializableObject::Retainer<otio::Timeline> serialized(
+            dynamic_cast<otio::Timeline*>(tl->clone_via_serialization(&err)));
+        assertFalse(otio::is_error(err));
+
+        assertEqual(native->to_json_string(), tl->to_json_string());
+        assertEqual(native->to_json_string(), serialized->to_json_string());
+
+        auto native_track =
+            dynamic_cast<otio::Track*>(native->tracks()->children()[0].value);
+        assertTrue(native_track != tr);
+        assertTrue(native_track->parent() == native->tracks());
+        for (auto const& child: native_track->children())
+        {
+            assertTrue(child->parent() == native_track);
+            assertTrue(native_track->has_child(child));
+        }
+
+        auto native_objects =
+            std::any_cast<otio::AnyVector>(native->metadata()["objects"]);
+        auto native_unknown =
+            std::any_cast<otio::SerializableObject::Retainer<>>(
+                native_objects[1]);
+        assertTrue(native_unknown.value != unknown.value);
+        assertTrue(native_unknown->is_unknown_schema());
+    });
+
+    tests.add_test("clones share metadata until it is modified", [] {
+        otio::SerializableObject::Retainer<otio::Clip> cl =
+            new otio::Clip("clip");
+        cl->metadata()["vendor"] = otio::AnyDictionary{ { "id", int64_t(7) } };
+        otio::SerializableObject::Retainer<otio::Marker> marker =
+            new otio::Marker("marker");
+        marker->metadata()["held"] = otio::SerializableObject::Retainer<>(
+            new otio::Marker("held"));
+        cl->markers().push_back(marker);
+
+        otio::SerializableObject::Retainer<otio::Clip> first(
+            dynamic_cast<otio::Clip*>(cl->clone()));
+        otio::SerializableObject::Retainer<otio::Clip> second(
+            dynamic_cast<otio::Clip*>(first->clone()));
+        assertFalse(cl->is_metadata_shared());
+        assertTrue(first->is_metadata_shared());
+        assertTrue(second->is_metadata_shared());
+        assertEqual(second->to_json_string(), cl->to_json_string());
+
+        // metadata holding objects is always deep cloned
+        assertFalse(first->markers()[0]->is_metadata_shared());
+
+        // modifying one clone leaves the others alone
+        second->metadata()["added"] = true;
+        assertFalse(second->is_metadata_shared());
+        assertTrue(first->is_metadata_shared());
+        otio::Clip const* const_first = first;
+        assertEqual(const_first->metadata().size(), size_t(1));
+        assertEqual(cl->metadata().size(), size_t(1));
+        assertEqual(second->metadata().size(), size_t(2));
+
+        // and so does modifying the source
+        cl->metadata()["source"] = true;
+        assertEqual(const_first->metadata().size(), size_t(1));
+
+        // metadata that was constructed or read, and never handed out, is
+        // shared by the first clone already
+        otio::SerializableObject::Retainer<otio::Clip> constructed =
+            new otio::Clip("clip", nullptr, std::nullopt, { { "a", 1.0 } });
+        otio::SerializableObject::Retainer<otio::Clip> read(
+            dynamic_cast<otio::Clip*>(
+                otio::SerializableObject::from_json_string(
+                    constructed->to_json_string())));
+        for (auto const& source: { constructed, read })
+        {
+            assertTrue(source->is_metadata_shared());
+            otio::SerializableObject::Retainer<otio::Clip> clone(
+                dynamic_cast<otio::Clip*>(source->clone()));
+            assertTrue(source->is_metadata_shared());
+            assertTrue(clone->is_metadata_shared());
+            assertTrue(clone->is_equivalent_to(*source));
+
+            clone->metadata()["b"] = 2.0;
+            source->metadata()["c"] = 3.0;
+            assertEqual(clone->metadata().size(), size_t(2));
+            assertEqual(source->metadata().size(), size_t(2));
+            assertFalse(source->is_metadata_shared());
+        }
+    });
+
+    tests.add_test("is_equivalent_to reports the first difference", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("equivalence");
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        for (int i = 0; i < 3; ++i)
+        {
+            tr->append_child(new otio::Clip(
+                "clip",
+                new otio::ExternalReference("file:///a.mov"),
+                otio::TimeRange(
+                    otio::RationalTime(0, 24),
+                    otio::RationalTime(24, 24))));
+        }
+        tl->tracks()->append_child(tr);
+        tl->metadata()["vendor"] = otio::AnyDictionary{ { "id", int64_t(7) } };
+
+        otio::SerializableObject::Retainer<otio::Timeline> other(
+            dynamic_cast<otio::Timeline*>(tl->clone()));
+        std::string path = "unset";
+        assertTrue(tl->is_equivalent_to(*other, &path));
+        assertEqual(path, std::string());
+
+        other->metadata()["vendor"] =
+            otio::AnyDictionary{ { "id", int64_t(8) } };
+        assertFalse(tl->is_equivalent_to(*other, &path));
+        assertEqual(path, std::string("metadata/vendor/id"));
+        other->metadata()["vendor"] = tl->metadata()["vendor"];
+
+        auto other_track =
+            dynamic_cast<otio::Track*>(other->tracks()->children()[0].value);
+        auto other_clip =
+            dynamic_cast<otio::Clip*>(other_track->children()[1].value);
+        other_clip->set_source_range(otio::TimeRange(
+            otio::RationalTime(0, 24),
+            otio::RationalTime(48, 24)));
+        assertFalse(tl->is_equivalent_to(*other, &path));
+        assertFalse(other->is_equivalent_to(*tl));
+        assertEqual(
+            path,
+            std::string("tracks/children/0/children/1/source_range"));
+        other_clip->set_source_range(otio::TimeRange(
+            otio::RationalTime(0, 24),
+            otio::RationalTime(24, 24)));
+
+        dynamic_cast<otio::ExternalReference*>(other_clip->media_reference())
+            ->set_target_url("file:///b.mov");
+        assertFalse(tl->is_equivalent_to(*other, &path));
+        assertEqual(
+            path,
+            std::string("tracks/children/0/children/1/media_references/"
+                        "DEFAULT_MEDIA/target_url"));
+
+        other_track->remove_child(1);
+        assertFalse(tl->is_equivalent_to(*other, &path));
+        assertEqual(path, std::string("tracks/children/0/children"));
+
+        // unknown schemas are compared through serialization
+        otio::SerializableObject::Retainer<> unknown(
+            otio::SerializableObject::from_json_string(
+                R"({"OTIO_SCHEMA": "Bogus.1", "value": 1})"));
+        otio::SerializableObject::Retainer<> same_unknown(unknown->clone());
+        otio::SerializableObject::Retainer<> other_unknown(
+            otio::SerializableObject::from_json_string(
+                R"({"OTIO_SCHEMA": "Bogus.1", "value": 2})"));
+        assertTrue(unknown->is_equivalent_to(*same_unknown));
+        assertFalse(unknown->is_equivalent_to(*other_unknown));
+        assertFalse(tl->is_equivalent_to(*unknown, &path));
+        assertEqual(path, std::string());
+    });
+
+    tests.add_test("upgrade plans rename fields", [] {
+        auto& registry = otio::TypeRegistry::instance();
+        registry.register_type<UpgradedThing>();
+        assertTrue(registry.register_upgrade_rename(
+            UpgradedThing::Schema::name, 2, "old", "mid"));
+        assertFalse(registry.register_upgrade_rename(
+            UpgradedThing::Schema::name, 2, "old", "other"));
+        registry.register_upgrade_function(
+            UpgradedThing::Schema::name,
+            2,
+            [](otio::AnyDictionary* d) {
+                (*d)["mid"] = std::any_cast<int64_t>((*d)["mid"]) * 10;
+            });
+        assertTrue(registry.register_upgrade_rename(
+            UpgradedThing::Schema::name, 3, "mid", "value"));
+
+        auto read_value = [](std::string const& json) {
+            otio::ErrorStatus              err;
+            otio::SerializableObject::Retainer<> so(
+                otio::SerializableObject::from_json_string(json, &err));
+            assertFalse(otio::is_error(err));
+            auto thing = dynamic_cast<UpgradedThing*>(so.value);
+            assertTrue(thing != nullptr);
+            return thing->value;
+        };
+
+        // renames are applied while reading when the schema comes first,
+        // and once the object is read otherwise
+        assertEqual(
+            read_value(R"({"OTIO_SCHEMA": "UpgradedThing.1", "old": 4})"),
+            int64_t(40));
+        assertEqual(
+            read_value(R"({"old": 4, "OTIO_SCHEMA": "UpgradedThing.1"})"),
+            int64_t(40));
+        assertEqual(
+            read_value(R"({"OTIO_SCHEMA": "UpgradedThing.3", "value": 4})"),
+            int64_t(4));
+
+        // a core schema upgraded through a rename
+        otio::ErrorStatus              err;
+        otio::SerializableObject::Retainer<> so(
+            otio::SerializableObject::from_json_string(
+                R"({
+                    "OTIO_SCHEMA": "Marker.1",
+                    "range": {
+                        "OTIO_SCHEMA": "TimeRange.1",
+                        "start_time": {
+                            "OTIO_SCHEMA": "RationalTime.1",
+                            "rate": 24,
+                            "value": 10
+                        },
+                        "duration": {
+                            "OTIO_SCHEMA": "RationalTime.1",
+                            "rate": 24,
+                            "value": 5
+                        }
+                    }
+                })",
+                &err));
+        assertFalse(otio::is_error(err));
+        auto marker = dynamic_cast<otio::Marker*>(so.value);
+        assertTrue(marker != nullptr);
+        assertEqual(
+            marker->marked_range(),
+            otime::TimeRange(
+                otime::RationalTime(10, 24),
+                otime::RationalTime(5, 24)));
+    });
+
+    tests.add_test("content hashes follow the content", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("hashing");
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        otio::SerializableObject::Retainer<otio::Clip> clip = new otio::Clip(
+            "clip",
+            new otio::ExternalReference("file:///a.mov"),
+            otio::TimeRange(
+                otio::RationalTime(0, 24),
+                otio::RationalTime(24, 24)));
+        tr->append_child(clip);
+        tl->tracks()->append_child(tr);
+        tl->metadata()["vendor"] = otio::AnyDictionary{ { "id", int64_t(7) } };
+
+        otio::ErrorStatus err;
+        auto const        hash = tl->content_hash(&err);
+        assertFalse(otio::is_error(err));
+        assertEqual(hash.to_string().size(), size_t(32));
+        assertTrue(hash == tl->content_hash());
+
+        otio::SerializableObject::Retainer<otio::Timeline> other(
+            dynamic_cast<otio::Timeline*>(tl->clone()));
+        assertTrue(hash == other->content_hash());
+        assertTrue(clip->content_hash() != tr->content_hash());
+
+        clip->set_name("renamed");
+        assertTrue(hash != tl->content_hash());
+        clip->set_name("clip");
+        assertTrue(hash == tl->content_hash());
+
+        other->metadata()["vendor"] =
+            otio::AnyDictionary{ { "id", int64_t(8) } };
+        assertTrue(hash != other->content_hash());
+        assertFalse(tl->is_equivalent_to(*other));
+
+        // objects of unknown schemas hash like any other
+        otio::SerializableObject::Retainer<> unknown(
+            otio::SerializableObject::from_json_string(
+                R"({"OTIO_SCHEMA": "Bogus.1", "value": 1})"));
+        otio::SerializableObject::Retainer<> other_unknown(
+            otio::SerializableObject::from_json_string(
+                R"({"OTIO_SCHEMA": "Bogus.1", "value": 2})"));
+        otio::SerializableObject::Retainer<> same_unknown(unknown->clone());
+        assertTrue(unknown->content_hash() == same_unknown->content_hash());
+        assertTrue(unknown->content_hash() != other_unknown->content_hash());
+    });
+
+    tests.add_test("modifications only reach the objects holding them", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("revisions");
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        otio::SerializableObject::Retainer<otio::ExternalReference> reference =
+            new otio::ExternalReference("file:///a.mov");
+        otio::SerializableObject::Retainer<otio::Marker> marker =
+            new otio::Marker("marker");
+        otio::SerializableObject::Retainer<otio::Clip> clip = new otio::Clip(
+            "clip",
+            reference,
+            otio::TimeRange(
+                otio::RationalTime(0, 24),
+                otio::RationalTime(24, 24)),
+            otio::AnyDictionary(),
+            {},
+            { marker });
+        tr->append_child(clip);
+        tl->tracks()->append_child(tr);
+        assertFalse(tl->is_exposed());
+
+        // modifying a clone leaves the original alone
+        auto const     hash     = tl->content_hash();
+        uint64_t const revision = tl->revision();
+        otio::SerializableObject::Retainer<otio::Timeline> other(
+            dynamic_cast<otio::Timeline*>(tl->clone()));
+        assertFalse(other->is_exposed());
+        auto other_clip = other->find_clips()[0];
+        other_clip->set_source_range(std::nullopt);
+        other_clip->media_reference()->set_name("other");
+        assertEqual(tl->revision(), revision);
+        assertTrue(tl->content_hash() == hash);
+        assertTrue(other->content_hash() != hash);
+
+        // objects held in any way pass their modifications on
+        for (otio::SerializableObject* held:
+             { static_cast<otio::SerializableObject*>(reference),
+               static_cast<otio::SerializableObject*>(marker),
+               static_cast<otio::SerializableObject*>(clip) })
+        {
+            auto const before = tl->content_hash();
+            dynamic_cast<otio::SerializableObjectWithMetadata*>(held)
+                ->set_name("renamed");
+            assertTrue(tl->revision() != revision);
+            assertTrue(tl->content_hash() != before);
+        }
+
+        // removed objects don't
+        assertTrue(tr->remove_child(0));
+        uint64_t const removed = tl->revision();
+        clip->set_name("removed");
+        assertEqual(tl->revision(), removed);
+
+        // references into an object's fields expose it, and its holders
+        tr->append_child(clip);
+        auto const before = tl->content_hash();
+        clip->markers()[0]->set_name("exposed");
+        assertTrue(clip->is_exposed());
+        assertTrue(tl->is_exposed());
+        assertFalse(reference->is_exposed());
+        assertTrue(tl->content_hash() != before);
+        clip->metadata()["changed"] = true;
+        assertTrue(other->content_hash() != tl->content_hash());
+
+        // as does holding an object that is held elsewhere too
+        other_clip->set_media_reference(reference);
+        assertTrue(other->is_exposed());
+        auto const other_hash = other->content_hash();
+        reference->set_target_url("file:///b.mov");
+        assertTrue(other->content_hash() != other_hash);
+
+        // the dictionaries only count when asked for
+        assertFalse(reference->is_exposed());
+        reference->metadata()["note"] = "exposed";
+        assertTrue(reference->is_exposed());
+        assertFalse(reference->is_exposed(false));
+    });
+
+    tests.add_test("revalidated dictionaries keep their hashes", [] {
+        otio::SerializableObject::Retainer<otio::Timeline> tl =
+            new otio::Timeline("revalidated");
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        otio::SerializableObject::Retainer<otio::Clip>  clip =
+            new otio::Clip("clip");
+        tr->append_child(clip);
+        tl->tracks()->append_child(tr);
+        auto const     hash     = tl->content_hash();
+        uint64_t const revision = tl->revision();
+
+        // a dictionary handed out, but not modified, leaves the revision
+        // and the hashes as they were
+        auto& metadata = clip->metadata();
+        assertTrue(tl->is_exposed());
+        assertTrue(tl->content_hash() == hash);
+        assertTrue(tl->revalidate());
+        assertEqual(tl->revision(), revision);
+
+        // one modified through the reference gets a new revision, once
+        metadata["note"] = "modified";
+        auto const modified = tl->content_hash();
+        assertTrue(modified != hash);
+        uint64_t const modified_revision = tl->revision();
+        assertTrue(modified_revision != revision);
+        assertTrue(tl->content_hash() == modified);
+        assertEqual(tl->revision(), modified_revision);
+        metadata.erase("note");
+        assertTrue(tl->content_hash() == hash);
+
+        // the same goes for the dictionaries of the objects handed out by
+        // an item
+        clip->markers().push_back(new otio::Marker("marker"));
+        auto const marked = tl->content_hash();
+        clip->markers()[0]->metadata()["note"] = "marked";
+        assertTrue(tl->content_hash() != marked);
+        assertTrue(tl->revalidate());
+
+        // while objects put into a dictionary expose it for good
+        metadata["object"] = otio::SerializableObject::Retainer<>(
+            new otio::Marker("held"));
+        assertFalse(tl->revalidate());
+        otio::SerializableObject::Retainer<otio::Timeline> other(
+            dynamic_cast<otio::Timeline*>(tl->clone()));
+        assertTrue(tl->content_hash() == other->content_hash());
+    });
+
     tests.run(argc, argv);
     return 0;
 }
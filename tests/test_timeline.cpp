@@ -4,10 +4,17 @@
 #include "utils.h"
 
 #include <opentimelineio/clip.h>
+#include <opentimelineio/freezeFrame.h>
+#include <opentimelineio/linearTimeWarp.h>
+#include <opentimelineio/marker.h>
+#include <opentimelineio/stack.h>
 #include <opentimelineio/timeline.h>
 #include <opentimelineio/track.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <utility>
 
 namespace otime = opentime::OPENTIME_VERSION;
 namespace otio  = opentimelineio::OPENTIMELINEIO_VERSION;
@@ -77,6 +84,545 @@ main(int argc, char** argv)
         assertEqual(result.size(), 1);
         assertEqual(result[0].value, cl.value);
     });
+    tests.add_test(
+        "test_find_markers", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+
+        // clips with trimmed source ranges, and a nested stack, so the
+        // marked ranges move through several time spaces
+        SerializableObject::Retainer<Stack> nested = new Stack(
+            "nested",
+            TimeRange(RationalTime(5, 24), RationalTime(40, 24)));
+        SerializableObject::Retainer<Track> nested_track = new Track();
+        nested->append_child(nested_track);
+        std::vector<Item*> items = { tl->tracks(), tr, nested, nested_track };
+        for (int i = 0; i < 20; ++i)
+        {
+            Clip* clip = new Clip(
+                "clip",
+                nullptr,
+                TimeRange(RationalTime(100 + i, 24), RationalTime(10, 24)));
+            (i % 4 == 3 ? nested_track.value : tr.value)->append_child(clip);
+            items.push_back(clip);
+            if (i == 10)
+            {
+                tr->append_child(nested);
+            }
+        }
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            const RationalTime start =
+                items[i]->trimmed_range().start_time()
+                + RationalTime(double(i % 3), 24);
+            items[i]->markers().push_back(new Marker(
+                "marker",
+                TimeRange(start, RationalTime(double(i % 2), 24))));
+        }
+
+        OTIO_NS::ErrorStatus err;
+        const auto           all = tl->find_markers(&err);
+        assertFalse(is_error(err));
+        assertEqual(all.size(), items.size());
+        for (const auto& found: all)
+        {
+            assertEqual(
+                found.range,
+                found.item->transformed_time_range(
+                    found.marker->marked_range(),
+                    tl->tracks(),
+                    &err));
+        }
+
+        // a search finds the same markers as testing each one
+        for (int start = -5; start < 250; start += 7)
+        {
+            const TimeRange search(
+                RationalTime(start, 24),
+                RationalTime(9, 24));
+            std::vector<Marker*> expected;
+            for (const auto& found: all)
+            {
+                if (found.range.intersects(search))
+                {
+                    expected.push_back(found.marker);
+                }
+            }
+            std::vector<Marker*> markers;
+            for (const auto& found: tl->find_markers(&err, search))
+            {
+                markers.push_back(found.marker);
+            }
+            assertEqual(markers, expected);
+        }
+
+        // the index is rebuilt when a marker changes
+        Marker* marker = all.back().marker;
+        marker->set_marked_range(
+            TimeRange(RationalTime(-10000, 24), RationalTime(1, 24)));
+        const auto moved = tl->find_markers(
+            &err,
+            TimeRange(RationalTime(-20000, 24), RationalTime(15000, 24)));
+        assertEqual(moved.size(), 1);
+        assertEqual(moved[0].marker.value, marker);
+    });
+    tests.add_test(
+        "test_find_markers_after_changes_through_references", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        for (int i = 0; i < 2; ++i)
+        {
+            tr->append_child(new Clip(
+                "clip",
+                nullptr,
+                TimeRange(RationalTime(0, 24), RationalTime(10, 24)),
+                AnyDictionary(),
+                {},
+                { new Marker(
+                    "marker",
+                    TimeRange(RationalTime(i, 24), RationalTime(1, 24))) }));
+        }
+        auto clip = dynamic_cast<Clip*>(tr->children()[0].value);
+
+        OTIO_NS::ErrorStatus err;
+        assertEqual(tl->find_markers(&err).size(), 2);
+
+        // the markers a reference held on to drop out of the index, even
+        // though nothing was modified through a setter
+        auto& markers = clip->markers();
+        assertEqual(tl->find_markers(&err).size(), 2);
+        markers.clear();
+        const auto found = tl->find_markers(&err);
+        assertEqual(found.size(), 1);
+        assertEqual(found[0].item.value, tr->children()[1].value);
+
+        // and so do the markers of removed items
+        assertTrue(tr->remove_child(1));
+        assertTrue(tl->find_markers(&err).empty());
+    });
+    tests.add_test(
+        "test_find_markers_after_markers_added_through_references", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        SerializableObject::Retainer<Clip> clip = new Clip(
+            "clip",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(10, 24)));
+        tr->append_child(clip);
+
+        OTIO_NS::ErrorStatus err;
+        assertTrue(tl->find_markers(&err).empty());
+
+        // the markers added are found, and the index built for them is
+        // kept for the next query, as the revision of the revalidated
+        // tracks stays the same
+        clip->markers().push_back(new Marker(
+            "first",
+            TimeRange(RationalTime(1, 24), RationalTime(1, 24))));
+        clip->markers().push_back(new Marker(
+            "second",
+            TimeRange(RationalTime(2, 24), RationalTime(1, 24))));
+        assertEqual(tl->find_markers(&err).size(), 2);
+        const uint64_t revision = tl->tracks()->revision();
+        const auto     found    = tl->find_markers(&err);
+        assertTrue(tl->tracks()->revalidate(false));
+        assertEqual(tl->tracks()->revision(), revision);
+        assertEqual(found.size(), 2);
+        assertEqual(found[0].marker->name(), std::string("first"));
+        assertEqual(found[1].marker->name(), std::string("second"));
+        assertFalse(is_error(err));
+    });
+
+    tests.add_test("test_index_after_changes_to_one_track", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        for (int t = 0; t < 3; ++t)
+        {
+            auto track = new Track("track" + std::to_string(t));
+            tl->tracks()->append_child(track);
+            for (int c = 0; c < 3; ++c)
+            {
+                const std::string name =
+                    "clip" + std::to_string(t) + std::to_string(c);
+                track->append_child(new Clip(
+                    name,
+                    nullptr,
+                    TimeRange(RationalTime(0, 24), RationalTime(10, 24)),
+                    AnyDictionary(),
+                    {},
+                    { new Marker(
+                        name,
+                        TimeRange(
+                            RationalTime(c, 24),
+                            RationalTime(1, 24))) }));
+            }
+        }
+        auto clip_in = [&tl](int t, int c) {
+            auto track = dynamic_cast<Track*>(
+                tl->tracks()->children()[t].value);
+            return dynamic_cast<Clip*>(track->children()[c].value);
+        };
+
+        // what the index of the timeline finds, and what a clone of it,
+        // which is indexed from scratch, finds
+        using Found = std::vector<std::pair<std::string, TimeRange>>;
+        auto found = [](Timeline const* timeline) {
+            OTIO_NS::ErrorStatus err;
+            Found                result;
+            for (auto const& item: timeline->find_items(&err))
+            {
+                result.emplace_back(item.item->name(), item.range);
+            }
+            for (auto const& marker: timeline->find_markers(&err))
+            {
+                result.emplace_back(marker.marker->name(), marker.range);
+            }
+            for (auto const& item: timeline->nearest_items(
+                     RationalTime(12, 24),
+                     4,
+                     &err))
+            {
+                result.emplace_back(item.item->name(), item.range);
+            }
+            assertFalse(is_error(err));
+            return result;
+        };
+        auto assertIndexed = [&tl, &found] {
+            SerializableObject::Retainer<Timeline> clone =
+                dynamic_cast<Timeline*>(tl->clone());
+            assertEqual(found(tl), found(clone));
+        };
+        assertIndexed();
+
+        // a clip of the middle track moves the clips after it
+        clip_in(1, 0)->set_source_range(
+            TimeRange(RationalTime(0, 24), RationalTime(5, 24)));
+        assertIndexed();
+        OTIO_NS::ErrorStatus err;
+        assertEqual(
+            tl->media_time_transform(clip_in(1, 1), &err)
+                .applied_to(RationalTime(5, 24)),
+            RationalTime(0, 24));
+
+        // the dictionaries of a track don't change the index, and the rest
+        // of it is still kept up to date
+        clip_in(0, 2)->metadata()["note"] = "looked at";
+        clip_in(2, 1)->markers().front()->set_marked_range(
+            TimeRange(RationalTime(7, 24), RationalTime(1, 24)));
+        assertIndexed();
+        clip_in(2, 1)->markers().front()->set_marked_range(
+            TimeRange(RationalTime(8, 24), RationalTime(1, 24)));
+        assertIndexed();
+
+        // a marker of the tracks, a new track, and the window of the tracks
+        tl->tracks()->markers().push_back(new Marker(
+            "tracks",
+            TimeRange(RationalTime(3, 24), RationalTime(1, 24))));
+        tl->tracks()->append_child(new Track("track3"));
+        assertIndexed();
+        tl->tracks()->set_source_range(
+            TimeRange(RationalTime(2, 24), RationalTime(20, 24)));
+        assertIndexed();
+        assertTrue(tl->tracks()->remove_child(0));
+        assertIndexed();
+    });
+
+    tests.add_test("test_index_after_non_const_accessors", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        SerializableObject::Retainer<Clip> clip = new Clip(
+            "clip",
+            nullptr,
+            TimeRange(RationalTime(0, 24), RationalTime(10, 24)));
+        tr->append_child(clip);
+
+        // the index is built again exactly when the revision of the
+        // revalidated tracks changes
+        OTIO_NS::ErrorStatus err;
+        uint64_t             revision = 0;
+        int                  rebuilds = 0;
+        auto                 find     = [&] {
+            const size_t found = tl->find_items(&err).size();
+            assertTrue(tl->tracks()->revalidate(false));
+            if (tl->tracks()->revision() != revision)
+            {
+                revision = tl->tracks()->revision();
+                ++rebuilds;
+            }
+            return found;
+        };
+        assertEqual(find(), size_t(2));
+        assertEqual(rebuilds, 1);
+
+        // references that are handed out, but not used to modify anything,
+        // leave the index as it is
+        auto& effects = clip->effects();
+        assertTrue(tl->tracks()->is_exposed(false));
+        assertEqual(find(), size_t(2));
+        assertEqual(find(), size_t(2));
+        assertEqual(rebuilds, 1);
+
+        // while a modification through one is picked up once
+        effects.push_back(new LinearTimeWarp("fast", "LinearTimeWarp", 2));
+        assertEqual(find(), size_t(2));
+        assertEqual(find(), size_t(2));
+        assertEqual(rebuilds, 2);
+        assertEqual(
+            tl->media_time_transform(clip, &err).applied_to(
+                RationalTime(3, 24)),
+            RationalTime(6, 24));
+
+        // and so are modifications of the objects in it
+        dynamic_cast<LinearTimeWarp*>(effects[0].value)->set_time_scalar(3);
+        assertEqual(find(), size_t(2));
+        assertEqual(find(), size_t(2));
+        assertEqual(rebuilds, 3);
+        assertEqual(
+            tl->media_time_transform(clip, &err).applied_to(
+                RationalTime(3, 24)),
+            RationalTime(9, 24));
+        assertFalse(is_error(err));
+    });
+    tests.add_test(
+        "test_find_items", [] {
+        using namespace otio;
+        auto frames = [](double start, double duration) {
+            return TimeRange(
+                RationalTime(start, 24),
+                RationalTime(duration, 24));
+        };
+        auto distance = [](TimeRange range, RationalTime time) {
+            if (range.contains(time))
+            {
+                return 0.0;
+            }
+            return std::min(
+                std::abs(range.start_time().to_seconds() - time.to_seconds()),
+                std::abs(
+                    time.to_seconds()
+                    - range.end_time_exclusive().to_seconds()));
+        };
+
+        // a track of five clips, with a stack after the first two that
+        // shows frames 5 to 15 of its own track
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        std::vector<Clip*> clips;
+        for (int i = 0; i < 5; ++i)
+        {
+            clips.push_back(new Clip("clip", nullptr, frames(100, 10)));
+            tr->append_child(clips.back());
+        }
+        SerializableObject::Retainer<Stack> nested =
+            new Stack("nested", frames(5, 10));
+        SerializableObject::Retainer<Track> nested_track = new Track();
+        nested->append_child(nested_track);
+        tr->insert_child(2, nested);
+        SerializableObject::Retainer<Clip> a =
+            new Clip("a", nullptr, frames(0, 8));
+        SerializableObject::Retainer<Clip> b =
+            new Clip("b", nullptr, frames(0, 8));
+        SerializableObject::Retainer<Clip> hidden =
+            new Clip("hidden", nullptr, frames(0, 4));
+        nested_track->append_child(a);
+        nested_track->append_child(b);
+        nested_track->append_child(hidden);
+
+        OTIO_NS::ErrorStatus err;
+        const auto           all = tl->find_items(&err);
+        assertFalse(is_error(err));
+        assertEqual(all.size(), size_t(10));
+        auto range_of = [&all](Item* item) {
+            for (const auto& found: all)
+            {
+                if (found.item.value == item)
+                {
+                    return found.range;
+                }
+            }
+            return TimeRange();
+        };
+        assertEqual(range_of(tr), frames(0, 60));
+        assertEqual(range_of(clips[3]), frames(40, 10));
+        assertEqual(range_of(nested), frames(20, 10));
+        assertEqual(range_of(nested_track), frames(20, 10));
+        assertEqual(range_of(a), frames(20, 3));
+        assertEqual(range_of(b), frames(23, 7));
+        assertEqual(range_of(hidden), TimeRange());
+
+        // the searches find the same items as testing each one
+        for (double time = -3; time < 65; time += 0.5)
+        {
+            const RationalTime t(time, 24);
+            std::vector<Item*>  expected;
+            std::vector<double> distances;
+            for (const auto& found: all)
+            {
+                if (found.range.contains(t))
+                {
+                    expected.push_back(found.item);
+                }
+                distances.push_back(distance(found.range, t));
+            }
+            std::vector<Item*> items;
+            for (const auto& found: tl->items_at_time(t, &err))
+            {
+                items.push_back(found.item);
+            }
+            assertEqual(items, expected);
+
+            std::sort(distances.begin(), distances.end());
+            const auto nearest = tl->nearest_items(t, 4, &err);
+            assertEqual(nearest.size(), size_t(4));
+            for (size_t i = 0; i < nearest.size(); ++i)
+            {
+                assertEqual(distance(nearest[i].range, t), distances[i]);
+            }
+        }
+
+        const auto found = tl->find_items(&err, frames(24, 2));
+        std::vector<Item*> items;
+        for (const auto& f: found)
+        {
+            items.push_back(f.item);
+        }
+        assertEqual(items, std::vector<Item*>{ tr, nested, nested_track, b });
+    });
+    tests.add_test(
+        "test_media_time_transform", [] {
+        using namespace otio;
+        auto frames = [](double start, double duration) {
+            return TimeRange(
+                RationalTime(start, 24),
+                RationalTime(duration, 24));
+        };
+
+        // a clip, a clip at double speed, a freeze frame, and a stack at
+        // half speed that shows frames 5 to 15 of its own track
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        SerializableObject::Retainer<Clip> plain =
+            new Clip("plain", nullptr, frames(100, 10));
+        SerializableObject::Retainer<Clip> fast = new Clip(
+            "fast",
+            nullptr,
+            frames(50, 10),
+            AnyDictionary(),
+            { new LinearTimeWarp("fast", "LinearTimeWarp", 2) });
+        SerializableObject::Retainer<Clip> frozen = new Clip(
+            "frozen",
+            nullptr,
+            frames(30, 10),
+            AnyDictionary(),
+            { new FreezeFrame() });
+        SerializableObject::Retainer<Stack> nested = new Stack(
+            "nested",
+            frames(5, 10),
+            AnyDictionary(),
+            { new LinearTimeWarp("slow", "LinearTimeWarp", 0.5) });
+        SerializableObject::Retainer<Track> nested_track = new Track();
+        SerializableObject::Retainer<Clip>  a = new Clip(
+            "a",
+            nullptr,
+            TimeRange(RationalTime(0, 48), RationalTime(40, 48)));
+        nested_track->append_child(a);
+        nested->append_child(nested_track);
+        tr->append_child(plain);
+        tr->append_child(fast);
+        tr->append_child(frozen);
+        tr->append_child(nested);
+
+        OTIO_NS::ErrorStatus err;
+        auto media_time = [&](Item const* item, double time) {
+            return tl->media_time_transform(item, &err).applied_to(
+                RationalTime(time, 24));
+        };
+
+        // without time effects, the same as transformed_time()
+        for (double time = 0; time < 10; time += 0.5)
+        {
+            const RationalTime t(time, 24);
+            assertEqual(
+                media_time(plain, time),
+                tl->tracks()->transformed_time(t, plain));
+            assertEqual(
+                media_time(tr, time),
+                tl->tracks()->transformed_time(t, tr));
+        }
+        assertFalse(is_error(err));
+
+        assertEqual(media_time(fast, 13), RationalTime(56, 24));
+        assertEqual(media_time(frozen, 25), RationalTime(30, 24));
+        assertEqual(media_time(nested, 34), RationalTime(7, 24));
+        assertEqual(media_time(nested_track, 34), RationalTime(7, 24));
+        assertEqual(media_time(a, 34), RationalTime(14, 48));
+        assertEqual(media_time(tl->tracks(), 34), RationalTime(34, 24));
+        assertFalse(is_error(err));
+
+        // a time effect that isn't linear can't be composed
+        a->effects().push_back(new TimeEffect());
+        tl->media_time_transform(a, &err);
+        assertEqual(err.outcome, OTIO_NS::ErrorStatus::NOT_IMPLEMENTED);
+
+        err = OTIO_NS::ErrorStatus();
+        SerializableObject::Retainer<Clip> outside = new Clip();
+        tl->media_time_transform(outside, &err);
+        assertEqual(err.outcome, OTIO_NS::ErrorStatus::NOT_DESCENDED_FROM);
+    });
+
+    tests.add_test("test_media_time_transform_after_changes", [] {
+        using namespace otio;
+        SerializableObject::Retainer<Timeline> tl = new Timeline();
+        SerializableObject::Retainer<Track>    tr = new Track();
+        tl->tracks()->append_child(tr);
+        auto warp = new LinearTimeWarp("fast", "LinearTimeWarp", 2);
+        SerializableObject::Retainer<Clip> fast = new Clip(
+            "fast",
+            nullptr,
+            TimeRange(RationalTime(50, 24), RationalTime(10, 24)),
+            AnyDictionary(),
+            { warp });
+        tr->append_child(fast);
+
+        OTIO_NS::ErrorStatus err;
+        auto media_time = [&](double time) {
+            return tl->media_time_transform(fast, &err).applied_to(
+                RationalTime(time, 24));
+        };
+        assertEqual(media_time(3), RationalTime(56, 24));
+
+        // reading the timeline, or the dictionaries of its items, leaves
+        // the index as it is
+        const uint64_t revision = tl->tracks()->revision();
+        assertEqual(std::as_const(*fast).effects().size(), size_t(1));
+        assertEqual(fast->name(), std::string("fast"));
+        fast->metadata()["seen"] = true;
+        assertEqual(tl->find_items(&err).size(), size_t(2));
+        assertEqual(media_time(3), RationalTime(56, 24));
+        assertEqual(tl->tracks()->revision(), revision);
+        assertFalse(tl->tracks()->is_exposed(false));
+
+        // while changes to the time warps, through a setter or through the
+        // effects themselves, are picked up
+        warp->set_time_scalar(3);
+        assertEqual(media_time(3), RationalTime(59, 24));
+        fast->effects().push_back(
+            new LinearTimeWarp("slow", "LinearTimeWarp", 0.5));
+        assertEqual(media_time(3), RationalTime(54.5, 24));
+        fast->effects().clear();
+        assertEqual(media_time(3), RationalTime(53, 24));
+        assertFalse(is_error(err));
+    });
 
     tests.run(argc, argv);
     return 0;
@@ -4,8 +4,11 @@
 #include "utils.h"
 
 #include <opentimelineio/clip.h>
+#include <opentimelineio/externalReference.h>
+#include <opentimelineio/gap.h>
 #include <opentimelineio/stack.h>
 #include <opentimelineio/track.h>
+#include <opentimelineio/transition.h>
 
 #include <iostream>
 
@@ -166,6 +169,128 @@ main(int argc, char** argv)
             std::find(items.begin(), items.end(), clip.value) != items.end());
     });
 
+    tests.add_test(
+        "test_mixed_rate_ranges_are_exact", [] {
+        const double ntsc = 30000.0 / 1001.0;
+        otio::SerializableObject::Retainer<otio::Track> tr =
+            new otio::Track();
+        for (int i = 0; i < 1000; ++i)
+        {
+            const double rate = i % 2 ? 24.0 : ntsc;
+            tr->append_child(new otio::Clip(
+                "clip",
+                nullptr,
+                otio::TimeRange(
+                    otio::RationalTime(0, rate),
+                    otio::RationalTime(1, rate))));
+        }
+
+        // 500 frames at 30000/1001 and 499 frames at 24
+        const otime::ExactTime start(
+            500 * otime::ExactTime::ticks_per_sample(ntsc)
+            + 499 * otime::ExactTime::ticks_per_sample(24));
+        const otime::ExactTime duration =
+            start + otime::ExactTime(otime::ExactTime::ticks_per_sample(24));
+
+        otio::ErrorStatus err;
+        auto range = tr->range_of_child_at_index(999, &err);
+        assertFalse(otio::is_error(err));
+        assertTrue(range.start_time().strictly_equal(
+            start.to_rational_time(ntsc)));
+
+        auto ranges = tr->range_of_all_children(&err);
+        assertFalse(otio::is_error(err));
+        assertTrue(ranges[tr->children()[999]].start_time().strictly_equal(
+            start.to_rational_time(ntsc)));
+
+        range = tr->available_range(&err);
+        assertFalse(otio::is_error(err));
+        assertTrue(range.duration().strictly_equal(
+            duration.to_rational_time(ntsc)));
+    });
+
+    tests.add_test(
+        "test_cut_list", [] {
+        auto frames = [](double start, double duration) {
+            return otio::TimeRange(
+                otio::RationalTime(start, 24),
+                otio::RationalTime(duration, 24));
+        };
+
+        // A, a dissolve, B, a gap, C (disabled), D, a dissolve, a stack
+        otio::SerializableObject::Retainer<otio::Track> tr = new otio::Track();
+        auto a = new otio::Clip(
+            "A",
+            new otio::ExternalReference("file:///a.mov"),
+            frames(100, 24));
+        auto dissolve_ab = new otio::Transition(
+            "ab",
+            otio::Transition::Type::SMPTE_Dissolve,
+            otio::RationalTime(4, 24),
+            otio::RationalTime(6, 24));
+        auto b = new otio::Clip("B", nullptr, frames(0, 48));
+        auto c = new otio::Clip("C", nullptr, frames(0, 12));
+        c->set_enabled(false);
+        auto d = new otio::Clip("D", nullptr, frames(10, 24));
+        auto dissolve_de = new otio::Transition(
+            "de",
+            otio::Transition::Type::SMPTE_Dissolve,
+            otio::RationalTime(2, 24),
+            otio::RationalTime(2, 24));
+        auto e = new otio::Stack("E", frames(0, 12));
+        tr->append_child(a);
+        tr->append_child(dissolve_ab);
+        tr->append_child(b);
+        tr->append_child(new otio::Gap(frames(0, 12)));
+        tr->append_child(c);
+        tr->append_child(d);
+        tr->append_child(dissolve_de);
+        tr->append_child(e);
+
+        otio::ErrorStatus err;
+        const auto        events = tr->cut_list(&err);
+        assertFalse(otio::is_error(err));
+        assertEqual(events.size(), size_t(4));
+
+        // the same times as range_in_parent() and visible_range()
+        const std::vector<otio::Item*> items{ a, b, d, e };
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const auto& event = events[i];
+            assertEqual(event.item, static_cast<otio::Item const*>(items[i]));
+            assertEqual(
+                tr->children()[event.index].value,
+                static_cast<otio::Composable*>(items[i]));
+
+            const otio::TimeRange range   = items[i]->range_in_parent(&err);
+            const otio::TimeRange visible = items[i]->visible_range(&err);
+            const otio::RationalTime head =
+                items[i]->trimmed_range().start_time() - visible.start_time();
+            assertEqual(event.record_in, range.start_time() - head);
+            assertEqual(
+                event.record_out,
+                event.record_in + visible.duration());
+            assertEqual(event.source_in, visible.start_time());
+            assertEqual(event.source_out, visible.end_time_exclusive());
+        }
+
+        assertEqual(events[0].media_reference, a->media_reference());
+        assertEqual(events[0].record_in, otio::RationalTime(0, 24));
+        assertEqual(events[0].record_out, otio::RationalTime(30, 24));
+        assertEqual(events[0].source_out, otio::RationalTime(130, 24));
+        assertEqual(
+            events[0].transition_out,
+            static_cast<otio::Transition const*>(dissolve_ab));
+        assertEqual(
+            events[1].transition_in,
+            static_cast<otio::Transition const*>(dissolve_ab));
+        assertEqual(events[1].record_in, otio::RationalTime(20, 24));
+        assertTrue(events[1].transition_out == nullptr);
+        assertEqual(events[2].record_in, otio::RationalTime(96, 24));
+        assertEqual(events[3].record_in, otio::RationalTime(118, 24));
+        assertEqual(events[3].record_out, otio::RationalTime(132, 24));
+    });
+
     tests.run(argc, argv);
     return 0;
 }